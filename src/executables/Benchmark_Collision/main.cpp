@@ -0,0 +1,191 @@
+#include <GeKo_Graphics/Scenegraph/Scenegraph.h>
+#include <GeKo_Physics/CollisionTest.h>
+#include <GeKo_Physics/Gravity.h>
+#include <GeKo_Gameplay/Observer/Observer.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+
+/*
+Headless stress test for the collision and gravity update.
+
+No window and no GL context is created, every node only has a bounding sphere (Node::setBoundingSphere(radius, center)),
+so the benchmark can run on machines without a GPU.
+
+Usage: Benchmark_Collision [nodes] [ticks] [density] [aiShare] [staticShare]
+	nodes		number of AI, PLAYER and STATIC nodes (default 500)
+	ticks		number of simulated frames (default 100)
+	density		nodes per 100 square units of ground (default 4.0)
+	aiShare		part of the nodes which are AI (default 0.8), one node is always the player
+	staticShare	part of the nodes which are STATIC (default 0.2)
+*/
+
+//Counts every heap allocation of the process
+static std::atomic<size_t> s_allocations(0);
+
+void* operator new(size_t size)
+{
+	s_allocations++;
+	void* p = malloc(size);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+void* operator new[](size_t size)
+{
+	s_allocations++;
+	void* p = malloc(size);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+void operator delete[](void* p) noexcept
+{
+	free(p);
+}
+
+///Counts all collision events the CollisionTest sends
+class CountingObserver : public Observer<Node, Collision_Event>
+{
+public:
+	CountingObserver() : m_events(0){}
+
+	void onNotify(Node& node, Collision_Event event){ m_events++; }
+	void onNotify(Node& nodeA, Node& nodeB, Collision_Event event){ m_events++; }
+
+	size_t m_events;
+};
+
+static float randomRange(float min, float max)
+{
+	return min + (max - min) * (rand() / (float)RAND_MAX);
+}
+
+int main(int argc, char* argv[])
+{
+	int numberOfNodes = argc > 1 ? atoi(argv[1]) : 500;
+	int ticks = argc > 2 ? atoi(argv[2]) : 100;
+	float density = argc > 3 ? (float)atof(argv[3]) : 4.0f;
+	float aiShare = argc > 4 ? (float)atof(argv[4]) : 0.8f;
+	float staticShare = argc > 5 ? (float)atof(argv[5]) : 0.2f;
+
+	if (numberOfNodes < 2 || ticks < 1 || density <= 0.0f)
+	{
+		printf("Usage: Benchmark_Collision [nodes >= 2] [ticks >= 1] [density > 0] [aiShare] [staticShare]\n");
+		return 1;
+	}
+
+	//fixed seed, so every run tests the same scene
+	srand(42);
+
+	//the ground is a square, its size follows from the density
+	float groundSize = sqrt(numberOfNodes / density * 100.0f);
+
+	Scenegraph scenegraph("Benchmark");
+	Node* root = scenegraph.getRootNode();
+	Gravity gravity;
+
+	int numberOfAI = (int)(numberOfNodes * aiShare);
+	int numberOfStatic = (int)(numberOfNodes * staticShare);
+	if (numberOfAI + numberOfStatic >= numberOfNodes)
+		numberOfAI = numberOfNodes - numberOfStatic - 1;
+
+	std::vector<Node*> movingNodes;
+
+	for (int i = 0; i < numberOfNodes; i++)
+	{
+		std::stringstream name;
+		name << "Node" << i;
+		Node* node = new Node(name.str());
+		node->setBoundingSphere(randomRange(0.3f, 1.0f), glm::vec3(0.0));
+
+		glm::vec3 position(randomRange(0.0f, groundSize), 0.0f, randomRange(0.0f, groundSize));
+
+		if (i == 0)
+		{
+			node->setObject(new Player("Player", position));
+			node->addGravity(&gravity);
+			movingNodes.push_back(node);
+		}
+		else if (i <= numberOfAI)
+		{
+			node->setObject(new AI(glm::vec4(position, 1.0)));
+			node->addGravity(&gravity);
+			movingNodes.push_back(node);
+		}
+		else
+		{
+			StaticObject* staticObject = new StaticObject();
+			staticObject->setPosition(position);
+			node->setObject(staticObject);
+		}
+
+		root->addChildrenNode(node);
+	}
+
+	CollisionTest collision;
+	collision.collectNodes(root);
+	CountingObserver observer;
+	collision.addObserver(&observer);
+
+	printf("=============================================\n");
+	printf("Collision benchmark: %d nodes (%d AI, 1 player, %d static), %d ticks\n", numberOfNodes, numberOfAI, numberOfNodes - numberOfAI - 1, ticks);
+	printf("Ground: %.1f x %.1f units, density %.2f nodes per 100 units^2\n", groundSize, groundSize, density);
+	printf("=============================================\n");
+
+	long long testedPairs = 0;
+	long long collidingPairs = 0;
+	double collisionNs = 0.0;
+	double gravityNs = 0.0;
+	size_t allocationsBefore = s_allocations;
+
+	for (int tick = 0; tick < ticks; tick++)
+	{
+		//gravity and a small random walk, the ground is at y = 0
+		auto gravityStart = std::chrono::high_resolution_clock::now();
+		for (auto node : movingNodes)
+		{
+			node->applyGravity();
+
+			Object* object = node->getType() == ClassType::PLAYER ? (Object*)node->getPlayer() : (Object*)node->getAI();
+			glm::vec4 position = object->getPosition();
+			position.x += randomRange(-0.1f, 0.1f);
+			position.z += randomRange(-0.1f, 0.1f);
+			position.y = glm::max(position.y, 0.0f);
+			object->setPosition(position);
+			node->addTranslation(glm::vec3(position));
+		}
+		auto collisionStart = std::chrono::high_resolution_clock::now();
+
+		collision.update();
+
+		auto collisionEnd = std::chrono::high_resolution_clock::now();
+
+		gravityNs += std::chrono::duration<double, std::nano>(collisionStart - gravityStart).count();
+		collisionNs += std::chrono::duration<double, std::nano>(collisionEnd - collisionStart).count();
+		testedPairs += collision.getTestedPairs();
+		collidingPairs += collision.getCollidingPairs();
+	}
+
+	size_t allocations = s_allocations - allocationsBefore;
+
+	printf("Pairs tested:       %lld (%.0f per tick)\n", testedPairs, testedPairs / (double)ticks);
+	printf("Pairs colliding:    %lld (%.2f%%)\n", collidingPairs, testedPairs > 0 ? 100.0 * collidingPairs / testedPairs : 0.0);
+	printf("Events emitted:     %zu (%.1f per tick)\n", observer.m_events, observer.m_events / (double)ticks);
+	printf("Collision time:     %.3f ms per tick, %.2f ns per pair\n", collisionNs / ticks / 1.0e6, testedPairs > 0 ? collisionNs / testedPairs : 0.0);
+	printf("Gravity time:       %.3f ms per tick\n", gravityNs / ticks / 1.0e6);
+	printf("Allocations:        %zu (%.1f per tick)\n", allocations, allocations / (double)ticks);
+	printf("=============================================\n");
+
+	return 0;
+}
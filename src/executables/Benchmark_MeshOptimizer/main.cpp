@@ -0,0 +1,167 @@
+#include <GeKo_Graphics/Geometry/MeshOptimizer.h>
+#include <GeKo_Graphics/Geometry/Sphere.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+/*
+Headless benchmark of the MeshOptimizer.
+
+No window and no GL context is created. Every mesh is optimized step by step, the vertex cache statistics are simulated
+for a FIFO cache (see MeshOptimizer::computeStatistics), the overdraw can only be measured on a GPU.
+-Grid: a wavy grid, the triangles row by row like Terrain builds them
+-Sphere: the index list of Sphere
+-Soup: the grid with three own vertices per triangle and the triangles in random order, like a mesh without an index-List
+
+Usage: Benchmark_MeshOptimizer [resolution] [cache size]
+	resolution	quads per side of the grid & the sphere (default 256)
+	cache size	vertices in the simulated cache (default 16)
+*/
+
+struct TestMesh
+{
+	const char* name;
+	std::vector<Vertex> vertices;
+	std::vector<Normal> normals;
+	std::vector<Uv> uvs;
+	std::vector<Index> indices;
+};
+
+static TestMesh createGrid(int resolution)
+{
+	TestMesh mesh;
+	mesh.name = "Grid";
+	for (int z = 0; z <= resolution; z++)
+	{
+		for (int x = 0; x <= resolution; x++)
+		{
+			float height = sinf(x * 0.3f) + cosf(z * 0.2f);
+			mesh.vertices.push_back(glm::vec4(x, height, z, 1.0));
+			mesh.normals.push_back(glm::vec3(0.0, 1.0, 0.0));
+			mesh.uvs.push_back(glm::vec2(x / (float)resolution, z / (float)resolution));
+		}
+	}
+	for (int z = 0; z < resolution; z++)
+	{
+		for (int x = 0; x < resolution; x++)
+		{
+			Index i = z * (resolution + 1) + x;
+			Index quad[6] = { i, i + 1, i + resolution + 1, i + resolution + 1, i + 1, i + resolution + 2 };
+			mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+		}
+	}
+	return mesh;
+}
+
+static TestMesh createSphere(int resolution)
+{
+	Sphere sphere(1.0f, resolution);
+	TestMesh mesh;
+	mesh.name = "Sphere";
+	mesh.vertices = sphere.getVertices();
+	mesh.normals = sphere.getNormals();
+	mesh.uvs = sphere.getUV();
+	mesh.indices = sphere.getIndexList();
+	return mesh;
+}
+
+static TestMesh createSoup(int resolution)
+{
+	TestMesh grid = createGrid(resolution);
+	TestMesh mesh;
+	mesh.name = "Soup";
+
+	size_t triangleCount = grid.indices.size() / 3;
+	std::vector<size_t> order(triangleCount);
+	for (size_t t = 0; t < triangleCount; t++)
+		order[t] = t;
+	//fixed seed, so every run shuffles the same way
+	srand(42);
+	for (size_t t = triangleCount - 1; t > 0; t--)
+		std::swap(order[t], order[rand() % (t + 1)]);
+
+	for (auto t : order)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			Index v = grid.indices[t * 3 + c];
+			mesh.indices.push_back((Index)mesh.vertices.size());
+			mesh.vertices.push_back(grid.vertices[v]);
+			mesh.normals.push_back(grid.normals[v]);
+			mesh.uvs.push_back(grid.uvs[v]);
+		}
+	}
+	return mesh;
+}
+
+static void printStep(const char* step, MeshOptimizer& optimizer, const TestMesh& mesh, double ms)
+{
+	VertexCacheStatistics statistics = optimizer.getStatistics();
+	printf("  %-14s %10d %10.3f %10.3f %10.2f\n", step, (int)mesh.vertices.size(), statistics.acmr, statistics.atvr, ms);
+}
+
+static void benchmark(TestMesh& mesh, int cacheSize)
+{
+	MeshOptimizer optimizer(mesh.vertices, mesh.indices);
+	optimizer.setNormals(&mesh.normals);
+	optimizer.setUVs(&mesh.uvs);
+	optimizer.setCacheSize(cacheSize);
+
+	printf("%s: %d triangles\n", mesh.name, (int)mesh.indices.size() / 3);
+	printStep("input", optimizer, mesh, 0.0);
+
+	double total = 0.0;
+	for (int step = 0; step < 4; step++)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		switch (step)
+		{
+		case 0:
+			optimizer.weld();
+			break;
+		case 1:
+			optimizer.optimizeVertexCache();
+			break;
+		case 2:
+			optimizer.optimizeOverdraw();
+			break;
+		case 3:
+			optimizer.optimizeVertexFetch();
+			break;
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+
+		double ms = std::chrono::duration<double, std::milli>(end - start).count();
+		total += ms;
+		const char* names[] = { "weld", "vertex cache", "overdraw", "vertex fetch" };
+		printStep(names[step], optimizer, mesh, ms);
+	}
+	printf("  %-14s %43.2f\n", "total", total);
+}
+
+int main(int argc, char* argv[])
+{
+	int resolution = argc > 1 ? atoi(argv[1]) : 256;
+	int cacheSize = argc > 2 ? atoi(argv[2]) : 16;
+
+	if (resolution < 2 || cacheSize < 3)
+	{
+		printf("Usage: Benchmark_MeshOptimizer [resolution >= 2] [cache size >= 3]\n");
+		return 1;
+	}
+
+	printf("=============================================================\n");
+	printf("MeshOptimizer benchmark: resolution %d, FIFO cache of %d vertices\n", resolution, cacheSize);
+	printf("  %-14s %10s %10s %10s %10s\n", "Step", "vertices", "ACMR", "ATVR", "ms");
+	printf("=============================================================\n");
+
+	TestMesh meshes[3] = { createGrid(resolution), createSphere(resolution), createSoup(resolution) };
+	for (auto& mesh : meshes)
+		benchmark(mesh, cacheSize);
+
+	printf("=============================================================\n");
+	printf("(ACMR: transformed vertices per triangle, ATVR: transformed per used vertex, 1 at best)\n");
+	return 0;
+}
@@ -0,0 +1,173 @@
+#include <GeKo_Graphics/ParticleSystem/Emitter.h>
+#include <GeKo_Graphics/ParticleSystem/ParticleRandom.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+/*
+Headless benchmark of the CPU particle simulation.
+
+No window and no GL context is created. The emitters use the CPU simulation and a simulated clock (Emitter::setClock),
+every physic mode is measured with the scalar code, with SSE and with SSE & threads.
+Before that, ParticleRandom is checked against the known-answer vectors of Random123 (Philox4x32-10) and uniform4 against uniform.
+
+Usage: Benchmark_Particles [particles] [frames] [threads]
+	particles	particles per emitter (default 100000)
+	frames		number of measured frames (default 200)
+	threads		threads for the last run (default: all cores)
+*/
+
+static double s_time = 0.0;
+
+static double benchmarkClock()
+{
+	return s_time;
+}
+
+//the known-answer vectors of Philox4x32-10 from Random123 (kat_vectors)
+static bool checkRandom()
+{
+	struct KnownAnswer
+	{
+		ParticleRandom::Counter counter;
+		uint32_t key0, key1;
+		ParticleRandom::Counter result;
+	};
+	const KnownAnswer answers[3] = {
+		{ { 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u }, 0x00000000u, 0x00000000u, { 0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u } },
+		{ { 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu }, 0xffffffffu, 0xffffffffu, { 0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu } },
+		{ { 0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u }, 0xa4093822u, 0x299f31d0u, { 0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u } }
+	};
+
+	bool success = true;
+	for (auto& answer : answers)
+	{
+		ParticleRandom::Counter result = ParticleRandom::philox(answer.counter, answer.key0, answer.key1);
+		if (result.x != answer.result.x || result.y != answer.result.y || result.z != answer.result.z || result.w != answer.result.w)
+		{
+			printf("ERROR: Philox4x32-10 of %08x %08x %08x %08x is %08x %08x %08x %08x\n", answer.counter.x, answer.counter.y,
+				answer.counter.z, answer.counter.w, result.x, result.y, result.z, result.w);
+			success = false;
+		}
+	}
+
+	//the 4 lanes have to give the numbers of the scalar code
+	const uint32_t index[4] = { 0u, 1u, 1000u, 0xfffffffeu };
+	float lanes[4][4];
+	ParticleRandom::uniform4(1234u, index, 17u, 1u, lanes);
+	for (int lane = 0; lane < 4; lane++)
+	{
+		glm::vec4 scalar = ParticleRandom::uniform(1234u, index[lane], 17u, 1u);
+		if (lanes[0][lane] != scalar.x || lanes[1][lane] != scalar.y || lanes[2][lane] != scalar.z || lanes[3][lane] != scalar.w)
+		{
+			printf("ERROR: uniform4 lane %d differs from uniform\n", lane);
+			success = false;
+		}
+	}
+
+	if (success)
+		printf("SUCCESS: ParticleRandom matches the Random123 known-answer vectors\n");
+	return success;
+}
+
+static Emitter* createEmitter(int physic, int numberOfParticles)
+{
+	const double emitFrequency = 0.01;
+	const double particleLifetime = 2.0;
+	int particlesPerEmit = (int)(numberOfParticles * emitFrequency / particleLifetime);
+
+	Emitter* emitter = new Emitter(0, glm::vec3(0.0, 0.0, 0.0), 0.0, emitFrequency, particlesPerEmit, particleLifetime, true);
+	emitter->setVelocity(6);
+	switch (physic)
+	{
+	case 0:
+		emitter->usePhysicTrajectory(glm::vec4(0.0, -1.0, 0.0, 0.8), 2.0);
+		break;
+	case 1:
+		emitter->usePhysicDirectionGravity(glm::vec4(0.0, -1.0, 0.0, 0.8), 2.0);
+		break;
+	case 2:
+		emitter->usePhysicPointGravity(glm::vec3(0.0, 2.0, 0.0), 0.8, 5.0, 2, 2.0, false);
+		break;
+	case 3:
+		emitter->usePhysicSwarmCircleMotion(true, true, true, 2.0);
+		break;
+	}
+	return emitter;
+}
+
+static double measure(int physic, int numberOfParticles, int frames, bool useSIMD, int threadCount)
+{
+	const double frameTime = 1.0 / 60.0;
+
+	Emitter* emitter = createEmitter(physic, numberOfParticles);
+	emitter->useCPUSimulation(true, threadCount);
+	emitter->getCPUSimulation()->setUseSIMD(useSIMD);
+	emitter->start();
+
+	//fill the emitter, until the first particles die
+	for (int i = 0; i < 150; i++)
+	{
+		s_time += frameTime;
+		emitter->update(nullptr);
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < frames; i++)
+	{
+		s_time += frameTime;
+		emitter->update(nullptr);
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+
+	double ns = std::chrono::duration<double, std::nano>(end - start).count();
+	int particles = emitter->getCPUSimulation()->getNumberOfParticles();
+	delete emitter;
+
+	return ns / ((double)frames * particles);
+}
+
+int main(int argc, char* argv[])
+{
+	int numberOfParticles = argc > 1 ? atoi(argv[1]) : 100000;
+	int frames = argc > 2 ? atoi(argv[2]) : 200;
+	int threadCount = argc > 3 ? atoi(argv[3]) : (int)std::thread::hardware_concurrency();
+	if (threadCount < 1)
+		threadCount = 1;
+
+	if (numberOfParticles < 100 || frames < 1)
+	{
+		printf("Usage: Benchmark_Particles [particles >= 100] [frames >= 1] [threads]\n");
+		return 1;
+	}
+
+	if (!checkRandom())
+		return 1;
+
+	//fixed seed and simulated time, so every run simulates the same particles
+	srand(42);
+	Emitter::setClock(&benchmarkClock);
+
+	const char* names[] = { "Trajectory", "DirectionGravity", "PointGravity", "SwarmCircleMotion" };
+
+	printf("=============================================\n");
+	printf("Particle benchmark: %d particles, %d frames, SSE %s\n", numberOfParticles, frames,
+		ParticleSimulationCPU::isSIMDAvailable() ? "available" : "not available");
+	printf("ns per particle and frame:\n");
+	printf("%-20s %10s %10s %10s\n", "Physic", "scalar", "SSE", "threads");
+	printf("=============================================\n");
+
+	for (int physic = 0; physic < 4; physic++)
+	{
+		double scalar = measure(physic, numberOfParticles, frames, false, 1);
+		double simd = measure(physic, numberOfParticles, frames, true, 1);
+		double threads = measure(physic, numberOfParticles, frames, true, threadCount);
+		printf("%-20s %10.3f %10.3f %10.3f\n", names[physic], scalar, simd, threads);
+	}
+
+	printf("=============================================\n");
+	printf("(%d threads, SwarmCircleMotion always uses the scalar code)\n", threadCount);
+
+	return 0;
+}
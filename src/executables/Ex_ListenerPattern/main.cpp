@@ -130,22 +130,6 @@ int main()
 
 	FBO fboGBuffer(WINDOW_WIDTH, WINDOW_HEIGHT, 3, true, false);
 
-	ParticleSystem* particle = new ParticleSystem(glm::vec3(0, 0, 0), (char*)RESOURCES_PATH "/XML/ComicCloudEffect.xml");
-	particle->m_type = ParticleType::FIGHT;
-	ParticleSystem* particle2 = new ParticleSystem(glm::vec3(0, 0, 0), (char*)RESOURCES_PATH "/XML/SwarmOfFliesEffect.xml");
-	particle2->m_type = ParticleType::SWARMOFFLIES;
-	ParticleSystem* particleFire = new ParticleSystem(glm::vec3(0, 0, 0), (char*)RESOURCES_PATH "/XML/Fire.xml");
-	particleFire->m_type = ParticleType::FIRE;
-
-	Node particleNode("ParticleNode");
-	particleNode.addParticleSystem(particle2);
-	particleNode.setCamera(&cam);
-	particleNode.setParticleActive(true);
-
-	Node particleNodeFire("ParticleNodeFire");
-	particleNodeFire.addParticleSystem(particleFire);
-	particleNodeFire.setCamera(&cam);
-	particleNodeFire.setParticleActive(true);
 
 	//===================================================================//
 	//==================A Graph for the AI-Unit=========================//
@@ -273,7 +257,12 @@ int main()
 	Scene testScene("testScene");
 	testLevel.addScene(&testScene);
 	testLevel.changeScene("testScene");
-	testLevel.getFightSystem()->setParticle(particle);
+
+	//the observers spawn the gameplay effects from the pool of the scene
+	ParticleSystemPool* particlePool = testScene.getScenegraph()->getParticlePool();
+	particlePool->registerType(ParticleType::FIGHT, RESOURCES_PATH "/XML/ComicCloudEffect.xml", 2, 8);
+	particlePool->registerType(ParticleType::SWARMOFFLIES, RESOURCES_PATH "/XML/SwarmOfFliesEffect.xml", 2, 16);
+	particlePool->registerType(ParticleType::FIRE, RESOURCES_PATH "/XML/Fire.xml", 1, 1);
 
 	//==================Add Camera to Scene============================//
 	testScene.getScenegraph()->addCamera(&cam);
@@ -294,12 +283,6 @@ int main()
 
 	testScene.getScenegraph()->getRootNode()->addChildrenNode(&treeNode);
 
-	testScene.getScenegraph()->getRootNode()->addChildrenNode(&particleNode);
-	testScene.getScenegraph()->getRootNode()->addChildrenNode(&particleNodeFire);
-	testScene.getScenegraph()->addParticleSystem(particle);
-	testScene.getScenegraph()->addParticleSystem(particle2);
-	testScene.getScenegraph()->addParticleSystem(particleFire);
-
 	// ==============================================================
 	// == Questsystem ====================================================
 	// ==============================================================
@@ -590,6 +573,7 @@ int main()
 		shaderGBuffer.sendMat4("projectionMatrix", cam.getProjectionMatrix());
 		
 		testScene.render(shaderGBuffer);
+		testScene.renderParticleSystems();
 
 
 		ant_Flick.update();
@@ -621,6 +605,9 @@ int main()
 
 
 
+	//the pool deletes its GL objects while the context exists
+	particlePool->clear();
+
 	glfwDestroyWindow(testWindow.getWindow());
 	glfwTerminate();
 
@@ -120,6 +120,8 @@ int main()
 	OpenGL3Context context;
 	//renderer = new Renderer(context);
 	Renderer renderer(context);
+	//the G-buffer pass is recorded on a worker thread, the player's gravity & camera are updated before it starts
+	renderer.useParallelRecording(true);
 
 	ResourceManager manager;
 
@@ -148,27 +150,6 @@ int main()
 	Rect screenFillingQuad;
 	screenFillingQuad.loadBufferData();
 
-	//===================================================================//
-	//================== PArticle System ================================ //
-	//===================================================================//
-
-	ParticleSystem* particle = new ParticleSystem(glm::vec3(0, 0, 0), (char*)RESOURCES_PATH "/XML/Effect_ComicCloud.xml");
-	particle->m_type = ParticleType::FIGHT;
-	ParticleSystem* particle2 = new ParticleSystem(glm::vec3(0, 0, 0), (char*)RESOURCES_PATH "/XML/SwarmOfFliesEffect.xml");
-	particle2->m_type = ParticleType::SWARMOFFLIES;
-	ParticleSystem* particleFire = new ParticleSystem(glm::vec3(0, 0, 0), (char*)RESOURCES_PATH "/XML/Effect_Fire.xml");
-	particleFire->m_type = ParticleType::FIRE;
-
-	Node particleNode("ParticleNode");
-	particleNode.addParticleSystem(particle2);
-	particleNode.setCamera(&cam);
-	particleNode.setParticleActive(true);
-
-	Node particleNodeFire("ParticleNodeFire");
-	particleNodeFire.addParticleSystem(particleFire);
-	particleNodeFire.setCamera(&cam);
-	particleNodeFire.setParticleActive(true);
-
 	//===================================================================//
 	//==================Object declarations - Geometry, Texture, Node=== //
 	//==========================Object: Terrain===========================//
@@ -282,9 +263,11 @@ int main()
 	testScene.setSkyboxNode(&skyboxNode);
 
 	//================== Particles ========================//
-	testScene.getScenegraph()->addParticleSystem(particle);
-	testScene.getScenegraph()->addParticleSystem(particle2);
-	testScene.getScenegraph()->addParticleSystem(particleFire);
+	//the observers spawn the gameplay effects from the pool of the scene
+	ParticleSystemPool* particlePool = testScene.getScenegraph()->getParticlePool();
+	particlePool->registerType(ParticleType::FIGHT, RESOURCES_PATH "/XML/Effect_ComicCloud.xml", 2, 8);
+	particlePool->registerType(ParticleType::SWARMOFFLIES, RESOURCES_PATH "/XML/SwarmOfFliesEffect.xml", 2, 16);
+	particlePool->registerType(ParticleType::FIRE, RESOURCES_PATH "/XML/Effect_Fire.xml", 1, 1);
 
 	//===================================================================//
 	//==================Setting up the Observers========================//
@@ -588,6 +571,9 @@ int main()
 
 
 
+	//the pool deletes its GL objects while the context exists
+	particlePool->clear();
+
 	glfwDestroyWindow(testWindow.getWindow());
 	glfwTerminate();
 
@@ -0,0 +1,77 @@
+#include <cstdio>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <GeKo_Graphics/Material/TextureManager.h>
+#include <GeKo_Graphics/ParticleSystem/Emitter.h>
+
+/*
+Checks the reference counting of the TextureManager, needs a GL context (a hidden window).
+-getTexture with two spellings of one path returns one texture with 2 references
+-the first release keeps the GL name, the last one deletes it
+-an Emitter holds a reference for addTexture(path) and gives it back in its destructor
+The image doesn't have to exist, a failed load keeps its GL name too.
+Returns 0 if all checks passed.
+*/
+
+static int s_failed = 0;
+
+static void check(bool condition, const char* description)
+{
+	printf("%s: %s\n", condition ? "SUCCESS" : "ERROR", description);
+	if (!condition)
+		s_failed++;
+}
+
+int main()
+{
+	if (!glfwInit())
+	{
+		printf("ERROR: glfwInit failed\n");
+		return 1;
+	}
+	glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+	GLFWwindow* window = glfwCreateWindow(64, 64, "TextureManager_Test", NULL, NULL);
+	if (!window)
+	{
+		printf("ERROR: no GL context\n");
+		glfwTerminate();
+		return 1;
+	}
+	glfwMakeContextCurrent(window);
+	glewExperimental = GL_TRUE;
+	glewInit();
+
+	TextureManager* manager = TextureManager::getInstance();
+	std::string path = RESOURCES_PATH "/Texture/bricks.bmp";
+
+	Texture* first = manager->getTexture(path);
+	Texture* second = manager->getTexture(RESOURCES_PATH "/Texture/./bricks.bmp");
+	GLuint name = first->getTexture();
+	check(first == second, "both spellings share one texture");
+	check(manager->getReferenceCount(first) == 2, "2 references after 2 getTexture");
+	check(glIsTexture(name) == GL_TRUE, "the texture has a GL name");
+
+	manager->release(second);
+	check(manager->getReferenceCount(first) == 1, "1 reference after the first release");
+	check(glIsTexture(name) == GL_TRUE, "the GL name lives while a reference is left");
+
+	manager->release(first);
+	check(manager->getTextureCount() == 0, "the last release removes the texture");
+	check(glIsTexture(name) == GL_FALSE, "the last release deletes the GL name");
+
+	Emitter* emitter = new Emitter(0, glm::vec3(0.0), 0.0, 0.5, 1, 1.0, true);
+	emitter->addTexture(path, 1.0);
+	Texture* texture = emitter->m_textureList.at(0);
+	name = texture->getTexture();
+	check(manager->getReferenceCount(texture) == 1, "the emitter holds a reference");
+	delete emitter;
+	check(manager->getTextureCount() == 0, "the emitter releases its texture");
+	check(glIsTexture(name) == GL_FALSE, "the GL name of the emitter texture is deleted");
+
+	manager->clear();
+	glfwDestroyWindow(window);
+	glfwTerminate();
+
+	printf("%d checks failed\n", s_failed);
+	return s_failed == 0 ? 0 : 1;
+}
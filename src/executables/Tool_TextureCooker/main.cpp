@@ -0,0 +1,217 @@
+#include <GeKo_Graphics/Material/CookedTexture.h>
+#include <stb_image.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/*
+Offline cooker of the texture images, see CookedTexture.
+
+No window and no GL context is created. Every image is decoded like Texture::load does it (flipped), mipmapped,
+compressed and written next to the image ("wall.png" -> "wall.gktex"). Texture::load & TextureLoader use the cooked file
+until the image is changed.
+
+Usage: Tool_TextureCooker [--format auto|rgba|bc1|bc3|bc5] [--verify] [--min-psnr dB] images...
+	--format	auto (default): BC1 for images without alpha, BC3 for images with alpha.
+				bc5 keeps only red & green, use it for normal maps of shaders that reconstruct z
+	--verify	cooks nothing, compares every level of the cooked files with the mipmaps of a reference decode of the image
+	--min-psnr	a level below this PSNR fails the verification (default 30 dB). Only levels of at least 16x16 pixels are checked,
+				a block of a smaller level holds most of the image & its colors rarely lie on the line of the two BC1 end points
+Returns 0 if all images were cooked (or verified), 1 otherwise.
+*/
+
+static const int MIN_CHECKED_SIZE = 16;
+
+struct LevelError
+{
+	double psnr;
+	int maxError;
+};
+
+static bool parseFormat(const char* name, CookedTextureFormat& format, bool& automatic)
+{
+	automatic = false;
+	if (strcmp(name, "auto") == 0) automatic = true;
+	else if (strcmp(name, "rgba") == 0) format = COOKED_RGBA8;
+	else if (strcmp(name, "bc1") == 0) format = COOKED_BC1;
+	else if (strcmp(name, "bc3") == 0) format = COOKED_BC3;
+	else if (strcmp(name, "bc5") == 0) format = COOKED_BC5;
+	else return false;
+	return true;
+}
+
+static bool hasAlpha(const unsigned char* rgba, int width, int height)
+{
+	for (size_t i = 0; i < (size_t)width * height; i++)
+	{
+		if (rgba[i * 4 + 3] != 255)
+			return true;
+	}
+	return false;
+}
+
+//only the channels stored by the format are compared
+static LevelError compareLevel(const std::vector<unsigned char>& reference, const std::vector<unsigned char>& decoded, CookedTextureFormat format)
+{
+	int channels = 4;
+	if (format == COOKED_BC1)
+		channels = 3;
+	else if (format == COOKED_BC5)
+		channels = 2;
+
+	double squaredError = 0.0;
+	int maxError = 0;
+	size_t pixels = reference.size() / 4;
+	for (size_t i = 0; i < pixels; i++)
+	{
+		for (int c = 0; c < channels; c++)
+		{
+			int error = std::abs(reference[i * 4 + c] - decoded[i * 4 + c]);
+			squaredError += error * error;
+			maxError = std::max(maxError, error);
+		}
+	}
+
+	LevelError result;
+	double meanError = squaredError / (double)(pixels * channels);
+	result.psnr = (meanError > 0.0) ? 10.0 * log10(255.0 * 255.0 / meanError) : 99.0;
+	result.maxError = maxError;
+	return result;
+}
+
+static bool cook(const char* imagePath, CookedTextureFormat format, bool automatic)
+{
+	int width, height, channels;
+	unsigned char* rgba = stbi_load(imagePath, &width, &height, &channels, 4);
+	if (!rgba)
+	{
+		printf("ERROR: Unable to load texture image %s\n", imagePath);
+		return false;
+	}
+
+	if (automatic)
+		format = hasAlpha(rgba, width, height) ? COOKED_BC3 : COOKED_BC1;
+
+	std::string cookedPath = CookedTexture::getCookedPath(imagePath);
+	bool success = CookedTexture::write(cookedPath.c_str(), imagePath, rgba, width, height, format);
+	stbi_image_free(rgba);
+
+	if (!success)
+	{
+		printf("ERROR: Unable to write cooked texture %s\n", cookedPath.c_str());
+		return false;
+	}
+
+	CookedTexture cooked;
+	cooked.open(cookedPath.c_str(), NULL);
+	size_t size = 0;
+	for (int level = 0; level < cooked.getLevelCount(); level++)
+		size += cooked.getLevelDataSize(level);
+	printf("SUCCESS: %s -> %s (%dx%d, %d levels, %s, %.1f KB)\n", imagePath, cookedPath.c_str(), width, height,
+		cooked.getLevelCount(), CookedTexture::getFormatName(format), size / 1024.0);
+	return true;
+}
+
+static bool verify(const char* imagePath, double minPSNR)
+{
+	std::string cookedPath = CookedTexture::getCookedPath(imagePath);
+	CookedTexture cooked;
+	if (!cooked.open(cookedPath.c_str(), imagePath))
+	{
+		printf("ERROR: %s is missing, invalid or older than %s\n", cookedPath.c_str(), imagePath);
+		return false;
+	}
+
+	int width, height, channels;
+	unsigned char* rgba = stbi_load(imagePath, &width, &height, &channels, 4);
+	if (!rgba)
+	{
+		printf("ERROR: Unable to load texture image %s\n", imagePath);
+		return false;
+	}
+	if (width != cooked.getWidth() || height != cooked.getHeight())
+	{
+		printf("ERROR: %s is %dx%d, the image is %dx%d\n", cookedPath.c_str(), cooked.getWidth(), cooked.getHeight(), width, height);
+		stbi_image_free(rgba);
+		return false;
+	}
+
+	std::vector<std::vector<unsigned char> > reference;
+	CookedTexture::buildMipChain(rgba, width, height, reference);
+	stbi_image_free(rgba);
+
+	bool success = true;
+	LevelError worst = { 99.0, 0 };
+	std::vector<unsigned char> decoded;
+	for (int level = 0; level < cooked.getLevelCount(); level++)
+	{
+		CookedTexture::decodeLevel(cooked.getLevelData(level), cooked.getLevelWidth(level), cooked.getLevelHeight(level), cooked.getFormat(), decoded);
+		LevelError error = compareLevel(reference[level], decoded, cooked.getFormat());
+		bool checked = cooked.getLevelWidth(level) >= MIN_CHECKED_SIZE && cooked.getLevelHeight(level) >= MIN_CHECKED_SIZE;
+		if (!checked)
+			continue;
+		if (error.psnr < minPSNR)
+		{
+			printf("ERROR: %s level %d (%dx%d): PSNR %.2f dB, max error %d\n", cookedPath.c_str(), level,
+				cooked.getLevelWidth(level), cooked.getLevelHeight(level), error.psnr, error.maxError);
+			success = false;
+		}
+		worst.psnr = std::min(worst.psnr, error.psnr);
+		worst.maxError = std::max(worst.maxError, error.maxError);
+	}
+
+	if (success)
+		printf("SUCCESS: %s (%s): lowest PSNR of the checked levels %.2f dB, max error %d\n", cookedPath.c_str(),
+			CookedTexture::getFormatName(cooked.getFormat()), worst.psnr, worst.maxError);
+	return success;
+}
+
+int main(int argc, char* argv[])
+{
+	CookedTextureFormat format = COOKED_BC1;
+	bool automatic = true;
+	bool verifyOnly = false;
+	double minPSNR = 30.0;
+	std::vector<const char*> images;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--format") == 0 && i + 1 < argc)
+		{
+			if (!parseFormat(argv[++i], format, automatic))
+			{
+				printf("ERROR: Unknown format %s\n", argv[i]);
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "--verify") == 0)
+			verifyOnly = true;
+		else if (strcmp(argv[i], "--min-psnr") == 0 && i + 1 < argc)
+			minPSNR = atof(argv[++i]);
+		else
+			images.push_back(argv[i]);
+	}
+
+	if (images.empty())
+	{
+		printf("Usage: Tool_TextureCooker [--format auto|rgba|bc1|bc3|bc5] [--verify] [--min-psnr dB] images...\n");
+		return 1;
+	}
+
+	//the rows bottom up, like Texture::load
+	stbi_set_flip_vertically_on_load(1);
+
+	int failed = 0;
+	for (auto image : images)
+	{
+		bool success = verifyOnly ? verify(image, minPSNR) : cook(image, format, automatic);
+		if (!success)
+			failed++;
+	}
+
+	printf("%d of %d images %s\n", (int)images.size() - failed, (int)images.size(), verifyOnly ? "verified" : "cooked");
+	return failed > 0 ? 1 : 0;
+}
@@ -17,7 +17,6 @@ public:
 
 	void onNotify(Node& node, Collision_Event event)
 	 {
-		 std::vector<ParticleSystem*>* ps = m_level->getActiveScene()->getScenegraph()->getParticleSet();
 		 switch (event)
 		 {
 		 case Collision_Event::COLLISION_DETECTED:
@@ -32,23 +31,15 @@ public:
 		 case Collision_Event::NO_COLLISION_KI_PLAYER:
 			 node.getBoundingSphere()->setCollisionDetected(false);
 			 node.getAI()->viewArea(false);
-			 for (auto particle : *ps)
-			 {
-				 if (particle->m_type == ParticleType::FIGHT)
-				 {
-					 particle->stop();
-				 }
-			 }
+			 stopFight(&node);
 			 break;
 		 }
 	 }
 
 	void onNotify(Node& nodeA, Node& nodeB, Collision_Event event)
 	 {
-		 if (((int)glfwGetTime() % 3) < 1 && particleFightIsStarted) particleFightIsStarted = false;
-
 		int tp;
-		std::vector<ParticleSystem*>* ps = m_level->getActiveScene()->getScenegraph()->getParticleSet();
+		ParticleSystemPool* pool = m_level->getActiveScene()->getScenegraph()->getParticlePool();
 		 switch (event)
 		 {
 		 case Collision_Event::COLLISION_DETECTED:
@@ -74,16 +65,14 @@ public:
 				 }
 				 
 
+				 stopFight(&nodeA);
 				 m_level->getActiveScene()->getScenegraph()->getRootNode()->deleteChildrenNode(nodeA.getNodeName());
 
-				 //std::vector<ParticleSystem*>* ps = m_level->getActiveScene()->getScenegraph()->getParticleSet();
-				 for (auto particle : *ps)
+				 //the swarm of the dead AI, see ObjectObserver
+				 if (pool->isPlaying(ParticleType::SWARMOFFLIES, nodeA.getAI()))
 				 {
-					 if (particle->m_type == ParticleType::SWARMOFFLIES)
-					 {
-						 particle->stop();
-						 nodeA.getAI()->getSoundHandler()->stopSource("Flies");
-					 }
+					 pool->release(ParticleType::SWARMOFFLIES, nodeA.getAI());
+					 nodeA.getAI()->getSoundHandler()->stopSource("Flies");
 				 }
 
 				 std::vector<Goal*> tmp = m_level->getQuestHandler()->getQuests(GoalType::EATEN);
@@ -101,24 +90,8 @@ public:
 			 {
 				 if (nodeA.getAI()->getHealth() > 0)
 				 {
-					 //std::vector<ParticleSystem*>* ps = m_level->getActiveScene()->getScenegraph()->getParticleSet();
-					 for (auto particle : *ps)
-					 {
-						 if (particle->m_type == ParticleType::FIGHT && !particleFightIsStarted)
-						 {
-							 particle->stop();
-							 particle->start();
-							 particleFightIsStarted = true;
-							 //particle->update(*nodeB.getCamera());
-							 //particle->render(*nodeB.getCamera());
-						 }
-						 if (particle->m_type == ParticleType::FIGHT)
-						 {
-							 particle->setPosition(glm::vec3(nodeB.getPlayer()->getPosition()));
-							 particle->update(*nodeB.getCamera());
-							 particle->render(*nodeB.getCamera());
-						 }
-					 }
+					 //one fight effect per AI, so several fights can play at the same time
+					 pool->spawn(ParticleType::FIGHT, glm::vec3(nodeB.getPlayer()->getPosition()), &nodeA);
 
 					 if (m_counter->getTime() <= 0)
 					 {
@@ -144,14 +117,7 @@ public:
 		 case Collision_Event::NO_COLLISION_KI_PLAYER:
 			 nodeA.getBoundingSphere()->setCollisionDetected(false);
 			 nodeA.getAI()->viewArea(false);
-
-			 for (auto particle : *ps)
-			 {
-				 if (particle->m_type == ParticleType::FIGHT)
-				 {
-					 particle->stop();
-				 }
-			 }
+			 stopFight(&nodeA);
 			 break;
 
 		 case Collision_Event::AI_STATIC_COLLISION:
@@ -214,11 +180,15 @@ public:
 	 }
 
 	protected:
+		///Puts the fight effect of the AI back to the pool
+		void stopFight(Node* ai)
+		{
+			m_level->getActiveScene()->getScenegraph()->getParticlePool()->release(ParticleType::FIGHT, ai);
+		}
+
 		Level* m_level;
 		
 		Counter* m_counter;
 
 		std::vector<Texture*> m_textures;
-
-		bool particleFightIsStarted = false;
 };
\ No newline at end of file
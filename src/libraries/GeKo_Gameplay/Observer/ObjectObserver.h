@@ -38,18 +38,8 @@ public:
 			break;
 
 		case Object_Event::OBJECT_DIED:
-			std::vector<ParticleSystem*>* ps = m_level->getActiveScene()->getScenegraph()->getParticleSet();
-			for (auto particle : *ps)
-			{
-				if (particle->m_type == ParticleType::SWARMOFFLIES)
-				{
-					particle->setPosition(glm::vec3(ai.getPosition()));
-					particle->start();
-					particle->update(*m_level->getActiveScene()->getScenegraph()->getActiveCamera());
-					particle->render(*m_level->getActiveScene()->getScenegraph()->getActiveCamera());
-				}
-			}
-
+			//plays until the player eats the AI, see CollisionObserver
+			m_level->getActiveScene()->getScenegraph()->getParticlePool()->spawn(ParticleType::SWARMOFFLIES, glm::vec3(ai.getPosition()), &ai);
 			break;
 		}
 	}
@@ -58,7 +48,6 @@ public:
 	{
 		std::string name = player.getNodeName();
 		Node* tmp = m_level->getActiveScene()->getScenegraph()->searchNode(name);
-		std::vector<ParticleSystem*>* ps = m_level->getActiveScene()->getScenegraph()->getParticleSet();
 		switch (event)
 		{
 		case Object_Event::OBJECT_MOVED:
@@ -83,18 +72,8 @@ public:
 			break;
 
 		case Object_Event::PLAYER_SET_ON_FIRE:
-			
-			for (auto particle : *ps)
-			{
-				if (particle->m_type == ParticleType::FIRE)
-				{
-					particle->setPosition(glm::vec3(player.getPosition() + (player.getViewDirection() *2.0f)));
-
-					particle->start();
-					particle->update(*m_level->getActiveScene()->getScenegraph()->getActiveCamera());
-					particle->render(*m_level->getActiveScene()->getScenegraph()->getActiveCamera());
-				}
-			}
+			//one fire per player, a new event moves it
+			m_level->getActiveScene()->getScenegraph()->getParticlePool()->spawn(ParticleType::FIRE, glm::vec3(player.getPosition() + (player.getViewDirection() *2.0f)), &player);
 			break;
 		case Object_Event::PLAYER_DIED:
 
@@ -17,7 +17,7 @@ struct BufferIndex{
     size = v.size();
     glGenBuffers(1, &handle);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, handle);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, size * sizeof(unsigned int), &v.at(0), bufferDraw);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, size * sizeof(T), &v.at(0), bufferDraw);
     unbind();
   }
 
@@ -0,0 +1,44 @@
+#include "Frustum.h"
+
+Frustum::Frustum(){
+	for (int i = 0; i < 6; i++){
+		m_planes[i] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+}
+
+Frustum::Frustum(Camera &cam){
+	update(cam.getProjectionMatrix() * cam.getViewMatrix());
+}
+
+void Frustum::update(glm::mat4 viewProjection){
+	// The rows of the matrix, glm is column major
+	glm::vec4 row[4];
+	for (int i = 0; i < 4; i++){
+		row[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+	}
+
+	m_planes[0] = row[3] + row[0];
+	m_planes[1] = row[3] - row[0];
+	m_planes[2] = row[3] + row[1];
+	m_planes[3] = row[3] - row[1];
+	m_planes[4] = row[3] + row[2];
+	m_planes[5] = row[3] - row[2];
+
+	for (int i = 0; i < 6; i++){
+		float length = glm::length(glm::vec3(m_planes[i]));
+		if (length > 0.0f)
+			m_planes[i] /= length;
+	}
+}
+
+const glm::vec4* Frustum::getPlanes(){
+	return m_planes;
+}
+
+bool Frustum::containsSphere(glm::vec3 center, float radius){
+	for (int i = 0; i < 6; i++){
+		if (glm::dot(glm::vec3(m_planes[i]), center) + m_planes[i].w < -radius)
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <glm/glm.hpp>
+#include "Camera.h"
+
+/** Frustum holds the six planes of the view frustum of a camera, for visibility tests in world space*/
+
+class Frustum{
+
+public:
+	Frustum();
+	/// Builds the planes from the view and projection matrix of the camera
+	Frustum(Camera &cam);
+
+	/// This method extracts the planes of projection * view
+	void update(glm::mat4 viewProjection);
+
+	/// This method returns true if the sphere is at least partly inside
+	bool containsSphere(glm::vec3 center, float radius);
+
+	/// Returns the six planes, e.g. to cull on the GPU
+	const glm::vec4* getPlanes();
+
+private:
+	// left, right, bottom, top, near, far. xyz is the normal to the inside, w the distance
+	glm::vec4 m_planes[6];
+};
@@ -1,4 +1,5 @@
 #include "PlayerGUI.h"
+#include <GeKo_Graphics/Material/TextureManager.h>
 
 PlayerGUI::PlayerGUI(const int hudWidth, const int hudHeight, const int windowWidth, const int windowHeight, const int questHeight, const int questWidth, Player* player, QuestHandler* qH)
 {
@@ -117,7 +118,10 @@ PlayerGUI::PlayerGUI(const int hudWidth, const int hudHeight, const int windowWi
 
 PlayerGUI::~PlayerGUI()
 {
-
+	//the references of setTexture
+	for (auto texture : m_textures)
+		TextureManager::getInstance()->release(texture);
+	m_textures.clear();
 }
 
 GUI* PlayerGUI::getHUD()
@@ -180,7 +184,8 @@ std::map<std::string, Texture*>* PlayerGUI::getInventory(){
 }
 
 void PlayerGUI::setTexture(char* fileName){
-	Texture* tex = new Texture(fileName);
+	//called during gameplay, the image is streamed in without a hitch and shared with the other users of the file
+	Texture* tex = TextureManager::getInstance()->getTextureAsync(fileName);
 	m_textures.push_back(tex);
 }
 
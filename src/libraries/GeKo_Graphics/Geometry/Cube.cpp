@@ -70,6 +70,9 @@ Cube::Cube()
 	{
 		m_index.push_back(i);
 	}
+
+	//the faces share no vertices, only the corners of the two triangles of a face are merged
+	optimize();
 }
 
 Cube::~Cube()
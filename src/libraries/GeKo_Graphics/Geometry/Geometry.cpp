@@ -1,4 +1,6 @@
 #include "Geometry.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
 
 
 Geometry::Geometry()
@@ -7,9 +9,20 @@ Geometry::Geometry()
 	m_hasNormals = false;
 	m_hasIndex = false;
 	m_hasUV = false;
+	m_hasBounds = false;
+	m_vertexLayout = VertexLayout::getSeparate();
+	m_packedBuffer = 0;
+	m_shortIndexBuffer = nullptr;
+	m_indexType = GL_UNSIGNED_INT;
 }
 Geometry::Geometry(const StaticMesh &mesh){
   m_wasLoaded = false;
+  m_hasBounds = false;
+  //the imported meshes are the largest ones
+  m_vertexLayout = VertexLayout::getCompact();
+  m_packedBuffer = 0;
+  m_shortIndexBuffer = nullptr;
+  m_indexType = GL_UNSIGNED_INT;
   m_hasNormals = true;
   m_hasIndex = true;
   m_hasUV = true;
@@ -18,6 +31,10 @@ Geometry::Geometry(const StaticMesh &mesh){
   m_index = mesh.indicies;
   m_uvs = mesh.uvs;
   m_normals = mesh.normals;
+  if(mesh.hasBounds){
+    m_bounds = mesh.bounds;
+    m_hasBounds = true;
+  }
 }
 
 Geometry::~Geometry()
@@ -26,6 +43,17 @@ Geometry::~Geometry()
 
 void Geometry::loadBufferData()
 {
+	if (!m_hasBounds)
+	{
+		computeBounds();
+	}
+
+	if (!m_vertexLayout.isSeparate())
+	{
+		loadPackedBufferData();
+		return;
+	}
+
 	m_vertexBuffer = new Buffer<glm::vec4>(m_vertices, STATIC_DRAW);
 	if (m_hasNormals){
 		m_normalBuffer = new Buffer<glm::vec3>(m_normals, STATIC_DRAW);
@@ -64,21 +92,100 @@ void Geometry::loadBufferData()
 	glBindVertexArray(0);
 }
 
+void Geometry::loadPackedBufferData()
+{
+	PackedVertices packed;
+	m_vertexLayout.pack(m_vertices, m_hasNormals ? &m_normals : nullptr, m_hasUV ? &m_uvs : nullptr, &m_tangents, packed);
+
+	glGenBuffers(1, &m_packedBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_packedBuffer);
+	glBufferData(GL_ARRAY_BUFFER, packed.data.size(), packed.data.data(), GL_STATIC_DRAW);
+
+	if (m_hasIndex)
+	{
+		if (m_vertexLayout.useShortIndices(m_vertices.size()))
+		{
+			std::vector<GLushort> shortIndices(m_index.begin(), m_index.end());
+			m_shortIndexBuffer = new BufferIndex<GLushort>(shortIndices, STATIC_DRAW_INDEX);
+			m_indexType = GL_UNSIGNED_SHORT;
+		}
+		else
+		{
+			m_indexBuffer = new BufferIndex<GLuint>(m_index, STATIC_DRAW_INDEX);
+		}
+	}
+
+	glGenVertexArrays(1, &m_vaoBuffer);
+	glBindVertexArray(m_vaoBuffer);
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_packedBuffer);
+	for (auto& attribute : packed.attributes)
+	{
+		glVertexAttribPointer(attribute.location, attribute.size, attribute.type, attribute.normalized, attribute.stride, (const GLvoid*)attribute.offset);
+		glEnableVertexAttribArray(attribute.location);
+	}
+
+	if (m_shortIndexBuffer){
+		m_shortIndexBuffer->bind();
+	}
+	else if (m_hasIndex){
+		m_indexBuffer->bind();
+	}
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
 void Geometry::renderGeometry()
 {
 	glBindVertexArray(m_vaoBuffer);
+	drawGeometry();
+	glBindVertexArray(0);
+
+}
 
+void Geometry::drawGeometry()
+{
 	if (m_hasIndex)
 	{
-		glDrawElements(GL_TRIANGLES, m_index.size(), GL_UNSIGNED_INT, 0);
+		glDrawElements(GL_TRIANGLES, m_index.size(), m_indexType, 0);
 	}
 	else
 	{
 		glDrawArrays(GL_TRIANGLES, 0, m_vertices.size());
 	}
+}
 
-	glBindVertexArray(0);
+void Geometry::drawGeometryInstanced(int count)
+{
+	if (m_hasIndex)
+	{
+		glDrawElementsInstanced(GL_TRIANGLES, m_index.size(), m_indexType, 0, count);
+	}
+	else
+	{
+		glDrawArraysInstanced(GL_TRIANGLES, 0, m_vertices.size(), count);
+	}
+}
 
+GLuint Geometry::getVAO()
+{
+	return m_vaoBuffer;
+}
+
+GLenum Geometry::getIndexType()
+{
+	return m_indexType;
+}
+
+void Geometry::setVertexLayout(const VertexLayout& layout)
+{
+	m_vertexLayout = layout;
+}
+
+const VertexLayout& Geometry::getVertexLayout()
+{
+	return m_vertexLayout;
 }
 
 void Geometry::computeTangents()
@@ -111,7 +218,7 @@ void Geometry::computeTangents()
 	}
 }
 
-std::vector<glm::vec4> Geometry::getVertices()
+const std::vector<glm::vec4>& Geometry::getVertices()
 {
 	return m_vertices;
 }
@@ -136,6 +243,133 @@ std::vector<GLuint> Geometry::getIndexList()
 	return m_index;
 }
 
+const GeometryBounds& Geometry::getBounds()
+{
+	if (!m_hasBounds)
+	{
+		computeBounds();
+	}
+	return m_bounds;
+}
+
+void Geometry::computeBounds()
+{
+	m_hasBounds = true;
+
+	if (m_vertices.empty())
+	{
+		m_bounds.boxMin = glm::vec3(0.0);
+		m_bounds.boxMax = glm::vec3(0.0);
+		m_bounds.sphereCenter = glm::vec3(0.0);
+		m_bounds.sphereRadius = 0.0f;
+		return;
+	}
+
+	//Box and the indices of the extreme vertices along every axis
+	glm::vec3 boxMin = glm::vec3(m_vertices[0]);
+	glm::vec3 boxMax = boxMin;
+	size_t minIndex[3] = { 0, 0, 0 };
+	size_t maxIndex[3] = { 0, 0, 0 };
+
+	for (size_t i = 1; i < m_vertices.size(); i++)
+	{
+		glm::vec3 p = glm::vec3(m_vertices[i]);
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (p[axis] < boxMin[axis])
+			{
+				boxMin[axis] = p[axis];
+				minIndex[axis] = i;
+			}
+			if (p[axis] > boxMax[axis])
+			{
+				boxMax[axis] = p[axis];
+				maxIndex[axis] = i;
+			}
+		}
+	}
+
+	//Ritter: the initial sphere spans the pair of extreme vertices which are farthest apart
+	int initialAxis = 0;
+	float maxDistance2 = -1.0f;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		glm::vec3 d = glm::vec3(m_vertices[maxIndex[axis]] - m_vertices[minIndex[axis]]);
+		float distance2 = glm::dot(d, d);
+		if (distance2 > maxDistance2)
+		{
+			maxDistance2 = distance2;
+			initialAxis = axis;
+		}
+	}
+
+	glm::vec3 center = (glm::vec3(m_vertices[minIndex[initialAxis]]) + glm::vec3(m_vertices[maxIndex[initialAxis]])) * 0.5f;
+	float radius = sqrt(maxDistance2) * 0.5f;
+
+	//Every vertex outside of the sphere grows it just enough to contain the vertex
+	for (size_t i = 0; i < m_vertices.size(); i++)
+	{
+		glm::vec3 d = glm::vec3(m_vertices[i]) - center;
+		float distance2 = glm::dot(d, d);
+		if (distance2 > radius * radius)
+		{
+			float distance = sqrt(distance2);
+			float newRadius = (radius + distance) * 0.5f;
+			center += d * ((newRadius - radius) / distance);
+			radius = newRadius;
+		}
+	}
+
+	//For box-like geometry the sphere around the box center can be tighter
+	glm::vec3 boxCenter = (boxMin + boxMax) * 0.5f;
+	float boxRadius2 = 0.0f;
+	for (size_t i = 0; i < m_vertices.size(); i++)
+	{
+		glm::vec3 d = glm::vec3(m_vertices[i]) - boxCenter;
+		boxRadius2 = glm::max(boxRadius2, glm::dot(d, d));
+	}
+	if (sqrt(boxRadius2) < radius)
+	{
+		center = boxCenter;
+		radius = sqrt(boxRadius2);
+	}
+
+	m_bounds.boxMin = boxMin;
+	m_bounds.boxMax = boxMax;
+	m_bounds.sphereCenter = center;
+	m_bounds.sphereRadius = radius;
+}
+
+void Geometry::optimize()
+{
+	//a Geometry without an index-List draws its vertices in order
+	if (!m_hasIndex || m_index.empty())
+	{
+		m_index.resize(m_vertices.size());
+		for (size_t i = 0; i < m_index.size(); i++)
+		{
+			m_index[i] = i;
+		}
+		setIndexTrue();
+	}
+
+	MeshOptimizer optimizer(m_vertices, m_index);
+	if (m_hasNormals)
+	{
+		optimizer.setNormals(&m_normals);
+	}
+	if (m_hasUV)
+	{
+		optimizer.setUVs(&m_uvs);
+	}
+	optimizer.setTangents(&m_tangents);
+	optimizer.optimize();
+
+	m_points = m_vertices.size();
+	m_indices = m_index.size();
+	m_hasBounds = false;
+}
+
 void Geometry::setLoaded()
 {
 	m_wasLoaded = true;
@@ -181,18 +415,28 @@ Geometry StaticMesh::toGeometry(){
 }
 
 Handle::Handle<StaticMesh> ResourceManager::loadStaticMesh(std::string filepath){
+  const unsigned int importFlags = aiProcess_Triangulate | aiProcess_SplitLargeMeshes | aiProcess_ImproveCacheLocality;
+
+  //the processed streams of an earlier import, without Assimp
+  std::string cachePath = MeshCache::getCachePath(filepath.c_str());
+  uint64_t key = MeshCache::hashSource(filepath.c_str(), MESH_IMPORTER_STATIC_MESH, importFlags);
+  StaticMesh cached = StaticMesh();
+  if(key && MeshCache::read(cachePath.c_str(), key, cached, cached.bounds)){
+    cached.hasBounds = true;
+    return meshes.add(cached);
+  }
+
   Assimp::Importer importer;
   std::vector<aiMesh*> meshEntries;
-  const aiScene *scene = importer.ReadFile(filepath.c_str(),
-                                           aiProcess_Triangulate |
-                                           aiProcess_SplitLargeMeshes |
-                                           aiProcess_ImproveCacheLocality);
+  const aiScene *scene = importer.ReadFile(filepath.c_str(), importFlags);
   std::vector<glm::vec4> vertices;
   std::vector<Index> indices;
   std::vector<Uv> uvs;
   std::vector<Normal> normals;
   if (!scene) {
     printf("Unable to load mesh: %s\n", importer.GetErrorString());
+    //an empty mesh, nothing is cached
+    return meshes.add(StaticMesh());
   }
   //
   for (int i = 0; i < scene->mNumMeshes; i++){
@@ -220,5 +464,17 @@ Handle::Handle<StaticMesh> ResourceManager::loadStaticMesh(std::string filepath)
       }
     }
   }
-  return meshes.add(StaticMesh{vertices,normals,uvs,indices});
+  MeshOptimizer optimizer(vertices, indices);
+  optimizer.setNormals(&normals);
+  optimizer.setUVs(&uvs);
+  MeshOptimizer::printReport(filepath.c_str(), optimizer.optimize());
+
+  StaticMesh mesh = StaticMesh{vertices,normals,uvs,indices};
+  if(key){
+    mesh.bounds = Geometry(mesh).getBounds();
+    mesh.hasBounds = true;
+    if(!MeshCache::write(cachePath.c_str(), key, mesh, mesh.bounds))
+      printf("WARNING: Unable to write the mesh cache %s\n", cachePath.c_str());
+  }
+  return meshes.add(mesh);
 }
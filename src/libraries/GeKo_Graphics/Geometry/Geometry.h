@@ -10,6 +10,7 @@
 #include <GLFW/glfw3.h>
 #include <GeKo_Graphics/Buffer.h>
 #include <GeKo_Graphics/BufferIndex.h>
+#include <GeKo_Graphics/Geometry/VertexLayout.h>
 #include <Geko_Resource/Handle/Handle.hpp>
 
 /*This class should be used as a interface class. It provides two Methods to load Data and to render the Vertice Data. 
@@ -20,11 +21,24 @@ using Uv = glm::vec2;
 using Index = GLuint;
 
 class Geometry;
+
+///The local-space bounding volumes of a Geometry
+/**An axis aligned box and a sphere around all vertices. They are computed once per Geometry and cached, 
+a node only transforms them with its modelmatrix*/
+struct GeometryBounds{
+  glm::vec3 boxMin;
+  glm::vec3 boxMax;
+  glm::vec3 sphereCenter;
+  float sphereRadius;
+};
+
 struct StaticMesh{
   std::vector<Vertex> vertices;
   std::vector<Normal> normals;
   std::vector<Uv> uvs;
   std::vector<Index> indicies;
+  bool hasBounds;	//bounds read from the MeshCache, the Geometry does not compute them again
+  GeometryBounds bounds;
   Geometry toGeometry();
 };
 class Geometry
@@ -43,14 +57,28 @@ public:
 	///A method to render the Object 
 	/**In the while-Loop of the main-programm (Renderer or else) this method will be called to draw the array*/
     void renderGeometry();
+	///Draws without binding the vertex array object, it has to be bound already (see getVAO)
+	/**Used by the RenderQueue, which binds the VAO only if it changes*/
+	void drawGeometry();
+	///Draws count instances, the VAO has to be bound already
+	void drawGeometryInstanced(int count);
+	///Returns the vertex array object
+	GLuint getVAO();
+	///GL_UNSIGNED_INT or GL_UNSIGNED_SHORT, the type of the index buffer after loadBufferData
+	GLenum getIndexType();
+
+	///Sets the format of the buffers, has to be called before loadBufferData
+	/**Without a layout the streams are uploaded as they are (VertexLayout::getSeparate()). The vectors of the Geometry don't change*/
+	void setVertexLayout(const VertexLayout& layout);
+	const VertexLayout& getVertexLayout();
 
 	///A method to compute the tangents for each triangle
 	/**Here we compute the tangens of each triangle to use them in a normalMapping Shader. This isn't a performance optimized solution but it works.*/
 	void computeTangents();
 
 	///Returns m_vertices of the Geometry Object
-	/**/
-	std::vector<glm::vec4> getVertices();
+	/**The vertices are not copied, the reference is valid as long as the Geometry exists*/
+	const std::vector<glm::vec4>& getVertices();
 
 	///Returns m_normals of the Geometry Object
 	/**/
@@ -68,6 +96,21 @@ public:
 	/**/
 	std::vector<GLuint> getIndexList();
 	
+	///Returns the cached local-space bounding box and bounding sphere
+	/**If the bounds were not computed yet, computeBounds() will be called first*/
+	const GeometryBounds& getBounds();
+
+	///Computes the bounding box and a tight bounding sphere of m_vertices
+	/**The box is the min/max of all vertices. The sphere is computed with Ritter's algorithm, started from the 
+	most separated pair of axis-extreme vertices. If the sphere around the box center is smaller, that one will be used.
+	Has to be called again if m_vertices were changed after the bounds were requested!*/
+	void computeBounds();
+
+	///Reorders the vertices and triangles for the vertex cache, less overdraw and the vertex fetch (see MeshOptimizer)
+	/**Has to be called before loadBufferData. A Geometry without an index-List gets one, duplicated vertices are merged.
+	The streams have to be triangle lists with one normal, uv and tangent per vertex, a triangle strip can't be reordered*/
+	void optimize();
+
 	///Sets m_wasLoaded to true
 	/**/
 	void setLoaded();
@@ -117,7 +160,18 @@ protected:
 	Buffer<glm::vec3>* m_tangentBuffer;
 	BufferIndex<GLuint>* m_indexBuffer;
 
+	VertexLayout m_vertexLayout;
+	GLuint m_packedBuffer;	//all streams of a layout which is not the separate one
+	BufferIndex<GLushort>* m_shortIndexBuffer;
+	GLenum m_indexType;
+
+	GeometryBounds m_bounds;
+	bool m_hasBounds;
+
 private:
+	///loadBufferData of a layout which is not the separate one
+	void loadPackedBufferData();
+
 	bool m_wasLoaded;
 	bool m_hasIndex;
 	bool m_hasNormals;
@@ -1,21 +1,60 @@
 #include <GeKo_Graphics/Geometry/Mesh.h>
+#include <GeKo_Graphics/Geometry/MeshCache.h>
+#include <GeKo_Graphics/Geometry/MeshOptimizer.h>
+
+static const unsigned int MESH_IMPORT_FLAGS = aiProcess_Triangulate | aiProcess_SplitLargeMeshes | aiProcess_ImproveCacheLocality;
 
 Mesh::Mesh(const char *filename)
 {
+	setVertexLayout(VertexLayout::getCompact());
+
+	//the streams of an earlier import are read from the cache, Assimp is not needed
+	std::string cachePath = MeshCache::getCachePath(filename);
+	uint64_t key = MeshCache::hashSource(filename, MESH_IMPORTER_MESH, MESH_IMPORT_FLAGS);
+	StaticMesh cached = StaticMesh();
+	if (key && MeshCache::read(cachePath.c_str(), key, cached, m_bounds))
+	{
+		setIndexTrue();
+		m_vertices.swap(cached.vertices);
+		m_uvs.swap(cached.uvs);
+		m_index.swap(cached.indicies);
+		m_points = m_vertices.size();
+		m_indices = m_index.size();
+		m_hasBounds = true;
+		return;
+	}
+
 	Assimp::Importer importer;
 
-	const aiScene *scene = importer.ReadFile(filename,
-		aiProcess_Triangulate |
-		aiProcess_SplitLargeMeshes |
-		aiProcess_ImproveCacheLocality);
+	const aiScene *scene = importer.ReadFile(filename, MESH_IMPORT_FLAGS);
 	if (!scene) {
 		printf("Unable to load mesh: %s\n", importer.GetErrorString());
+		return;
 	}
 
 	for (int i = 0; i < scene->mNumMeshes; i++){
 		meshEntries.push_back(scene->mMeshes[i]);
 	}
 	initializeData();
+	//the entries belong to the importer
+	meshEntries.clear();
+
+	//the cache stores the optimized streams, the optimizer runs once per file
+	MeshOptimizer optimizer(m_vertices, m_index);
+	optimizer.setUVs(&m_uvs);
+	MeshOptimizer::printReport(filename, optimizer.optimize());
+	m_points = m_vertices.size();
+	m_indices = m_index.size();
+
+	if (key)
+	{
+		StaticMesh mesh = StaticMesh();
+		mesh.vertices = m_vertices;
+		mesh.uvs = m_uvs;
+		mesh.indicies = m_index;
+		if (!MeshCache::write(cachePath.c_str(), key, mesh, getBounds()))
+			printf("WARNING: Unable to write the mesh cache %s\n", cachePath.c_str());
+	}
 }
 
 Mesh::~Mesh()
@@ -26,14 +65,22 @@ Mesh::~Mesh()
 void Mesh::initializeData()
 {
 	setIndexTrue();
+
+	size_t vertexCount = 0, indexCount = 0;
+	for (auto entry : meshEntries)
+	{
+		vertexCount += entry->mNumVertices;
+		indexCount += entry->mNumFaces * 3;
+	}
+	m_vertices.reserve(vertexCount);
+	m_uvs.reserve(vertexCount);
+	m_index.reserve(indexCount);
+
 	for (int i = 0; i < meshEntries.size(); i++)
 	{
 
 		for (int j = 0; j < meshEntries.at(i)->mNumVertices; j++)
 		{
-			m_points += meshEntries.at(i)->mNumVertices;
-			m_indices += meshEntries.at(i)->mNumFaces;
-
 			if (meshEntries.at(i)->HasPositions())
 				m_vertices.push_back(glm::vec4(meshEntries.at(i)->mVertices[j].x, meshEntries.at(i)->mVertices[j].y, meshEntries.at(i)->mVertices[j].z, 1.0));
 
@@ -57,4 +104,6 @@ void Mesh::initializeData()
 				m_index.push_back(meshEntries.at(i)->mFaces[k].mIndices[l]);
 		}
 	}
+	m_points = m_vertices.size();
+	m_indices = m_index.size();
 }
\ No newline at end of file
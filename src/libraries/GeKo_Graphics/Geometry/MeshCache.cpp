@@ -0,0 +1,147 @@
+#include "MeshCache.h"
+#include "GeKo_Graphics/MappedFile.h"
+#include <cstdio>
+#include <cstring>
+
+static const uint32_t MESH_CACHE_MAGIC = 0x534D4B47;	//"GKMS"
+static const uint32_t MESH_CACHE_VERSION = 2;
+static const uint64_t STREAM_ALIGNMENT = 16;
+
+static_assert(sizeof(Vertex) == 16 && sizeof(Normal) == 12 && sizeof(Uv) == 8 && sizeof(Index) == 4, "the streams are stored as they are in the memory");
+
+struct MeshCacheHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t key;
+	uint32_t vertexCount;
+	uint32_t normalCount;
+	uint32_t uvCount;
+	uint32_t indexCount;
+	float boxMin[3];
+	float boxMax[3];
+	float sphereCenter[3];
+	float sphereRadius;
+};
+
+static uint64_t align(uint64_t offset)
+{
+	return (offset + STREAM_ALIGNMENT - 1) & ~(STREAM_ALIGNMENT - 1);
+}
+
+//the offsets of the streams in the file, the last one is the size of the file
+static void getStreamOffsets(const MeshCacheHeader& header, uint64_t offsets[5])
+{
+	offsets[0] = align(sizeof(MeshCacheHeader));
+	offsets[1] = align(offsets[0] + (uint64_t)header.vertexCount * sizeof(Vertex));
+	offsets[2] = align(offsets[1] + (uint64_t)header.normalCount * sizeof(Normal));
+	offsets[3] = align(offsets[2] + (uint64_t)header.uvCount * sizeof(Uv));
+	offsets[4] = offsets[3] + (uint64_t)header.indexCount * sizeof(Index);
+}
+
+static uint64_t hashBytes(const unsigned char* data, size_t size, uint64_t hash)
+{
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= data[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+std::string MeshCache::getCachePath(const char* sourcePath)
+{
+	return std::string(sourcePath) + ".gkmesh";
+}
+
+uint64_t MeshCache::hashSource(const char* sourcePath, MeshImporter importer, unsigned int importFlags)
+{
+	MappedFile file;
+	if (!file.open(sourcePath))
+		return 0;
+
+	uint32_t parameters[3] = { MESH_CACHE_VERSION, (uint32_t)importer, importFlags };
+	uint64_t hash = hashBytes((const unsigned char*)parameters, sizeof(parameters), 14695981039346656037ull);
+	hash = hashBytes(file.getData(), file.getSize(), hash);
+	//0 is the key of an unreadable source
+	return hash ? hash : 1;
+}
+
+bool MeshCache::write(const char* path, uint64_t key, const StaticMesh& mesh, const GeometryBounds& bounds)
+{
+	MeshCacheHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = MESH_CACHE_MAGIC;
+	header.version = MESH_CACHE_VERSION;
+	header.key = key;
+	header.vertexCount = (uint32_t)mesh.vertices.size();
+	header.normalCount = (uint32_t)mesh.normals.size();
+	header.uvCount = (uint32_t)mesh.uvs.size();
+	header.indexCount = (uint32_t)mesh.indicies.size();
+	for (int i = 0; i < 3; i++)
+	{
+		header.boxMin[i] = bounds.boxMin[i];
+		header.boxMax[i] = bounds.boxMax[i];
+		header.sphereCenter[i] = bounds.sphereCenter[i];
+	}
+	header.sphereRadius = bounds.sphereRadius;
+
+	uint64_t offsets[5];
+	getStreamOffsets(header, offsets);
+	std::vector<unsigned char> body((size_t)offsets[4], 0);
+	memcpy(body.data(), &header, sizeof(header));
+	if (!mesh.vertices.empty())
+		memcpy(&body[(size_t)offsets[0]], mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex));
+	if (!mesh.normals.empty())
+		memcpy(&body[(size_t)offsets[1]], mesh.normals.data(), mesh.normals.size() * sizeof(Normal));
+	if (!mesh.uvs.empty())
+		memcpy(&body[(size_t)offsets[2]], mesh.uvs.data(), mesh.uvs.size() * sizeof(Uv));
+	if (!mesh.indicies.empty())
+		memcpy(&body[(size_t)offsets[3]], mesh.indicies.data(), mesh.indicies.size() * sizeof(Index));
+
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr)
+		return false;
+	bool success = fwrite(body.data(), body.size(), 1, file) == 1;
+	success = (fclose(file) == 0) && success;
+
+	if (!success)
+		remove(path);
+	return success;
+}
+
+bool MeshCache::read(const char* path, uint64_t key, StaticMesh& mesh, GeometryBounds& bounds)
+{
+	MappedFile file;
+	if (!file.open(path))
+		return false;
+	if (file.getSize() < sizeof(MeshCacheHeader))
+		return false;
+
+	MeshCacheHeader header;
+	memcpy(&header, file.getData(), sizeof(header));
+	if (header.magic != MESH_CACHE_MAGIC || header.version != MESH_CACHE_VERSION || header.key != key)
+		return false;
+
+	uint64_t offsets[5];
+	getStreamOffsets(header, offsets);
+	if (file.getSize() != offsets[4])
+		return false;
+
+	//the vectors are assigned from the mapped streams, one copy per stream
+	const unsigned char* data = file.getData();
+	const Vertex* vertices = (const Vertex*)(data + offsets[0]);
+	const Normal* normals = (const Normal*)(data + offsets[1]);
+	const Uv* uvs = (const Uv*)(data + offsets[2]);
+	const Index* indices = (const Index*)(data + offsets[3]);
+	mesh.vertices.assign(vertices, vertices + header.vertexCount);
+	mesh.normals.assign(normals, normals + header.normalCount);
+	mesh.uvs.assign(uvs, uvs + header.uvCount);
+	mesh.indicies.assign(indices, indices + header.indexCount);
+
+	bounds.boxMin = glm::vec3(header.boxMin[0], header.boxMin[1], header.boxMin[2]);
+	bounds.boxMax = glm::vec3(header.boxMax[0], header.boxMax[1], header.boxMax[2]);
+	bounds.sphereCenter = glm::vec3(header.sphereCenter[0], header.sphereCenter[1], header.sphereCenter[2]);
+	bounds.sphereRadius = header.sphereRadius;
+	return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <stdint.h>
+#include <GeKo_Graphics/Geometry/Geometry.h>
+
+///The importers which use the cache, part of the key of a cached mesh
+enum MeshImporter
+{
+	MESH_IMPORTER_MESH = 1,	//Mesh::Mesh
+	MESH_IMPORTER_STATIC_MESH = 2	//ResourceManager::loadStaticMesh
+};
+
+///Binary cache of the meshes imported with Assimp
+/*
+Description: The Assimp import (parsing, triangulation, cache locality) and the MeshOptimizer run only once per file. The importer writes the processed
+streams & the bounds next to the source ("Tree.ply" -> "Tree.ply.gkmesh"), later loads map the cache file and copy every stream
+with one copy into the vectors of the Geometry, the bounds are not computed again.
+
+The key of a cache file is the FNV-1a hash of the content of the source, the importer & its Assimp flags (see hashSource).
+A changed source, another importer or another cache version make the importer import the file again & overwrite the cache.
+
+The streams are stored after the MeshOptimizer, version 1 files hold the streams as Assimp returned them.
+
+File layout (version 2):
+-header: magic "GKMS", version, key, number of vertices, normals, uvs & indices, bounds
+-the streams, each one starts at a multiple of 16 bytes: vertices (vec4), normals (vec3), uvs (vec2), indices (uint32)
+*/
+
+class MeshCache
+{
+public:
+	///"Tree.ply" -> "Tree.ply.gkmesh"
+	static std::string getCachePath(const char* sourcePath);
+
+	///The key of the source for the importer & its Assimp flags, 0 if the source can't be read
+	static uint64_t hashSource(const char* sourcePath, MeshImporter importer, unsigned int importFlags);
+
+	///Writes the streams & the bounds of the mesh, returns false if the file can't be written
+	static bool write(const char* path, uint64_t key, const StaticMesh& mesh, const GeometryBounds& bounds);
+
+	///Reads the streams & the bounds, returns false (and changes nothing) if the file is missing, invalid or has another key
+	static bool read(const char* path, uint64_t key, StaticMesh& mesh, GeometryBounds& bounds);
+};
@@ -0,0 +1,434 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+
+static const Index INVALID_VERTEX = 0xFFFFFFFF;
+static const int DEFAULT_CACHE_SIZE = 16;
+
+template<class T>
+static void remapStream(std::vector<T>& stream, const std::vector<Index>& remap, size_t vertexCount)
+{
+	std::vector<T> remapped(vertexCount);
+	for (size_t i = 0; i < remap.size(); i++)
+	{
+		if (remap[i] != INVALID_VERTEX)
+			remapped[remap[i]] = stream[i];
+	}
+	stream.swap(remapped);
+}
+
+template<class T>
+static uint64_t hashElement(const std::vector<T>* stream, size_t index, uint64_t hash)
+{
+	if (!stream)
+		return hash;
+	const unsigned char* bytes = (const unsigned char*)&(*stream)[index];
+	for (size_t i = 0; i < sizeof(T); i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+template<class T>
+static bool equalElements(const std::vector<T>* stream, size_t a, size_t b)
+{
+	return !stream || memcmp(&(*stream)[a], &(*stream)[b], sizeof(T)) == 0;
+}
+
+MeshOptimizer::MeshOptimizer(std::vector<Vertex>& vertices, std::vector<Index>& indices)
+	: m_vertices(vertices), m_indices(indices)
+{
+	m_normals = nullptr;
+	m_uvs = nullptr;
+	m_tangents = nullptr;
+	m_cacheSize = DEFAULT_CACHE_SIZE;
+}
+
+void MeshOptimizer::setNormals(std::vector<Normal>* normals)
+{
+	m_normals = (normals && normals->size() == m_vertices.size()) ? normals : nullptr;
+}
+
+void MeshOptimizer::setUVs(std::vector<Uv>* uvs)
+{
+	m_uvs = (uvs && uvs->size() == m_vertices.size()) ? uvs : nullptr;
+}
+
+void MeshOptimizer::setTangents(std::vector<glm::vec3>* tangents)
+{
+	m_tangents = (tangents && tangents->size() == m_vertices.size()) ? tangents : nullptr;
+}
+
+void MeshOptimizer::setCacheSize(int cacheSize)
+{
+	m_cacheSize = std::max(cacheSize, 3);
+}
+
+int MeshOptimizer::getCacheSize()
+{
+	return m_cacheSize;
+}
+
+bool MeshOptimizer::isValid()
+{
+	if (m_indices.size() % 3 != 0)
+	{
+		printf("WARNING: MeshOptimizer - the index list is not a list of triangles\n");
+		return false;
+	}
+	for (auto index : m_indices)
+	{
+		if (index >= m_vertices.size())
+		{
+			printf("WARNING: MeshOptimizer - the index list references missing vertices\n");
+			return false;
+		}
+	}
+	return true;
+}
+
+void MeshOptimizer::weld()
+{
+	if (!isValid())
+		return;
+
+	//open addressing, the table holds the first vertex of every unique vertex
+	size_t vertexCount = m_vertices.size();
+	size_t tableSize = 1;
+	while (tableSize < vertexCount * 2)
+		tableSize *= 2;
+	std::vector<Index> table(tableSize, INVALID_VERTEX);
+	std::vector<Index> remap(vertexCount);
+	Index uniqueCount = 0;
+
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		uint64_t hash = hashElement(&m_vertices, i, 14695981039346656037ull);
+		hash = hashElement(m_normals, i, hash);
+		hash = hashElement(m_uvs, i, hash);
+		hash = hashElement(m_tangents, i, hash);
+
+		size_t slot = (size_t)hash & (tableSize - 1);
+		while (true)
+		{
+			Index entry = table[slot];
+			if (entry == INVALID_VERTEX)
+			{
+				table[slot] = (Index)i;
+				remap[i] = uniqueCount++;
+				break;
+			}
+			if (equalElements(&m_vertices, entry, i) && equalElements(m_normals, entry, i)
+				&& equalElements(m_uvs, entry, i) && equalElements(m_tangents, entry, i))
+			{
+				remap[i] = remap[entry];
+				break;
+			}
+			slot = (slot + 1) & (tableSize - 1);
+		}
+	}
+
+	for (auto& index : m_indices)
+		index = remap[index];
+	remapVertices(remap, uniqueCount);
+}
+
+void MeshOptimizer::optimizeVertexCache()
+{
+	if (!isValid() || m_indices.empty())
+		return;
+
+	size_t vertexCount = m_vertices.size();
+	size_t triangleCount = m_indices.size() / 3;
+
+	//the triangles of every vertex
+	std::vector<unsigned int> offsets(vertexCount + 1, 0);
+	for (auto index : m_indices)
+		offsets[index + 1]++;
+	for (size_t v = 0; v < vertexCount; v++)
+		offsets[v + 1] += offsets[v];
+	std::vector<unsigned int> adjacency(m_indices.size());
+	std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+	for (size_t i = 0; i < m_indices.size(); i++)
+		adjacency[fill[m_indices[i]]++] = (unsigned int)(i / 3);
+
+	std::vector<int> live(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++)
+		live[v] = offsets[v + 1] - offsets[v];
+
+	std::vector<int> cacheTime(vertexCount, 0);
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<Index> deadEnd;
+	std::vector<Index> candidates;
+	std::vector<Index> output;
+	output.reserve(m_indices.size());
+
+	int time = m_cacheSize + 1;
+	size_t cursor = 0;
+	int fan = 0;
+	while (fan >= 0)
+	{
+		//all triangles around the fanning vertex
+		candidates.clear();
+		for (unsigned int k = offsets[fan]; k < offsets[fan + 1]; k++)
+		{
+			unsigned int triangle = adjacency[k];
+			if (emitted[triangle])
+				continue;
+			for (int c = 0; c < 3; c++)
+			{
+				Index v = m_indices[triangle * 3 + c];
+				output.push_back(v);
+				deadEnd.push_back(v);
+				candidates.push_back(v);
+				live[v]--;
+				if (time - cacheTime[v] > m_cacheSize)
+				{
+					cacheTime[v] = time;
+					time++;
+				}
+			}
+			emitted[triangle] = true;
+		}
+
+		//the next fanning vertex: the oldest candidate that will still be in the cache after its triangles
+		fan = -1;
+		int bestPriority = -1;
+		for (auto v : candidates)
+		{
+			if (live[v] <= 0)
+				continue;
+			int priority = 0;
+			if (time - cacheTime[v] + 2 * live[v] <= m_cacheSize)
+				priority = time - cacheTime[v];
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				fan = (int)v;
+			}
+		}
+
+		//dead end: a recently used vertex or the next vertex with triangles left
+		while (fan < 0 && !deadEnd.empty())
+		{
+			Index v = deadEnd.back();
+			deadEnd.pop_back();
+			if (live[v] > 0)
+				fan = (int)v;
+		}
+		while (fan < 0 && cursor < vertexCount)
+		{
+			if (live[cursor] > 0)
+				fan = (int)cursor;
+			cursor++;
+		}
+	}
+
+	m_indices.swap(output);
+}
+
+void MeshOptimizer::optimizeOverdraw(float threshold)
+{
+	if (!isValid() || m_indices.empty())
+		return;
+
+	size_t vertexCount = m_vertices.size();
+	size_t triangleCount = m_indices.size() / 3;
+
+	//the cache misses of every triangle in the current order
+	std::vector<unsigned int> cacheTime(vertexCount, 0);
+	unsigned int time = m_cacheSize;
+	auto countMisses = [&](size_t triangle)
+	{
+		int misses = 0;
+		for (int c = 0; c < 3; c++)
+		{
+			Index v = m_indices[triangle * 3 + c];
+			if (time - cacheTime[v] >= (unsigned int)m_cacheSize)
+			{
+				cacheTime[v] = time;
+				time++;
+				misses++;
+			}
+		}
+		return misses;
+	};
+	//every vertex in the cache is older than the cache size afterwards
+	auto resetCache = [&]() { time += m_cacheSize; };
+
+	std::vector<int> misses(triangleCount);
+	for (size_t t = 0; t < triangleCount; t++)
+		misses[t] = countMisses(t);
+
+	//hard boundaries where the order starts over (all vertices of a triangle are missed). A hard cluster is cut further where
+	//the ACMR of the part, with an empty cache at its start, is below threshold times the ACMR of the hard cluster
+	std::vector<size_t> clusters;
+	size_t hardBegin = 0;
+	while (hardBegin < triangleCount)
+	{
+		size_t hardEnd = hardBegin + 1;
+		while (hardEnd < triangleCount && misses[hardEnd] < 3)
+			hardEnd++;
+
+		resetCache();
+		int hardMisses = 0;
+		for (size_t t = hardBegin; t < hardEnd; t++)
+			hardMisses += countMisses(t);
+		float hardACMR = hardMisses / (float)(hardEnd - hardBegin);
+
+		clusters.push_back(hardBegin);
+		resetCache();
+		size_t begin = hardBegin;
+		int clusterMisses = 0;
+		for (size_t t = hardBegin; t + 1 < hardEnd; t++)
+		{
+			clusterMisses += countMisses(t);
+			if (clusterMisses <= threshold * hardACMR * (t + 1 - begin))
+			{
+				clusters.push_back(t + 1);
+				resetCache();
+				begin = t + 1;
+				clusterMisses = 0;
+			}
+		}
+		hardBegin = hardEnd;
+	}
+	clusters.push_back(triangleCount);
+
+	//the center of the mesh, weighted by the area of the triangles
+	std::vector<glm::vec3> clusterCenters(clusters.size() - 1, glm::vec3(0.0f));
+	std::vector<glm::vec3> clusterNormals(clusters.size() - 1, glm::vec3(0.0f));
+	std::vector<float> clusterAreas(clusters.size() - 1, 0.0f);
+	glm::vec3 meshCenter = glm::vec3(0.0f);
+	float meshArea = 0.0f;
+	for (size_t c = 0; c + 1 < clusters.size(); c++)
+	{
+		for (size_t t = clusters[c]; t < clusters[c + 1]; t++)
+		{
+			glm::vec3 p0 = glm::vec3(m_vertices[m_indices[t * 3]]);
+			glm::vec3 p1 = glm::vec3(m_vertices[m_indices[t * 3 + 1]]);
+			glm::vec3 p2 = glm::vec3(m_vertices[m_indices[t * 3 + 2]]);
+			glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			float area = glm::length(normal);
+			glm::vec3 center = (p0 + p1 + p2) * (area / 3.0f);
+
+			clusterCenters[c] += center;
+			clusterNormals[c] += normal;
+			clusterAreas[c] += area;
+			meshCenter += center;
+			meshArea += area;
+		}
+	}
+	if (meshArea > 0.0f)
+		meshCenter /= meshArea;
+
+	//outer clusters facing away from the center first
+	std::vector<float> keys(clusters.size() - 1, 0.0f);
+	std::vector<size_t> order(clusters.size() - 1);
+	for (size_t c = 0; c < order.size(); c++)
+	{
+		order[c] = c;
+		float normalLength = glm::length(clusterNormals[c]);
+		if (clusterAreas[c] > 0.0f && normalLength > 0.0f)
+			keys[c] = glm::dot(clusterCenters[c] / clusterAreas[c] - meshCenter, clusterNormals[c] / normalLength);
+	}
+	std::stable_sort(order.begin(), order.end(), [&keys](size_t a, size_t b) { return keys[a] > keys[b]; });
+
+	std::vector<Index> output;
+	output.reserve(m_indices.size());
+	for (auto c : order)
+		output.insert(output.end(), m_indices.begin() + clusters[c] * 3, m_indices.begin() + clusters[c + 1] * 3);
+	m_indices.swap(output);
+}
+
+void MeshOptimizer::optimizeVertexFetch()
+{
+	if (!isValid())
+		return;
+
+	std::vector<Index> remap(m_vertices.size(), INVALID_VERTEX);
+	Index next = 0;
+	for (auto& index : m_indices)
+	{
+		if (remap[index] == INVALID_VERTEX)
+			remap[index] = next++;
+		index = remap[index];
+	}
+	remapVertices(remap, next);
+}
+
+MeshOptimizerReport MeshOptimizer::optimize()
+{
+	MeshOptimizerReport report;
+	report.verticesBefore = (int)m_vertices.size();
+	report.before = getStatistics();
+
+	weld();
+	optimizeVertexCache();
+	optimizeOverdraw();
+	optimizeVertexFetch();
+
+	report.verticesAfter = (int)m_vertices.size();
+	report.after = getStatistics();
+	return report;
+}
+
+void MeshOptimizer::printReport(const char* name, const MeshOptimizerReport& report)
+{
+	printf("SUCCESS: %s optimized: %d -> %d vertices, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n", name,
+		report.verticesBefore, report.verticesAfter, report.before.acmr, report.after.acmr, report.before.atvr, report.after.atvr);
+}
+
+VertexCacheStatistics MeshOptimizer::getStatistics()
+{
+	return computeStatistics(m_indices, m_vertices.size(), m_cacheSize);
+}
+
+VertexCacheStatistics MeshOptimizer::computeStatistics(const std::vector<Index>& indices, size_t vertexCount, int cacheSize)
+{
+	VertexCacheStatistics statistics;
+	statistics.acmr = 0.0f;
+	statistics.atvr = 0.0f;
+
+	std::vector<unsigned int> cacheTime(vertexCount, 0);
+	std::vector<bool> referenced(vertexCount, false);
+	unsigned int time = cacheSize;
+	size_t misses = 0, referencedCount = 0;
+	for (auto v : indices)
+	{
+		if (v >= vertexCount)
+			return statistics;
+		if (!referenced[v])
+		{
+			referenced[v] = true;
+			referencedCount++;
+		}
+		if (time - cacheTime[v] >= (unsigned int)cacheSize)
+		{
+			cacheTime[v] = time;
+			time++;
+			misses++;
+		}
+	}
+
+	if (indices.size() >= 3)
+		statistics.acmr = misses / (float)(indices.size() / 3);
+	if (referencedCount > 0)
+		statistics.atvr = misses / (float)referencedCount;
+	return statistics;
+}
+
+void MeshOptimizer::remapVertices(const std::vector<Index>& remap, size_t vertexCount)
+{
+	remapStream(m_vertices, remap, vertexCount);
+	if (m_normals)
+		remapStream(*m_normals, remap, vertexCount);
+	if (m_uvs)
+		remapStream(*m_uvs, remap, vertexCount);
+	if (m_tangents)
+		remapStream(*m_tangents, remap, vertexCount);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vector>
+#include <GeKo_Graphics/Geometry/Geometry.h>
+
+///Efficiency of an index list for a FIFO post-transform vertex cache
+struct VertexCacheStatistics
+{
+	float acmr;	//average cache miss ratio: transformed vertices per triangle, 0.5 at best & 3 at worst
+	float atvr;	//average transformed vertex ratio: transformed per referenced vertex, 1 at best
+};
+
+///The statistics before & after MeshOptimizer::optimize
+struct MeshOptimizerReport
+{
+	int verticesBefore;
+	int verticesAfter;
+	VertexCacheStatistics before;
+	VertexCacheStatistics after;
+};
+
+///Reorders the vertices & triangles of an indexed triangle mesh for the GPU
+/*
+Description: The optimizer works on the streams of a mesh, the vertices & the index list are needed, the normals, uvs & tangents
+are optional (setNormals...). Each optional stream needs one entry per vertex, they are remapped with the vertices.
+The steps, optimize runs all of them in this order:
+-weld: vertices with the same position & attributes are merged
+-optimizeVertexCache: the triangles are reordered with Tipsify (Sander et al. 2007), so a vertex is used again while it is in the post-transform cache
+-optimizeOverdraw: the triangle order is cut into clusters at the points where the cache order starts over. The clusters
+ are sorted so the outer ones facing away from the center are drawn first, they hide more of the mesh. Clusters are only cut where it
+ costs less than threshold times the ACMR
+-optimizeVertexFetch: the vertices are sorted by their first use, unused vertices are dropped
+
+The statistics simulate a FIFO cache of getCacheSize() vertices (16 by default), they don't need a GPU.
+*/
+
+class MeshOptimizer
+{
+public:
+	MeshOptimizer(std::vector<Vertex>& vertices, std::vector<Index>& indices);
+
+	///The optional streams, ignored if they don't have one entry per vertex
+	void setNormals(std::vector<Normal>* normals);
+	void setUVs(std::vector<Uv>* uvs);
+	void setTangents(std::vector<glm::vec3>* tangents);
+
+	void setCacheSize(int cacheSize);
+	int getCacheSize();
+
+	void weld();
+	void optimizeVertexCache();
+	///threshold >= 1, a higher one cuts more clusters & trades vertex cache efficiency for less overdraw
+	void optimizeOverdraw(float threshold = 1.05f);
+	void optimizeVertexFetch();
+
+	///Runs all steps
+	MeshOptimizerReport optimize();
+	///Prints the statistics of the report
+	static void printReport(const char* name, const MeshOptimizerReport& report);
+
+	VertexCacheStatistics getStatistics();
+	static VertexCacheStatistics computeStatistics(const std::vector<Index>& indices, size_t vertexCount, int cacheSize);
+
+private:
+	///remap[old vertex] is the new vertex or INVALID_VERTEX for a dropped one
+	void remapVertices(const std::vector<Index>& remap, size_t vertexCount);
+	bool isValid();
+
+	std::vector<Vertex>& m_vertices;
+	std::vector<Index>& m_indices;
+	std::vector<Normal>* m_normals;
+	std::vector<Uv>* m_uvs;
+	std::vector<glm::vec3>* m_tangents;
+	int m_cacheSize;
+};
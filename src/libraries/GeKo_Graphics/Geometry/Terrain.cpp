@@ -42,6 +42,9 @@ Terrain::Terrain(std::string filename, float resolution, float interval)
 	setIndexTrue();
 	setUVTrue();
 
+	optimize();
+	//the uvs are tiled, they stay floats
+	setVertexLayout(VertexLayout::getCompact());
 }
 
 Terrain::~Terrain(){
@@ -0,0 +1,362 @@
+#include "VertexLayout.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static const size_t MAX_SHORT_INDEX_VERTICES = 65536;
+
+//the arguments of glVertexAttribPointer & the bytes of one element
+struct StreamFormat
+{
+	GLint size;
+	GLenum type;
+	GLboolean normalized;
+	size_t bytes;
+};
+
+static StreamFormat getPositionFormat(VertexPositionFormat format)
+{
+	switch (format)
+	{
+	case VERTEX_POSITION_FLOAT3:
+		return { 3, GL_FLOAT, GL_FALSE, 12 };
+	case VERTEX_POSITION_HALF3:
+		//padded, every attribute starts at a multiple of 4 bytes
+		return { 3, GL_HALF_FLOAT, GL_FALSE, 8 };
+	default:
+		return { 4, GL_FLOAT, GL_FALSE, 16 };
+	}
+}
+
+static StreamFormat getNormalFormat(VertexNormalFormat format)
+{
+	switch (format)
+	{
+	case VERTEX_NORMAL_INT_2_10_10_10:
+		return { 4, GL_INT_2_10_10_10_REV, GL_TRUE, 4 };
+	case VERTEX_NORMAL_OCTAHEDRAL_INT16:
+		return { 2, GL_SHORT, GL_TRUE, 4 };
+	default:
+		return { 3, GL_FLOAT, GL_FALSE, 12 };
+	}
+}
+
+static StreamFormat getUvFormat(VertexUvFormat format)
+{
+	switch (format)
+	{
+	case VERTEX_UV_HALF2:
+		return { 2, GL_HALF_FLOAT, GL_FALSE, 4 };
+	case VERTEX_UV_UNORM16:
+		return { 2, GL_UNSIGNED_SHORT, GL_TRUE, 4 };
+	default:
+		return { 2, GL_FLOAT, GL_FALSE, 8 };
+	}
+}
+
+static void writePosition(VertexPositionFormat format, const glm::vec4& position, unsigned char* out)
+{
+	switch (format)
+	{
+	case VERTEX_POSITION_FLOAT3:
+		memcpy(out, &position[0], 12);
+		break;
+	case VERTEX_POSITION_HALF3:
+	{
+		uint16_t half[3] = { VertexLayout::packHalf(position.x), VertexLayout::packHalf(position.y), VertexLayout::packHalf(position.z) };
+		memcpy(out, half, 6);
+		break;
+	}
+	default:
+		memcpy(out, &position[0], 16);
+		break;
+	}
+}
+
+static void writeNormal(VertexNormalFormat format, const glm::vec3& normal, unsigned char* out)
+{
+	switch (format)
+	{
+	case VERTEX_NORMAL_INT_2_10_10_10:
+	{
+		uint32_t packed = VertexLayout::packNormal(normal);
+		memcpy(out, &packed, 4);
+		break;
+	}
+	case VERTEX_NORMAL_OCTAHEDRAL_INT16:
+	{
+		int16_t packed[2];
+		VertexLayout::packOctahedral(normal, packed);
+		memcpy(out, packed, 4);
+		break;
+	}
+	default:
+		memcpy(out, &normal[0], 12);
+		break;
+	}
+}
+
+static void writeUv(VertexUvFormat format, const glm::vec2& uv, unsigned char* out)
+{
+	switch (format)
+	{
+	case VERTEX_UV_HALF2:
+	{
+		uint16_t half[2] = { VertexLayout::packHalf(uv.x), VertexLayout::packHalf(uv.y) };
+		memcpy(out, half, 4);
+		break;
+	}
+	case VERTEX_UV_UNORM16:
+	{
+		uint16_t unorm[2] = { (uint16_t)(uv.x * 65535.0f + 0.5f), (uint16_t)(uv.y * 65535.0f + 0.5f) };
+		memcpy(out, unorm, 4);
+		break;
+	}
+	default:
+		memcpy(out, &uv[0], 8);
+		break;
+	}
+}
+
+VertexLayout VertexLayout::getSeparate()
+{
+	VertexLayout layout;
+	layout.position = VERTEX_POSITION_FLOAT4;
+	layout.normal = VERTEX_NORMAL_FLOAT3;
+	layout.uv = VERTEX_UV_FLOAT2;
+	layout.interleaved = false;
+	layout.shortIndices = false;
+	return layout;
+}
+
+VertexLayout VertexLayout::getCompact()
+{
+	VertexLayout layout;
+	layout.position = VERTEX_POSITION_FLOAT3;
+	layout.normal = VERTEX_NORMAL_INT_2_10_10_10;
+	layout.uv = VERTEX_UV_UNORM16;
+	layout.interleaved = true;
+	layout.shortIndices = true;
+	return layout;
+}
+
+bool VertexLayout::isSeparate() const
+{
+	return position == VERTEX_POSITION_FLOAT4 && normal == VERTEX_NORMAL_FLOAT3 && uv == VERTEX_UV_FLOAT2 && !interleaved && !shortIndices;
+}
+
+size_t VertexLayout::getVertexSize(bool hasNormals, bool hasUV, bool hasTangents) const
+{
+	size_t size = getPositionFormat(position).bytes;
+	if (hasNormals)
+		size += getNormalFormat(normal).bytes;
+	if (hasUV)
+		size += getUvFormat(uv).bytes;
+	if (hasTangents)
+		size += getNormalFormat(normal).bytes;
+	return size;
+}
+
+bool VertexLayout::useShortIndices(size_t vertexCount) const
+{
+	return shortIndices && vertexCount <= MAX_SHORT_INDEX_VERTICES;
+}
+
+void VertexLayout::pack(const std::vector<glm::vec4>& vertices, const std::vector<glm::vec3>* normals, const std::vector<glm::vec2>* uvs,
+	const std::vector<glm::vec3>* tangents, PackedVertices& packed) const
+{
+	size_t count = vertices.size();
+	if (normals && normals->size() != count)
+		normals = nullptr;
+	if (uvs && uvs->size() != count)
+		uvs = nullptr;
+	if (tangents && tangents->size() != count)
+		tangents = nullptr;
+
+	//tiled uvs don't fit into [0,1]
+	VertexUvFormat uvFormat = uv;
+	if (uvs && uvFormat == VERTEX_UV_UNORM16)
+	{
+		for (auto& texCoord : *uvs)
+		{
+			if (texCoord.x < 0.0f || texCoord.x > 1.0f || texCoord.y < 0.0f || texCoord.y > 1.0f)
+			{
+				uvFormat = VERTEX_UV_FLOAT2;
+				break;
+			}
+		}
+	}
+
+	//the attributes in the order of their locations
+	StreamFormat formats[4] = { getPositionFormat(position), getNormalFormat(normal), getUvFormat(uvFormat), getNormalFormat(normal) };
+	bool used[4] = { true, normals != nullptr, uvs != nullptr, tangents != nullptr };
+
+	size_t vertexSize = 0;
+	for (int location = 0; location < 4; location++)
+	{
+		if (used[location])
+			vertexSize += formats[location].bytes;
+	}
+
+	packed.data.assign(vertexSize * count, 0);
+	packed.attributes.clear();
+
+	size_t offset = 0;
+	for (int location = 0; location < 4; location++)
+	{
+		if (!used[location])
+			continue;
+
+		const StreamFormat& format = formats[location];
+		VertexAttribute attribute;
+		attribute.location = location;
+		attribute.size = format.size;
+		attribute.type = format.type;
+		attribute.normalized = format.normalized;
+		attribute.stride = (GLsizei)(interleaved ? vertexSize : format.bytes);
+		attribute.offset = offset;
+		packed.attributes.push_back(attribute);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			unsigned char* out = &packed.data[offset + i * attribute.stride];
+			switch (location)
+			{
+			case 0:
+				writePosition(position, vertices[i], out);
+				break;
+			case 1:
+				writeNormal(normal, (*normals)[i], out);
+				break;
+			case 2:
+				writeUv(uvFormat, (*uvs)[i], out);
+				break;
+			case 3:
+				writeNormal(normal, (*tangents)[i], out);
+				break;
+			}
+		}
+
+		//interleaved: the offset in the vertex, otherwise the start of the next stream
+		offset += interleaved ? format.bytes : format.bytes * count;
+	}
+}
+
+uint16_t VertexLayout::packHalf(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, 4);
+	uint32_t sign = (bits >> 16) & 0x8000;
+	int exponent = (int)((bits >> 23) & 0xFF);
+	uint32_t mantissa = bits & 0x7FFFFF;
+
+	//infinity & NaN
+	if (exponent == 0xFF)
+		return (uint16_t)(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+
+	exponent = exponent - 127 + 15;
+	if (exponent >= 31)
+		return (uint16_t)(sign | 0x7C00);
+
+	uint32_t half, rest, halfway;
+	if (exponent <= 0)
+	{
+		//denormal or zero
+		if (exponent < -10)
+			return (uint16_t)sign;
+		mantissa |= 0x800000;
+		int shift = 14 - exponent;
+		half = mantissa >> shift;
+		rest = mantissa & ((1u << shift) - 1);
+		halfway = 1u << (shift - 1);
+	}
+	else
+	{
+		half = ((uint32_t)exponent << 10) | (mantissa >> 13);
+		rest = mantissa & 0x1FFF;
+		halfway = 0x1000;
+	}
+
+	//round to nearest even, a carry into the exponent is correct
+	if (rest > halfway || (rest == halfway && (half & 1)))
+		half++;
+	return (uint16_t)(sign | half);
+}
+
+float VertexLayout::unpackHalf(uint16_t half)
+{
+	uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+	int exponent = (half >> 10) & 0x1F;
+	uint32_t mantissa = half & 0x3FF;
+
+	float value;
+	if (exponent == 0)
+		value = std::ldexp((float)mantissa, -24);
+	else if (exponent == 31)
+		value = mantissa ? NAN : INFINITY;
+	else
+		value = std::ldexp((float)(mantissa | 0x400), exponent - 25);
+
+	uint32_t bits;
+	memcpy(&bits, &value, 4);
+	bits |= sign;
+	memcpy(&value, &bits, 4);
+	return value;
+}
+
+uint32_t VertexLayout::packNormal(const glm::vec3& normal)
+{
+	float length = std::sqrt(glm::dot(normal, normal));
+	glm::vec3 n = length > 0.0f ? normal / length : normal;
+
+	uint32_t packed = 0;
+	for (int c = 0; c < 3; c++)
+	{
+		int value = (int)std::floor(std::max(-1.0f, std::min(1.0f, n[c])) * 511.0f + 0.5f);
+		packed |= ((uint32_t)value & 0x3FF) << (10 * c);
+	}
+	return packed;
+}
+
+glm::vec3 VertexLayout::unpackNormal(uint32_t packed)
+{
+	glm::vec3 normal;
+	for (int c = 0; c < 3; c++)
+	{
+		//sign extension of the 10 bits
+		int value = (int)(packed << (22 - 10 * c)) >> 22;
+		normal[c] = std::max(-1.0f, value / 511.0f);
+	}
+	return normal;
+}
+
+void VertexLayout::packOctahedral(const glm::vec3& normal, int16_t packed[2])
+{
+	float sum = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+	float x = sum > 0.0f ? normal.x / sum : 0.0f;
+	float y = sum > 0.0f ? normal.y / sum : 0.0f;
+
+	//the lower half is folded over the diagonals
+	if (normal.z < 0.0f)
+	{
+		float foldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+		float foldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+		x = foldedX;
+		y = foldedY;
+	}
+
+	packed[0] = (int16_t)std::floor(std::max(-1.0f, std::min(1.0f, x)) * 32767.0f + 0.5f);
+	packed[1] = (int16_t)std::floor(std::max(-1.0f, std::min(1.0f, y)) * 32767.0f + 0.5f);
+}
+
+glm::vec3 VertexLayout::unpackOctahedral(const int16_t packed[2])
+{
+	//the same as decodeOctahedral in VertexFormats.glsl
+	float x = std::max(-1.0f, packed[0] / 32767.0f);
+	float y = std::max(-1.0f, packed[1] / 32767.0f);
+	glm::vec3 normal = glm::vec3(x, y, 1.0f - std::abs(x) - std::abs(y));
+	float t = std::max(-normal.z, 0.0f);
+	normal.x += normal.x >= 0.0f ? -t : t;
+	normal.y += normal.y >= 0.0f ? -t : t;
+	return normal / std::sqrt(glm::dot(normal, normal));
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+///The formats of the positions in the vertex buffer
+enum VertexPositionFormat
+{
+	VERTEX_POSITION_FLOAT4,	//16 bytes, the vec4 of the Geometry
+	VERTEX_POSITION_FLOAT3,	//12 bytes, w is 1.0 in the shader
+	VERTEX_POSITION_HALF3	//8 bytes (6 & padding), only for small meshes: 11 bits of precision, 0.25 between 512 and 1024
+};
+
+///The formats of the normals & the tangents
+enum VertexNormalFormat
+{
+	VERTEX_NORMAL_FLOAT3,	//12 bytes
+	VERTEX_NORMAL_INT_2_10_10_10,	//4 bytes, normalized, the shader reads it as a vec3 like the float normal
+	VERTEX_NORMAL_OCTAHEDRAL_INT16	//4 bytes, two normalized shorts, the shader needs decodeOctahedral (VertexFormats.glsl) & a vec2 input
+};
+
+///The formats of the uvs
+enum VertexUvFormat
+{
+	VERTEX_UV_FLOAT2,	//8 bytes
+	VERTEX_UV_HALF2,	//4 bytes
+	VERTEX_UV_UNORM16	//4 bytes, only for uvs in [0,1], other uvs are stored as floats
+};
+
+///One attribute of a packed vertex buffer, the arguments of glVertexAttribPointer
+struct VertexAttribute
+{
+	GLuint location;
+	GLint size;
+	GLenum type;
+	GLboolean normalized;
+	GLsizei stride;
+	size_t offset;
+};
+
+///The streams of a Geometry converted into one buffer
+struct PackedVertices
+{
+	std::vector<unsigned char> data;
+	std::vector<VertexAttribute> attributes;
+};
+
+///The format of the vertex buffer & the index buffer of a Geometry
+/*
+Description: The Geometry keeps its streams as vec4 positions, vec3 normals, vec2 uvs and 32-bit indices, the layout only changes
+what loadBufferData uploads. The attribute locations stay the same (0 position, 1 normal, 2 uv, 3 tangent), so every format except
+the octahedral normals works with the existing shaders: OpenGL converts the half, packed and normalized types when the vertices are fetched.
+-interleaved: all attributes of a vertex next to each other, otherwise one stream after the other in the same buffer
+-shortIndices: 16-bit indices if the Geometry has at most 65536 vertices
+
+getSeparate() is the layout of the Geometry without a layout, getCompact() needs about half of the memory & the fetch bandwidth:
+positions 12 instead of 16 bytes, normals & tangents 4 instead of 12, uvs 4 instead of 8, indices 2 instead of 4.
+*/
+
+struct VertexLayout
+{
+	VertexPositionFormat position;
+	VertexNormalFormat normal;
+	VertexUvFormat uv;
+	bool interleaved;
+	bool shortIndices;
+
+	///vec4, vec3 & vec2 floats in separate streams, 32-bit indices
+	static VertexLayout getSeparate();
+	///Interleaved float3 positions, 10:10:10:2 normals, unorm16 uvs & 16-bit indices
+	static VertexLayout getCompact();
+
+	bool isSeparate() const;
+	///Bytes of one vertex with the streams
+	size_t getVertexSize(bool hasNormals, bool hasUV, bool hasTangents) const;
+	///True if the indices of vertexCount vertices are stored with 16 bits
+	bool useShortIndices(size_t vertexCount) const;
+
+	///Converts the streams into the layout. normals, uvs & tangents can be NULL, otherwise they need one entry per vertex
+	void pack(const std::vector<glm::vec4>& vertices, const std::vector<glm::vec3>* normals, const std::vector<glm::vec2>* uvs,
+		const std::vector<glm::vec3>* tangents, PackedVertices& packed) const;
+
+	///IEEE half float, rounded to the nearest
+	static uint16_t packHalf(float value);
+	static float unpackHalf(uint16_t half);
+	///The normalized vector in GL_INT_2_10_10_10_REV, w is 0
+	static uint32_t packNormal(const glm::vec3& normal);
+	static glm::vec3 unpackNormal(uint32_t packed);
+	///The normalized vector mapped onto an octahedron, two snorm16 values
+	static void packOctahedral(const glm::vec3& normal, int16_t packed[2]);
+	static glm::vec3 unpackOctahedral(const int16_t packed[2]);
+};
@@ -0,0 +1,131 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+{
+	m_data = nullptr;
+	m_size = 0;
+#ifdef _WIN32
+	m_file = INVALID_HANDLE_VALUE;
+	m_mapping = nullptr;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+#ifdef _WIN32
+bool MappedFile::open(const char* path)
+{
+	close();
+
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	m_file = file;
+	m_mapping = mapping;
+	m_data = (const unsigned char*)data;
+	m_size = (size_t)size.QuadPart;
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (m_data != nullptr)
+		UnmapViewOfFile(m_data);
+	if (m_mapping != nullptr)
+		CloseHandle(m_mapping);
+	if (m_file != INVALID_HANDLE_VALUE)
+		CloseHandle(m_file);
+
+	m_data = nullptr;
+	m_size = 0;
+	m_file = INVALID_HANDLE_VALUE;
+	m_mapping = nullptr;
+}
+#else
+bool MappedFile::open(const char* path)
+{
+	close();
+
+	int file = ::open(path, O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat fileStat;
+	if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+	{
+		::close(file);
+		return false;
+	}
+
+	void* data = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	//the mapping stays valid without the file descriptor
+	::close(file);
+	if (data == MAP_FAILED)
+		return false;
+
+	m_data = (const unsigned char*)data;
+	m_size = (size_t)fileStat.st_size;
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (m_data != nullptr)
+		munmap((void*)m_data, m_size);
+
+	m_data = nullptr;
+	m_size = 0;
+}
+#endif
+
+bool MappedFile::isOpen()
+{
+	return m_data != nullptr;
+}
+
+const unsigned char* MappedFile::getData()
+{
+	return m_data;
+}
+
+size_t MappedFile::getSize()
+{
+	return m_size;
+}
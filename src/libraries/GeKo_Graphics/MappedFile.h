@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+
+///A read only file, mapped into the memory
+/*
+Description: The file is not copied into the memory, the OS loads the pages when they are read.
+Use it for binary files that are read only once (e.g. compiled effects), the data is valid until close() or the destructor.
+*/
+
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	///Maps the whole file, returns false if the file can't be opened or is empty
+	bool open(const char* path);
+	void close();
+
+	bool isOpen();
+	const unsigned char* getData();
+	size_t getSize();
+
+private:
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+	const unsigned char* m_data;
+	size_t m_size;
+#ifdef _WIN32
+	void* m_file;
+	void* m_mapping;
+#endif
+};
@@ -0,0 +1,710 @@
+#include "CookedTexture.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+static const uint32_t COOKED_TEXTURE_MAGIC = 0x58544B47;	//"GKTX"
+static const uint32_t COOKED_TEXTURE_VERSION = 1;
+static const int MAX_COOKED_SIZE = 16384;
+
+struct CookedTextureHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t format;
+	uint32_t width;
+	uint32_t height;
+	uint32_t levelCount;
+	uint32_t dataSize;		//of all levels
+	uint32_t checksum;		//of the header fields above & the level table, the level data is not hashed to keep the load fast
+	int64_t sourceSize;		//of the image file
+	int64_t sourceTime;
+};
+
+struct CookedLevelEntry
+{
+	uint32_t offset;
+	uint32_t size;
+};
+
+static uint32_t computeChecksum(const unsigned char* data, size_t size, uint32_t hash = 2166136261u)
+{
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= data[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static uint32_t computeChecksum(const CookedTextureHeader& header, const CookedLevelEntry* levels)
+{
+	uint32_t hash = computeChecksum((const unsigned char*)&header, offsetof(CookedTextureHeader, checksum));
+	return computeChecksum((const unsigned char*)levels, header.levelCount * sizeof(CookedLevelEntry), hash);
+}
+
+static bool getSourceStamp(const char* imagePath, int64_t& size, int64_t& time)
+{
+	struct stat fileStat;
+	if (stat(imagePath, &fileStat) != 0)
+		return false;
+	size = (int64_t)fileStat.st_size;
+	time = (int64_t)fileStat.st_mtime;
+	return true;
+}
+
+static int getMipCount(int width, int height)
+{
+	int count = 1;
+	while (width > 1 || height > 1)
+	{
+		width = std::max(width / 2, 1);
+		height = std::max(height / 2, 1);
+		count++;
+	}
+	return count;
+}
+
+static int getBlockBytes(CookedTextureFormat format)
+{
+	return (format == COOKED_BC1) ? 8 : 16;
+}
+
+//---- block compression ----
+
+//the 4x4 pixels of the block at (x, y), the pixels outside of the image repeat the border
+static void fetchBlock(const unsigned char* rgba, int width, int height, int x, int y, unsigned char block[16][4])
+{
+	for (int by = 0; by < 4; by++)
+	{
+		int py = std::min(y + by, height - 1);
+		for (int bx = 0; bx < 4; bx++)
+		{
+			int px = std::min(x + bx, width - 1);
+			memcpy(block[by * 4 + bx], rgba + (py * width + px) * 4, 4);
+		}
+	}
+}
+
+static void storeBlock(unsigned char* rgba, int width, int height, int x, int y, const unsigned char block[16][4])
+{
+	for (int by = 0; by < 4 && y + by < height; by++)
+	{
+		for (int bx = 0; bx < 4 && x + bx < width; bx++)
+			memcpy(rgba + ((y + by) * width + x + bx) * 4, block[by * 4 + bx], 4);
+	}
+}
+
+static uint16_t packColor565(const float color[3])
+{
+	int r = (int)(std::min(std::max(color[0], 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f);
+	int g = (int)(std::min(std::max(color[1], 0.0f), 255.0f) * 63.0f / 255.0f + 0.5f);
+	int b = (int)(std::min(std::max(color[2], 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f);
+	return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void unpackColor565(uint16_t packed, int color[3])
+{
+	int r = (packed >> 11) & 31;
+	int g = (packed >> 5) & 63;
+	int b = packed & 31;
+	color[0] = (r << 3) | (r >> 2);
+	color[1] = (g << 2) | (g >> 4);
+	color[2] = (b << 3) | (b >> 2);
+}
+
+static void getPalette(uint16_t color0, uint16_t color1, bool alwaysFourColors, int palette[4][4])
+{
+	unpackColor565(color0, palette[0]);
+	unpackColor565(color1, palette[1]);
+	palette[0][3] = palette[1][3] = 255;
+	for (int c = 0; c < 3; c++)
+	{
+		if (color0 > color1 || alwaysFourColors)
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+		else
+		{
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+			palette[3][c] = 0;
+		}
+	}
+	palette[2][3] = 255;
+	palette[3][3] = (color0 > color1 || alwaysFourColors) ? 255 : 0;
+}
+
+//the indices of the nearest palette colors, returns the squared error of the block
+static int assignColorIndices(const unsigned char block[16][4], uint16_t color0, uint16_t color1, uint32_t& indices)
+{
+	indices = 0;
+	int palette[4][4];
+	getPalette(color0, color1, true, palette);
+
+	int error = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		int best = 0, bestDistance = 0x7FFFFFFF;
+		for (int p = 0; p < 4; p++)
+		{
+			int r = block[i][0] - palette[p][0];
+			int g = block[i][1] - palette[p][1];
+			int b = block[i][2] - palette[p][2];
+			int distance = r * r + g * g + b * b;
+			if (distance < bestDistance) { bestDistance = distance; best = p; }
+		}
+		indices |= (uint32_t)best << (2 * i);
+		error += bestDistance;
+	}
+	return error;
+}
+
+//the end points with the least squared error for the indices, false if the indices don't define them
+static bool refineEndPoints(const unsigned char block[16][4], uint32_t indices, float color0[3], float color1[3])
+{
+	static const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+	float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+	float ax[3] = { 0.0f, 0.0f, 0.0f };
+	float bx[3] = { 0.0f, 0.0f, 0.0f };
+	for (int i = 0; i < 16; i++)
+	{
+		float a = weights[(indices >> (2 * i)) & 3];
+		float b = 1.0f - a;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for (int c = 0; c < 3; c++)
+		{
+			ax[c] += a * block[i][c];
+			bx[c] += b * block[i][c];
+		}
+	}
+
+	float determinant = aa * bb - ab * ab;
+	if (std::abs(determinant) < 1e-6f)
+		return false;
+	for (int c = 0; c < 3; c++)
+	{
+		color0[c] = (ax[c] * bb - bx[c] * ab) / determinant;
+		color1[c] = (bx[c] * aa - ax[c] * ab) / determinant;
+	}
+	return true;
+}
+
+//the end points are the extremes of the pixels along the main axis of the colors, refined once with least squares
+static void encodeColorBlock(const unsigned char block[16][4], unsigned char* out)
+{
+	float mean[3] = { 0.0f, 0.0f, 0.0f };
+	for (int i = 0; i < 16; i++)
+	{
+		for (int c = 0; c < 3; c++)
+			mean[c] += block[i][c] / 16.0f;
+	}
+
+	float covariance[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+	for (int i = 0; i < 16; i++)
+	{
+		float r = block[i][0] - mean[0];
+		float g = block[i][1] - mean[1];
+		float b = block[i][2] - mean[2];
+		covariance[0] += r * r;
+		covariance[1] += r * g;
+		covariance[2] += r * b;
+		covariance[3] += g * g;
+		covariance[4] += g * b;
+		covariance[5] += b * b;
+	}
+
+	//power iteration, a few steps are enough for the direction
+	float axis[3] = { 1.0f, 1.0f, 1.0f };
+	for (int step = 0; step < 4; step++)
+	{
+		float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+		float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+		float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+		float length = std::max(std::max(std::abs(x), std::abs(y)), std::abs(z));
+		if (length < 1e-6f)
+			break;
+		axis[0] = x / length;
+		axis[1] = y / length;
+		axis[2] = z / length;
+	}
+
+	int minIndex = 0, maxIndex = 0;
+	float minProjection = 1e30f, maxProjection = -1e30f;
+	for (int i = 0; i < 16; i++)
+	{
+		float projection = block[i][0] * axis[0] + block[i][1] * axis[1] + block[i][2] * axis[2];
+		if (projection < minProjection) { minProjection = projection; minIndex = i; }
+		if (projection > maxProjection) { maxProjection = projection; maxIndex = i; }
+	}
+
+	float maxColor[3] = { (float)block[maxIndex][0], (float)block[maxIndex][1], (float)block[maxIndex][2] };
+	float minColor[3] = { (float)block[minIndex][0], (float)block[minIndex][1], (float)block[minIndex][2] };
+	uint16_t color0 = packColor565(maxColor);
+	uint16_t color1 = packColor565(minColor);
+	//color0 > color1 selects the mode with four colors
+	if (color0 < color1)
+		std::swap(color0, color1);
+
+	uint32_t indices = 0;
+	if (color0 != color1)
+	{
+		int error = assignColorIndices(block, color0, color1, indices);
+
+		float refined0[3], refined1[3];
+		if (refineEndPoints(block, indices, refined0, refined1))
+		{
+			uint16_t refinedColor0 = packColor565(refined0);
+			uint16_t refinedColor1 = packColor565(refined1);
+			if (refinedColor0 < refinedColor1)
+				std::swap(refinedColor0, refinedColor1);
+
+			uint32_t refinedIndices;
+			if (refinedColor0 != refinedColor1 && assignColorIndices(block, refinedColor0, refinedColor1, refinedIndices) < error)
+			{
+				color0 = refinedColor0;
+				color1 = refinedColor1;
+				indices = refinedIndices;
+			}
+		}
+	}
+
+	out[0] = color0 & 0xFF;
+	out[1] = color0 >> 8;
+	out[2] = color1 & 0xFF;
+	out[3] = color1 >> 8;
+	for (int i = 0; i < 4; i++)
+		out[4 + i] = (indices >> (8 * i)) & 0xFF;
+}
+
+static void decodeColorBlock(const unsigned char* in, bool alwaysFourColors, unsigned char block[16][4])
+{
+	uint16_t color0 = (uint16_t)(in[0] | (in[1] << 8));
+	uint16_t color1 = (uint16_t)(in[2] | (in[3] << 8));
+	uint32_t indices = in[4] | (in[5] << 8) | (in[6] << 16) | ((uint32_t)in[7] << 24);
+
+	int palette[4][4];
+	getPalette(color0, color1, alwaysFourColors, palette);
+	for (int i = 0; i < 16; i++)
+	{
+		int index = (indices >> (2 * i)) & 3;
+		for (int c = 0; c < 4; c++)
+			block[i][c] = (unsigned char)palette[index][c];
+	}
+}
+
+//one channel with 8 values between its minimum & maximum (BC4, the alpha of BC3 & both channels of BC5)
+static void encodeChannelBlock(const unsigned char block[16][4], int channel, unsigned char* out)
+{
+	int maxValue = 0, minValue = 255;
+	for (int i = 0; i < 16; i++)
+	{
+		maxValue = std::max(maxValue, (int)block[i][channel]);
+		minValue = std::min(minValue, (int)block[i][channel]);
+	}
+
+	uint64_t indices = 0;
+	if (maxValue != minValue)
+	{
+		int palette[8];
+		palette[0] = maxValue;
+		palette[1] = minValue;
+		for (int p = 2; p < 8; p++)
+			palette[p] = ((8 - p) * maxValue + (p - 1) * minValue) / 7;
+		for (int i = 0; i < 16; i++)
+		{
+			int best = 0, bestDistance = 256;
+			for (int p = 0; p < 8; p++)
+			{
+				int distance = std::abs(block[i][channel] - palette[p]);
+				if (distance < bestDistance) { bestDistance = distance; best = p; }
+			}
+			indices |= (uint64_t)best << (3 * i);
+		}
+	}
+
+	out[0] = (unsigned char)maxValue;
+	out[1] = (unsigned char)minValue;
+	for (int i = 0; i < 6; i++)
+		out[2 + i] = (indices >> (8 * i)) & 0xFF;
+}
+
+static void decodeChannelBlock(const unsigned char* in, int channel, unsigned char block[16][4])
+{
+	int value0 = in[0];
+	int value1 = in[1];
+	uint64_t indices = 0;
+	for (int i = 0; i < 6; i++)
+		indices |= (uint64_t)in[2 + i] << (8 * i);
+
+	int palette[8];
+	palette[0] = value0;
+	palette[1] = value1;
+	if (value0 > value1)
+	{
+		for (int p = 2; p < 8; p++)
+			palette[p] = ((8 - p) * value0 + (p - 1) * value1) / 7;
+	}
+	else
+	{
+		for (int p = 2; p < 6; p++)
+			palette[p] = ((6 - p) * value0 + (p - 1) * value1) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+	for (int i = 0; i < 16; i++)
+		block[i][channel] = (unsigned char)palette[(indices >> (3 * i)) & 7];
+}
+
+//---- CookedTexture ----
+
+CookedTexture::CookedTexture()
+{
+	m_format = COOKED_RGBA8;
+	m_width = 0;
+	m_height = 0;
+}
+
+std::string CookedTexture::getCookedPath(const char* imagePath)
+{
+	std::string path(imagePath);
+	size_t dot = path.find_last_of('.');
+	size_t slash = path.find_last_of("/\\");
+	if (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+		path = path.substr(0, dot);
+	return path + ".gktex";
+}
+
+bool CookedTexture::isCookedPath(const char* path)
+{
+	size_t length = strlen(path);
+	return length >= 6 && strcmp(path + length - 6, ".gktex") == 0;
+}
+
+const char* CookedTexture::getFormatName(CookedTextureFormat format)
+{
+	switch (format)
+	{
+	case COOKED_RGBA8: return "RGBA8";
+	case COOKED_BC1: return "BC1";
+	case COOKED_BC3: return "BC3";
+	case COOKED_BC5: return "BC5";
+	default: return "unknown";
+	}
+}
+
+size_t CookedTexture::getLevelSize(CookedTextureFormat format, int width, int height)
+{
+	if (format == COOKED_RGBA8)
+		return (size_t)width * height * 4;
+	size_t blocks = (size_t)((width + 3) / 4) * ((height + 3) / 4);
+	return blocks * getBlockBytes(format);
+}
+
+void CookedTexture::buildMipChain(const unsigned char* rgba, int width, int height, std::vector<std::vector<unsigned char> >& levels)
+{
+	levels.clear();
+	levels.push_back(std::vector<unsigned char>(rgba, rgba + (size_t)width * height * 4));
+
+	while (width > 1 || height > 1)
+	{
+		const std::vector<unsigned char>& source = levels.back();
+		int nextWidth = std::max(width / 2, 1);
+		int nextHeight = std::max(height / 2, 1);
+		std::vector<unsigned char> next((size_t)nextWidth * nextHeight * 4);
+
+		//the average of 2x2 pixels, a side of size 1 repeats its pixel
+		for (int y = 0; y < nextHeight; y++)
+		{
+			int y0 = std::min(2 * y, height - 1);
+			int y1 = std::min(2 * y + 1, height - 1);
+			for (int x = 0; x < nextWidth; x++)
+			{
+				int x0 = std::min(2 * x, width - 1);
+				int x1 = std::min(2 * x + 1, width - 1);
+				for (int c = 0; c < 4; c++)
+				{
+					int sum = source[(y0 * width + x0) * 4 + c] + source[(y0 * width + x1) * 4 + c]
+						+ source[(y1 * width + x0) * 4 + c] + source[(y1 * width + x1) * 4 + c];
+					next[(y * nextWidth + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+				}
+			}
+		}
+
+		levels.push_back(next);
+		width = nextWidth;
+		height = nextHeight;
+	}
+}
+
+void CookedTexture::encodeLevel(const unsigned char* rgba, int width, int height, CookedTextureFormat format, std::vector<unsigned char>& data)
+{
+	data.resize(getLevelSize(format, width, height));
+	if (format == COOKED_RGBA8)
+	{
+		memcpy(data.data(), rgba, data.size());
+		return;
+	}
+
+	unsigned char* out = data.data();
+	unsigned char block[16][4];
+	for (int y = 0; y < height; y += 4)
+	{
+		for (int x = 0; x < width; x += 4)
+		{
+			fetchBlock(rgba, width, height, x, y, block);
+			switch (format)
+			{
+			case COOKED_BC1:
+				encodeColorBlock(block, out);
+				break;
+			case COOKED_BC3:
+				encodeChannelBlock(block, 3, out);
+				encodeColorBlock(block, out + 8);
+				break;
+			case COOKED_BC5:
+				encodeChannelBlock(block, 0, out);
+				encodeChannelBlock(block, 1, out + 8);
+				break;
+			default:
+				break;
+			}
+			out += getBlockBytes(format);
+		}
+	}
+}
+
+void CookedTexture::decodeLevel(const unsigned char* data, int width, int height, CookedTextureFormat format, std::vector<unsigned char>& rgba)
+{
+	rgba.resize((size_t)width * height * 4);
+	if (format == COOKED_RGBA8)
+	{
+		memcpy(rgba.data(), data, rgba.size());
+		return;
+	}
+
+	const unsigned char* in = data;
+	unsigned char block[16][4];
+	for (int y = 0; y < height; y += 4)
+	{
+		for (int x = 0; x < width; x += 4)
+		{
+			switch (format)
+			{
+			case COOKED_BC1:
+				decodeColorBlock(in, false, block);
+				break;
+			case COOKED_BC3:
+				decodeColorBlock(in + 8, true, block);
+				decodeChannelBlock(in, 3, block);
+				break;
+			case COOKED_BC5:
+				for (int i = 0; i < 16; i++)
+				{
+					block[i][2] = 0;
+					block[i][3] = 255;
+				}
+				decodeChannelBlock(in, 0, block);
+				decodeChannelBlock(in + 8, 1, block);
+				break;
+			default:
+				break;
+			}
+			storeBlock(rgba.data(), width, height, x, y, block);
+			in += getBlockBytes(format);
+		}
+	}
+}
+
+bool CookedTexture::write(const char* path, const char* imagePath, const unsigned char* rgba, int width, int height, CookedTextureFormat format)
+{
+	if (width <= 0 || height <= 0 || width > MAX_COOKED_SIZE || height > MAX_COOKED_SIZE)
+		return false;
+
+	std::vector<std::vector<unsigned char> > mipmaps;
+	buildMipChain(rgba, width, height, mipmaps);
+
+	std::vector<CookedLevelEntry> entries(mipmaps.size());
+	std::vector<unsigned char> body;
+	int levelWidth = width, levelHeight = height;
+	for (size_t i = 0; i < mipmaps.size(); i++)
+	{
+		std::vector<unsigned char> data;
+		encodeLevel(mipmaps[i].data(), levelWidth, levelHeight, format, data);
+		entries[i].offset = (uint32_t)body.size();
+		entries[i].size = (uint32_t)data.size();
+		body.insert(body.end(), data.begin(), data.end());
+
+		levelWidth = std::max(levelWidth / 2, 1);
+		levelHeight = std::max(levelHeight / 2, 1);
+	}
+
+	CookedTextureHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = COOKED_TEXTURE_MAGIC;
+	header.version = COOKED_TEXTURE_VERSION;
+	header.format = format;
+	header.width = width;
+	header.height = height;
+	header.levelCount = (uint32_t)entries.size();
+	header.dataSize = (uint32_t)body.size();
+	getSourceStamp(imagePath, header.sourceSize, header.sourceTime);
+	header.checksum = computeChecksum(header, entries.data());
+
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr)
+		return false;
+	bool success = fwrite(&header, sizeof(header), 1, file) == 1;
+	success = success && fwrite(entries.data(), entries.size() * sizeof(CookedLevelEntry), 1, file) == 1;
+	success = success && fwrite(body.data(), body.size(), 1, file) == 1;
+	success = (fclose(file) == 0) && success;
+
+	if (!success)
+		remove(path);
+	return success;
+}
+
+bool CookedTexture::open(const char* path, const char* imagePath)
+{
+	close();
+	if (!m_file.open(path))
+		return false;
+
+	CookedTextureHeader header;
+	if (m_file.getSize() < sizeof(header))
+	{
+		close();
+		return false;
+	}
+	memcpy(&header, m_file.getData(), sizeof(header));
+
+	//the whole chain down to 1x1, so the sizes of all levels are known
+	bool valid = header.magic == COOKED_TEXTURE_MAGIC && header.version == COOKED_TEXTURE_VERSION
+		&& header.format < COOKED_FORMAT_COUNT
+		&& header.width > 0 && header.height > 0 && header.width <= MAX_COOKED_SIZE && header.height <= MAX_COOKED_SIZE
+		&& header.levelCount == (uint32_t)getMipCount(header.width, header.height)
+		&& m_file.getSize() == sizeof(header) + header.levelCount * sizeof(CookedLevelEntry) + header.dataSize;
+	if (!valid)
+	{
+		close();
+		return false;
+	}
+
+	std::vector<CookedLevelEntry> entries(header.levelCount);
+	memcpy(entries.data(), m_file.getData() + sizeof(header), entries.size() * sizeof(CookedLevelEntry));
+	if (computeChecksum(header, entries.data()) != header.checksum)
+	{
+		close();
+		return false;
+	}
+
+	//a changed image has to be cooked again. Without the image the cooked file is used as it is
+	int64_t sourceSize, sourceTime;
+	if (imagePath && getSourceStamp(imagePath, sourceSize, sourceTime) && (sourceSize != header.sourceSize || sourceTime != header.sourceTime))
+	{
+		close();
+		return false;
+	}
+
+	m_format = (CookedTextureFormat)header.format;
+	m_width = header.width;
+	m_height = header.height;
+
+	const unsigned char* data = m_file.getData() + sizeof(header) + entries.size() * sizeof(CookedLevelEntry);
+	for (uint32_t i = 0; i < header.levelCount; i++)
+	{
+		if (entries[i].size != getLevelSize(m_format, getLevelWidth(i), getLevelHeight(i))
+			|| (uint64_t)entries[i].offset + entries[i].size > header.dataSize)
+		{
+			close();
+			return false;
+		}
+		m_levels.push_back(data + entries[i].offset);
+		m_levelSizes.push_back(entries[i].size);
+	}
+	return true;
+}
+
+void CookedTexture::close()
+{
+	m_file.close();
+	m_levels.clear();
+	m_levelSizes.clear();
+	m_width = 0;
+	m_height = 0;
+}
+
+void CookedTexture::upload()
+{
+	//RGTC is core since OpenGL 3.0, S3TC is an extension
+	bool compressed = m_format == COOKED_BC5 || ((m_format == COOKED_BC1 || m_format == COOKED_BC3) && GLEW_EXT_texture_compression_s3tc);
+	GLenum compressedFormat = GL_COMPRESSED_RG_RGTC2;
+	if (m_format == COOKED_BC1)
+		compressedFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	else if (m_format == COOKED_BC3)
+		compressedFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+
+	std::vector<unsigned char> rgba;
+	for (int level = 0; level < getLevelCount(); level++)
+	{
+		int width = getLevelWidth(level);
+		int height = getLevelHeight(level);
+		if (m_format == COOKED_RGBA8)
+			glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_levels[level]);
+		else if (compressed)
+			glCompressedTexImage2D(GL_TEXTURE_2D, level, compressedFormat, width, height, 0, (GLsizei)m_levelSizes[level], m_levels[level]);
+		else
+		{
+			decodeLevel(m_levels[level], width, height, m_format, rgba);
+			glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+		}
+	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, getLevelCount() - 1);
+}
+
+CookedTextureFormat CookedTexture::getFormat()
+{
+	return m_format;
+}
+
+int CookedTexture::getWidth()
+{
+	return m_width;
+}
+
+int CookedTexture::getHeight()
+{
+	return m_height;
+}
+
+int CookedTexture::getLevelCount()
+{
+	return (int)m_levels.size();
+}
+
+int CookedTexture::getLevelWidth(int level)
+{
+	return std::max(m_width >> level, 1);
+}
+
+int CookedTexture::getLevelHeight(int level)
+{
+	return std::max(m_height >> level, 1);
+}
+
+const unsigned char* CookedTexture::getLevelData(int level)
+{
+	return m_levels[level];
+}
+
+size_t CookedTexture::getLevelDataSize(int level)
+{
+	return m_levelSizes[level];
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <GeKo_Graphics/Defs.h>
+#include <GeKo_Graphics/MappedFile.h>
+
+///The formats of the levels of a cooked texture
+enum CookedTextureFormat
+{
+	COOKED_RGBA8,	//uncompressed
+	COOKED_BC1,	//DXT1, RGB in 8 bytes per 4x4 block
+	COOKED_BC3,	//DXT5, RGBA in 16 bytes per 4x4 block
+	COOKED_BC5,	//RGTC2, two channels in 16 bytes per 4x4 block (normal maps, the shader has to reconstruct z)
+	COOKED_FORMAT_COUNT
+};
+
+///An image with its mipmaps, prepared offline by the Tool_TextureCooker
+/*
+Description: The images are decoded, flipped, mipmapped & compressed once by the cooker instead of with every start.
+The cooked file is written next to the image ("Texture/wall.png" -> "Texture/wall.gktex"), Texture::load uses it when it is valid
+and falls back to the image otherwise. The levels are uploaded as they are with glCompressedTexImage2D. If the driver has no S3TC
+support, the BC1 & BC3 levels are decoded to RGBA8 on the CPU (RGTC is core since OpenGL 3.0).
+
+File layout (version 1):
+-header: magic "GKTX", version, format, size of level 0, number of levels, size & time of the image, checksum
+-one entry per level: offset & size of its data, relative to the end of the level table
+-the data of the levels, level 0 first. The rows are bottom up like OpenGL expects them
+
+The file is mapped with MappedFile, the data of the levels is valid while the CookedTexture is open.
+*/
+
+class CookedTexture
+{
+public:
+	CookedTexture();
+
+	///"Texture/wall.png" -> "Texture/wall.gktex"
+	static std::string getCookedPath(const char* imagePath);
+	static bool isCookedPath(const char* path);
+
+	static const char* getFormatName(CookedTextureFormat format);
+	///Bytes of a level of the size in the format
+	static size_t getLevelSize(CookedTextureFormat format, int width, int height);
+
+	///The mip chain of an RGBA8 image down to 1x1, level 0 is a copy of the image. Box filtered
+	static void buildMipChain(const unsigned char* rgba, int width, int height, std::vector<std::vector<unsigned char> >& levels);
+	///Converts an RGBA8 level into the format
+	static void encodeLevel(const unsigned char* rgba, int width, int height, CookedTextureFormat format, std::vector<unsigned char>& data);
+	///Converts a level in the format into RGBA8. BC5 is decoded into red & green, blue is 0 & alpha 255
+	static void decodeLevel(const unsigned char* data, int width, int height, CookedTextureFormat format, std::vector<unsigned char>& rgba);
+
+	///Cooks the RGBA8 image & writes it, the size & time of the image file are stored to find stale files. False if the file can't be written
+	static bool write(const char* path, const char* imagePath, const unsigned char* rgba, int width, int height, CookedTextureFormat format);
+
+	///Maps a cooked file. False if it is missing or invalid, or if the image at imagePath (can be NULL) was changed after the cooking
+	bool open(const char* path, const char* imagePath);
+	void close();
+
+	///Uploads all levels into the bound GL_TEXTURE_2D, needs the GL context
+	void upload();
+
+	CookedTextureFormat getFormat();
+	int getWidth();
+	int getHeight();
+	int getLevelCount();
+	int getLevelWidth(int level);
+	int getLevelHeight(int level);
+	const unsigned char* getLevelData(int level);
+	size_t getLevelDataSize(int level);
+
+private:
+	CookedTexture(const CookedTexture&);
+	CookedTexture& operator=(const CookedTexture&);
+
+	MappedFile m_file;
+	CookedTextureFormat m_format;
+	int m_width, m_height;
+	std::vector<const unsigned char*> m_levels;
+	std::vector<size_t> m_levelSizes;
+};
@@ -1,4 +1,6 @@
 #include "Texture.h"
+#include <GeKo_Graphics/Material/TextureManager.h>
+#include <GeKo_Graphics/Material/CookedTexture.h>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -6,7 +8,24 @@
 Texture::Texture(char* fileName)
 {
 	m_textureID = INVALID_OGL_VALUE;
+	m_loaded = false;
+	m_sampler = SAMPLER_LINEAR_REPEAT;
+	m_unit = GL_TEXTURE0;
+	setFilepath(fileName);
 
+	load(fileName);
+}
+
+Texture::Texture(GLuint texture)
+{
+	setTexture(texture);
+	m_loaded = true;
+	m_sampler = SAMPLER_LINEAR_REPEAT;
+	m_unit = GL_TEXTURE0;
+}
+
+void Texture::setFilepath(const char* fileName)
+{
 	//save path without RESSOURCES_PATH
 	std::string str(fileName);
 	std::string delimiter = std::string(RESOURCES_PATH);
@@ -14,13 +33,6 @@ Texture::Texture(char* fileName)
 	char* ch = new char[str.length() + 1];
 	strcpy(ch, str.c_str());
 	filepath = ch;
-
-	load(fileName);
-}
-
-Texture::Texture(GLuint texture)
-{
-	setTexture(texture);
 }
 
 Texture::~Texture()
@@ -32,16 +44,24 @@ void Texture::use(GLenum texturePosition)
 {
 	glActiveTexture(texturePosition);
 	glBindTexture(GL_TEXTURE_2D, m_textureID);
-
-	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	//the filtering & wrapping of the sampler replace the state of the texture on this unit
+	TextureManager::getInstance()->bindSampler(texturePosition - GL_TEXTURE0, m_sampler);
+	m_unit = texturePosition;
 }
 
 void Texture::unUse()
 {
-	glBindTexture(GL_TEXTURE_2D, m_textureID);
+	glBindSampler(m_unit - GL_TEXTURE0, 0);
+}
+
+void Texture::setSampler(TextureSampler sampler)
+{
+	m_sampler = sampler;
+}
+
+TextureSampler Texture::getSampler()
+{
+	return m_sampler;
 }
 
 bool Texture::load(char* fileName)
@@ -50,29 +70,26 @@ bool Texture::load(char* fileName)
 	glGenTextures(1, &m_textureID);
 	glBindTexture(GL_TEXTURE_2D, m_textureID);
 
+	if (loadCooked(fileName))
+	{
+		printf("SUCCESS: Cooked texture image %s loaded\n", filepath);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		m_loaded = true;
+		return true;
+	}
+
 	int bytesPerPixel = 0;
 
+	//stb flips the rows while decoding. Only for this thread, the skybox & terrain images are not flipped
+	stbi_set_flip_vertically_on_load_thread(1);
 	unsigned char* data = stbi_load(fileName, &m_width, &m_heigth, &bytesPerPixel, 0);
-
-	//flip image vertically
-	unsigned char* s = data;
-	for (int y = 0; y<m_heigth / 2; y++)
-	{
-		unsigned char* e = data + (m_heigth - y - 1)*m_width*bytesPerPixel;
-		for (int x = 0; x<m_width*bytesPerPixel; x++)
-		{
-			unsigned char temp = *s;
-			*s = *e;
-			*e = temp;
-			s++;
-			e++;
-		}
-	}
+	stbi_set_flip_vertically_on_load_thread(0);
 
 	//send image data to the new texture
-	if (bytesPerPixel < 3)
+	if (!data || bytesPerPixel < 3)
 	{
 		printf("ERROR: Unable to load texture image %s\n", fileName);
+		stbi_image_free(data);
 		return false;
 	}
 	else if (bytesPerPixel == 3)
@@ -94,8 +111,24 @@ bool Texture::load(char* fileName)
 
 	printf("SUCCESS: Texture image %s loaded\n", filepath);
 
-	unUse();
+	glBindTexture(GL_TEXTURE_2D, 0);
 
+	m_loaded = true;
+	return true;
+}
+
+bool Texture::loadCooked(const char* fileName)
+{
+	//a stale cooked file (the image was changed after the cooking) is ignored
+	CookedTexture cooked;
+	bool isCooked = CookedTexture::isCookedPath(fileName);
+	std::string path = isCooked ? std::string(fileName) : CookedTexture::getCookedPath(fileName);
+	if (!cooked.open(path.c_str(), isCooked ? NULL : fileName))
+		return false;
+
+	cooked.upload();
+	m_width = cooked.getWidth();
+	m_heigth = cooked.getHeight();
 	return true;
 }
 
@@ -112,4 +145,9 @@ unsigned int Texture::getTexture()
 char* Texture::getFilepath()
 {
 	return filepath;
+}
+
+bool Texture::isLoaded()
+{
+	return m_loaded;
 }
\ No newline at end of file
@@ -6,8 +6,21 @@
 
 /*
 To create a Texture use Texture(char* fileName). The file must be in the Ressources Folder.
+Texture(char*) loads synchronously, TextureLoader::load returns a placeholder at once and streams the image in later.
+Both use the cooked file next to the image (see CookedTexture) if it is valid, then nothing is decoded.
+Filtering & wrapping are not set on the texture, use() binds one of the shared sampler objects of the TextureManager.
 */
 
+///The shared sampler objects, see TextureManager::getSampler
+enum TextureSampler
+{
+	SAMPLER_LINEAR_REPEAT,	//linear, without mipmaps
+	SAMPLER_TRILINEAR_REPEAT,	//linear between the mipmaps, the default of the scene textures
+	SAMPLER_LINEAR_CLAMP,
+	SAMPLER_NEAREST_CLAMP,
+	SAMPLER_COUNT
+};
+
 class Texture
 {
 public:
@@ -17,17 +30,35 @@ public:
 
 	bool load(char* fileName);
 	void bind();
+	///Binds the texture & its sampler to the unit
 	void use(GLenum texturePosition);
+	///Unbinds the sampler of the last use
 	void unUse();
 
+	///The sampler bound by use, SAMPLER_LINEAR_REPEAT by default
+	void setSampler(TextureSampler sampler);
+	TextureSampler getSampler();
+
 	void setTexture(GLuint texture);
 	unsigned int getTexture();
 	char* getFilepath();
+	///False while the image is streamed in by the TextureLoader, the texture is a placeholder until then (or if the file could not be loaded)
+	bool isLoaded();
 
 private:
+	friend class TextureLoader;
+
+	///Saves the path without RESOURCES_PATH
+	void setFilepath(const char* fileName);
+	///Uploads the cooked file of the image (or the cooked file itself) into the bound texture, false if there is no valid one
+	bool loadCooked(const char* fileName);
+
 	unsigned int m_textureID;
 	int m_width, m_heigth;
 	char* filepath;
+	bool m_loaded;
+	TextureSampler m_sampler;
+	GLenum m_unit;	//of the last use
 
 protected:
 
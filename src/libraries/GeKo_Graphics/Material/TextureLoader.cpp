@@ -0,0 +1,310 @@
+#include "TextureLoader.h"
+#include <algorithm>
+#include <stb_image.h>
+
+static const int DEFAULT_UPLOAD_BUDGET = 4 * 1024 * 1024;
+static const int MAX_WORKERS = 4;
+
+//a part of an image copied into the pixel buffer by update
+struct TextureStrip
+{
+	TextureJob* job;
+	int firstRow;
+	int rows;
+	GLintptr offset;
+};
+
+TextureLoader::TextureLoader()
+{
+	m_stop = false;
+	m_pending = 0;
+	m_uploadBudget = DEFAULT_UPLOAD_BUDGET;
+	m_pixelBuffer = 0;
+	m_pixelBufferSize = 0;
+}
+
+TextureLoader::~TextureLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_condition.notify_all();
+	for (auto& worker : m_workers)
+		worker.join();
+
+	for (auto job : m_requests)
+		delete job;
+	for (auto job : m_decoded)
+	{
+		stbi_image_free(job->pixels);
+		delete job;
+	}
+	for (auto job : m_uploads)
+	{
+		stbi_image_free(job->pixels);
+		delete job;
+	}
+}
+
+TextureLoader* TextureLoader::getInstance()
+{
+	static TextureLoader instance;
+	return &instance;
+}
+
+Texture* TextureLoader::load(const std::string& path)
+{
+	if (m_workers.empty())
+		startWorkers();
+
+	GLuint handle;
+	glGenTextures(1, &handle);
+	glBindTexture(GL_TEXTURE_2D, handle);
+	Texture* texture = new Texture(handle);
+	texture->setFilepath(path.c_str());
+
+	//a cooked image needs no decoding, its levels are uploaded at once
+	if (texture->loadCooked(path.c_str()))
+	{
+		glBindTexture(GL_TEXTURE_2D, 0);
+		printf("SUCCESS: Cooked texture image %s loaded\n", texture->getFilepath());
+		return texture;
+	}
+
+	//the placeholder, mid grey
+	unsigned char grey[4] = { 128, 128, 128, 255 };
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, grey);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	texture->m_width = 1;
+	texture->m_heigth = 1;
+	texture->m_loaded = false;
+
+	TextureJob* job = new TextureJob();
+	job->texture = texture;
+	job->path = path;
+	m_pending++;
+	m_loading.insert(texture);
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_requests.push_back(job);
+	}
+	m_condition.notify_one();
+	return texture;
+}
+
+void TextureLoader::update()
+{
+	if (m_pending == 0)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_uploads.insert(m_uploads.end(), m_decoded.begin(), m_decoded.end());
+		m_decoded.clear();
+
+		for (auto it = m_uploads.begin(); it != m_uploads.end() && !m_cancelled.empty();)
+		{
+			TextureJob* job = *it;
+			if (!m_cancelled.erase(job->texture))
+			{
+				++it;
+				continue;
+			}
+			stbi_image_free(job->pixels);
+			delete job->texture;
+			delete job;
+			it = m_uploads.erase(it);
+			m_pending--;
+		}
+	}
+
+	//images that could not be decoded keep their placeholder
+	while (!m_uploads.empty() && !m_uploads.front()->pixels)
+	{
+		TextureJob* job = m_uploads.front();
+		printf("ERROR: Unable to load texture image %s\n", job->path.c_str());
+		job->texture->m_loaded = true;
+		m_loading.erase(job->texture);
+		m_uploads.pop_front();
+		delete job;
+		m_pending--;
+	}
+	if (m_uploads.empty())
+		return;
+
+	//the strips of this update, in the order of the requests
+	std::vector<TextureStrip> strips;
+	GLintptr used = 0;
+	for (auto job : m_uploads)
+	{
+		if (!job->pixels)
+			break;
+		int rowBytes = job->width * job->channels;
+		int row = job->uploadedRows;
+		while (row < job->height)
+		{
+			int rows = (int)((m_uploadBudget - used) / rowBytes);
+			if (rows == 0 && used == 0)
+				rows = 1;
+			if (rows == 0)
+				break;
+			rows = std::min(rows, job->height - row);
+
+			TextureStrip strip = { job, row, rows, used };
+			strips.push_back(strip);
+			used += (GLintptr)rows * rowBytes;
+			row += rows;
+		}
+		if (row < job->height)
+			break;
+	}
+
+	//the storage is allocated before the first strip, without a bound pixel buffer.
+	//Until the mipmaps are generated only level 0 exists, the trilinear sampler would sample the incomplete texture as black
+	for (auto& strip : strips)
+	{
+		if (strip.firstRow != 0)
+			continue;
+		GLenum format = getFormat(strip.job->channels);
+		glBindTexture(GL_TEXTURE_2D, strip.job->texture->getTexture());
+		glTexImage2D(GL_TEXTURE_2D, 0, format, strip.job->width, strip.job->height, 0, format, GL_UNSIGNED_BYTE, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+	}
+
+	//the strips are copied into the orphaned pixel buffer, the driver copies them into the textures asynchronously
+	if (!m_pixelBuffer)
+		glGenBuffers(1, &m_pixelBuffer);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pixelBuffer);
+	m_pixelBufferSize = std::max(m_pixelBufferSize, (GLsizeiptr)used);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, m_pixelBufferSize, NULL, GL_STREAM_DRAW);
+	unsigned char* mapped = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, used, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if (!mapped)
+	{
+		printf("ERROR: TextureLoader could not map the pixel buffer\n");
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		return;
+	}
+	for (auto& strip : strips)
+	{
+		size_t rowBytes = strip.job->width * strip.job->channels;
+		memcpy(mapped + strip.offset, strip.job->pixels + strip.firstRow * rowBytes, strip.rows * rowBytes);
+	}
+	glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+	//rows of RGB images are not 4 byte aligned
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	for (auto& strip : strips)
+	{
+		TextureJob* job = strip.job;
+		glBindTexture(GL_TEXTURE_2D, job->texture->getTexture());
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, strip.firstRow, job->width, strip.rows, getFormat(job->channels), GL_UNSIGNED_BYTE, (const void*)strip.offset);
+		job->uploadedRows += strip.rows;
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	//the completed images are at the front
+	while (!m_uploads.empty() && m_uploads.front()->pixels && m_uploads.front()->uploadedRows == m_uploads.front()->height)
+	{
+		TextureJob* job = m_uploads.front();
+		glBindTexture(GL_TEXTURE_2D, job->texture->getTexture());
+		//the default of GL_TEXTURE_MAX_LEVEL, the whole chain
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+		glGenerateMipmap(GL_TEXTURE_2D);
+
+		job->texture->m_width = job->width;
+		job->texture->m_heigth = job->height;
+		job->texture->m_loaded = true;
+		printf("SUCCESS: Texture image %s loaded\n", job->texture->getFilepath());
+		m_loading.erase(job->texture);
+
+		stbi_image_free(job->pixels);
+		m_uploads.pop_front();
+		delete job;
+		m_pending--;
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+bool TextureLoader::cancel(Texture* texture)
+{
+	if (m_loading.erase(texture) == 0)
+		return false;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (auto it = m_requests.begin(); it != m_requests.end(); ++it)
+	{
+		if ((*it)->texture == texture)
+		{
+			delete texture;
+			delete *it;
+			m_requests.erase(it);
+			m_pending--;
+			return true;
+		}
+	}
+	//decoded or being decoded, update deletes it
+	m_cancelled.insert(texture);
+	return true;
+}
+
+void TextureLoader::setUploadBudget(int bytes)
+{
+	m_uploadBudget = std::max(bytes, 1);
+}
+
+int TextureLoader::getUploadBudget()
+{
+	return m_uploadBudget;
+}
+
+int TextureLoader::getPendingCount()
+{
+	return m_pending;
+}
+
+void TextureLoader::startWorkers()
+{
+	//one core is left to the GL thread
+	int count = (int)std::thread::hardware_concurrency() - 1;
+	count = std::min(std::max(count, 1), MAX_WORKERS);
+	for (int i = 0; i < count; i++)
+		m_workers.push_back(std::thread(&TextureLoader::decode, this));
+}
+
+void TextureLoader::decode()
+{
+	//only for the workers, the skybox & terrain images of the other threads are not flipped
+	stbi_set_flip_vertically_on_load_thread(1);
+
+	while (true)
+	{
+		TextureJob* job;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return m_stop || !m_requests.empty(); });
+			if (m_stop)
+				return;
+			job = m_requests.front();
+			m_requests.pop_front();
+		}
+
+		job->pixels = stbi_load(job->path.c_str(), &job->width, &job->height, &job->channels, 0);
+		//like Texture::load, only RGB & RGBA images
+		if (job->pixels && job->channels < 3)
+		{
+			stbi_image_free(job->pixels);
+			job->pixels = NULL;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_decoded.push_back(job);
+	}
+}
+
+GLenum TextureLoader::getFormat(int channels)
+{
+	return (channels == 3) ? GL_RGB : GL_RGBA;
+}
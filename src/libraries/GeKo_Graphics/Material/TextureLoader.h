@@ -0,0 +1,87 @@
+#pragma once
+
+#include <deque>
+#include <set>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <GeKo_Graphics/Material/Texture.h>
+
+///An image requested from the TextureLoader, decoded by a worker & uploaded by update
+struct TextureJob
+{
+	Texture* texture;
+	std::string path;
+	unsigned char* pixels;	//decoded by a worker, NULL if the image could not be loaded
+	int width;
+	int height;
+	int channels;
+	int uploadedRows;
+};
+
+///Loads textures without stalling the frame
+
+/*
+Description: load returns a Texture at once, its OpenGL texture is a 1x1 placeholder until the image arrives.
+A pool of worker threads decodes the files (stb flips the rows while decoding). update, called once per frame on the
+GL thread, streams the decoded images into their textures through a pixel buffer object: at most getUploadBudget() bytes
+per frame, a big image is uploaded in strips of rows over several frames. The mipmaps are generated after the last strip,
+until then the texture is limited to level 0 (GL_TEXTURE_MAX_LEVEL), so it stays complete for mipmapped samplers.
+The OpenGL name of the texture does not change, so it can be used (getTexture) right away.
+
+The Renderer calls update at the beginning of renderScene, programs without the Renderer have to call it themselves.
+When the process ends, the workers are stopped and the decoded images are freed. The pixel buffer stays, there is no context to delete it in.
+*/
+
+class TextureLoader
+{
+public:
+	///The loader of the whole process, the workers are started with the first load
+	static TextureLoader* getInstance();
+
+	///Returns a placeholder texture that gets the image of the file later. Needs the GL context, the caller owns the texture
+	Texture* load(const std::string& path);
+
+	///Uploads decoded images, needs the GL context. Call it once per frame
+	void update();
+
+	///Stops the load of the texture & deletes it, now or when its worker is done. Needs the GL context
+	/**Returns false if the loader has no job for the texture (it was loaded or its image failed), the caller still owns & deletes it*/
+	bool cancel(Texture* texture);
+
+	///Bytes uploaded per update at most, 4 MB by default. At least one row is uploaded per update
+	void setUploadBudget(int bytes);
+	int getUploadBudget();
+
+	///Images requested but not uploaded completely yet
+	int getPendingCount();
+
+private:
+	TextureLoader();
+	~TextureLoader();
+	TextureLoader(const TextureLoader&);
+	TextureLoader& operator=(const TextureLoader&);
+
+	void startWorkers();
+	void decode();
+	///The GL format of an image with channels bytes per pixel
+	GLenum getFormat(int channels);
+
+	std::vector<std::thread> m_workers;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::deque<TextureJob*> m_requests;	//to decode, guarded by m_mutex
+	std::deque<TextureJob*> m_decoded;	//to upload, guarded by m_mutex
+	std::set<Texture*> m_cancelled;	//deleted by update, guarded by m_mutex
+	bool m_stop;
+
+	std::deque<TextureJob*> m_uploads;	//only used by the GL thread
+	std::set<Texture*> m_loading;	//the textures with a job, owned by the loader. Only used by the GL thread
+	std::atomic<int> m_pending;
+	int m_uploadBudget;
+
+	GLuint m_pixelBuffer;
+	GLsizeiptr m_pixelBufferSize;
+};
@@ -0,0 +1,191 @@
+#include "TextureManager.h"
+
+TextureManager::TextureManager()
+{
+	for (int i = 0; i < SAMPLER_COUNT; i++)
+		m_samplers[i] = 0;
+}
+
+TextureManager::~TextureManager()
+{
+}
+
+TextureManager* TextureManager::getInstance()
+{
+	static TextureManager instance;
+	return &instance;
+}
+
+Texture* TextureManager::getTexture(const std::string& path)
+{
+	return acquire(path, false);
+}
+
+Texture* TextureManager::getTextureAsync(const std::string& path)
+{
+	return acquire(path, true);
+}
+
+Texture* TextureManager::acquire(const std::string& path, bool async)
+{
+	std::string key = canonicalPath(path);
+	auto it = m_textures.find(key);
+	if (it != m_textures.end())
+	{
+		it->second.references++;
+		return it->second.texture;
+	}
+
+	Texture* texture;
+	if (async)
+		texture = TextureLoader::getInstance()->load(key);
+	else
+	{
+		std::vector<char> cpath(key.begin(), key.end());
+		cpath.push_back('\0');
+		texture = new Texture(cpath.data());
+	}
+	//the files are loaded with all their mipmaps
+	texture->setSampler(SAMPLER_TRILINEAR_REPEAT);
+
+	TextureEntry entry;
+	entry.texture = texture;
+	entry.references = 1;
+	m_textures[key] = entry;
+	m_paths[texture] = key;
+	return texture;
+}
+
+void TextureManager::release(Texture* texture)
+{
+	auto path = m_paths.find(texture);
+	if (path == m_paths.end())
+	{
+		std::cout << "WARNING: TextureManager::release - the texture is not in the registry" << std::endl;
+		return;
+	}
+
+	auto it = m_textures.find(path->second);
+	if (--it->second.references > 0)
+		return;
+
+	//a texture that is still streamed in is deleted by the TextureLoader
+	if (!TextureLoader::getInstance()->cancel(texture))
+		delete texture;
+	m_textures.erase(it);
+	m_paths.erase(path);
+}
+
+int TextureManager::getReferenceCount(Texture* texture)
+{
+	auto path = m_paths.find(texture);
+	if (path == m_paths.end())
+		return 0;
+	return m_textures[path->second].references;
+}
+
+GLuint TextureManager::getSampler(TextureSampler sampler)
+{
+	if (m_samplers[sampler])
+		return m_samplers[sampler];
+
+	GLint minFilter = GL_LINEAR;
+	GLint magFilter = GL_LINEAR;
+	GLint wrap = GL_REPEAT;
+	switch (sampler)
+	{
+	case SAMPLER_TRILINEAR_REPEAT:
+		minFilter = GL_LINEAR_MIPMAP_LINEAR;
+		break;
+	case SAMPLER_LINEAR_CLAMP:
+		wrap = GL_CLAMP_TO_EDGE;
+		break;
+	case SAMPLER_NEAREST_CLAMP:
+		minFilter = GL_NEAREST;
+		magFilter = GL_NEAREST;
+		wrap = GL_CLAMP_TO_EDGE;
+		break;
+	default:
+		break;
+	}
+
+	GLuint handle;
+	glGenSamplers(1, &handle);
+	glSamplerParameteri(handle, GL_TEXTURE_MIN_FILTER, minFilter);
+	glSamplerParameteri(handle, GL_TEXTURE_MAG_FILTER, magFilter);
+	glSamplerParameteri(handle, GL_TEXTURE_WRAP_S, wrap);
+	glSamplerParameteri(handle, GL_TEXTURE_WRAP_T, wrap);
+	m_samplers[sampler] = handle;
+	return handle;
+}
+
+void TextureManager::bindSampler(GLuint unit, TextureSampler sampler)
+{
+	glBindSampler(unit, getSampler(sampler));
+}
+
+void TextureManager::clear()
+{
+	for (auto& texture : m_textures)
+	{
+		if (!TextureLoader::getInstance()->cancel(texture.second.texture))
+			delete texture.second.texture;
+	}
+	m_textures.clear();
+	m_paths.clear();
+
+	for (int i = 0; i < SAMPLER_COUNT; i++)
+	{
+		if (m_samplers[i])
+			glDeleteSamplers(1, &m_samplers[i]);
+		m_samplers[i] = 0;
+	}
+}
+
+int TextureManager::getTextureCount()
+{
+	return (int)m_textures.size();
+}
+
+std::string TextureManager::canonicalPath(const std::string& path)
+{
+	std::string unified = path;
+	for (auto& c : unified)
+	{
+		if (c == '\\')
+			c = '/';
+	}
+
+	//the parts between the separators, "." is dropped & ".." removes the part before it
+	std::vector<std::string> parts;
+	size_t begin = 0;
+	while (begin <= unified.size())
+	{
+		size_t end = unified.find('/', begin);
+		if (end == std::string::npos)
+			end = unified.size();
+		std::string part = unified.substr(begin, end - begin);
+		if (part == "..")
+		{
+			if (!parts.empty() && !parts.back().empty() && parts.back() != "..")
+				parts.pop_back();
+			else
+				parts.push_back(part);
+		}
+		else if (part != "." && !(part.empty() && !parts.empty()))
+			parts.push_back(part);
+		begin = end + 1;
+	}
+
+	std::string canonical;
+	for (size_t i = 0; i < parts.size(); i++)
+	{
+		if (i > 0)
+			canonical += '/';
+		canonical += parts[i];
+	}
+	//an absolute path keeps its leading separator
+	if (parts.size() == 1 && parts[0].empty())
+		canonical = "/";
+	return canonical;
+}
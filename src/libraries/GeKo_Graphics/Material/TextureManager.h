@@ -0,0 +1,62 @@
+#pragma once
+
+#include <map>
+#include <GeKo_Graphics/Material/TextureLoader.h>
+
+///Registry of the loaded textures & the shared sampler objects, shared by the whole process
+
+/*
+The textures are keyed by their canonical file path ("a/./b/../c.png" and "a\c.png" are "a/c.png"), every file gets
+decoded and uploaded only once. Use TextureManager::getInstance()->getTexture(path) instead of new Texture(path).
+Every getTexture counts a reference, release gives it back and the last release deletes the texture.
+The TextureManager owns the textures, don't delete them. Textures & samplers are only deleted by release & clear(),
+never by the destructor of the instance (the GL context is gone at that point).
+
+The samplers hold filtering & wrapping (TextureSampler), a few sampler objects are shared by all textures
+and bound per texture unit, so no glTexParameter calls are needed when a texture is bound.
+The textures of getTexture & getTextureAsync use SAMPLER_TRILINEAR_REPEAT, Texture::setSampler changes it.
+*/
+
+class TextureManager
+{
+public:
+	TextureManager();
+	~TextureManager();
+
+	///The cache of the whole process
+	static TextureManager* getInstance();
+
+	///Returns the texture of the file, it is loaded with the first request. The path is the full path, like for Texture(char*)
+	Texture* getTexture(const std::string& path);
+	///Like getTexture, but a new texture is a placeholder until the TextureLoader streamed it in
+	Texture* getTextureAsync(const std::string& path);
+	///Gives back a reference of getTexture, the texture is deleted with the last one (needs the GL context then)
+	void release(Texture* texture);
+	int getReferenceCount(Texture* texture);
+
+	///Returns the sampler object, it is created with the first request (needs the GL context)
+	GLuint getSampler(TextureSampler sampler);
+	///Binds the sampler object to the texture unit (0, 1, ...)
+	void bindSampler(GLuint unit, TextureSampler sampler);
+
+	///Deletes all textures & samplers, needs the GL context. Pointers of getTexture are invalid afterwards
+	void clear();
+
+	int getTextureCount();
+
+	///Unifies the separators and removes "." & ".." parts, so different spellings of a file share one texture
+	static std::string canonicalPath(const std::string& path);
+
+private:
+	struct TextureEntry
+	{
+		Texture* texture;
+		int references;
+	};
+
+	Texture* acquire(const std::string& path, bool async);
+
+	std::map<std::string, TextureEntry> m_textures;
+	std::map<Texture*, std::string> m_paths;
+	GLuint m_samplers[SAMPLER_COUNT];
+};
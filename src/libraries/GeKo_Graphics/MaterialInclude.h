@@ -1,2 +1,4 @@
 #pragma once 
-#include <GeKo_Graphics/Material/Texture.h>
\ No newline at end of file
+#include <GeKo_Graphics/Material/Texture.h>
+#include <GeKo_Graphics/Material/TextureLoader.h>
+#include <GeKo_Graphics/Material/CookedTexture.h>
\ No newline at end of file
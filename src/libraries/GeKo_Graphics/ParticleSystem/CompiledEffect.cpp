@@ -0,0 +1,358 @@
+#include "CompiledEffect.h"
+#include "GeKo_Graphics/MappedFile.h"
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+static const uint32_t COMPILED_EFFECT_MAGIC = 0x58464B47;	//"GKFX"
+static const uint32_t COMPILED_EFFECT_VERSION = 2;
+static const int MAX_TEXTURES = 4;
+static const int MAX_SCALING_DATA = 32;
+
+enum CompiledEmitterFlags
+{
+	FLAG_PARTICLE_MORTAL = 1 << 0,
+	FLAG_GEOMETRY_SHADER = 1 << 1,
+	FLAG_MOVABLE = 1 << 2,
+	FLAG_AREA_XY = 1 << 3,
+	FLAG_AREA_XZ = 1 << 4,
+	FLAG_USE_TEXTURE = 1 << 5,
+	FLAG_USE_SCALING = 1 << 6,
+	FLAG_ROTATE_LEFT = 1 << 7,
+	FLAG_LOCAL_COORDINATES = 1 << 8,
+	FLAG_MOVEMENT_VERTICAL = 1 << 9,
+	FLAG_MOVEMENT_HORIZONTAL_X = 1 << 10,
+	FLAG_MOVEMENT_HORIZONTAL_Z = 1 << 11,
+	FLAG_DEPTH_SORT = 1 << 12
+};
+
+enum CompiledEmitterPhysic
+{
+	PHYSIC_NONE = -1,
+	PHYSIC_TRAJECTORY = 0,
+	PHYSIC_DIRECTION_GRAVITY = 1,
+	PHYSIC_POINT_GRAVITY = 2,
+	PHYSIC_SWARM_CIRCLE_MOTION = 3
+};
+
+struct CompiledEffectHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t recordSize;
+	uint32_t emitterCount;
+	uint32_t stringTableSize;
+	uint32_t checksum;		//of the records & the string table
+	int64_t sourceSize;		//of the XML file
+	int64_t sourceTime;
+};
+
+struct CompiledEmitterRecord
+{
+	//constructor
+	int32_t outputType;
+	float position[3];
+	double emitterLifetime;
+	double emitFrequency;
+	int32_t particlesPerEmit;
+	float particleLifetime;
+
+	double startTime;
+	uint32_t flags;
+	int32_t velocityType;
+
+	//physic
+	int32_t physic;
+	float gravity[4];	//the point for PointGravity
+	float speed;
+	float gravityImpact;
+	float gravityRange;
+	int32_t gravityFunction;
+
+	//area emitting
+	float areaSize;
+	int32_t areaAccuracy;
+
+	//look
+	int32_t textureCount;
+	uint32_t textureName[MAX_TEXTURES];	//offsets into the string table
+	float textureTime[MAX_TEXTURES];
+	int32_t scalingCount;
+	float scalingData[MAX_SCALING_DATA];
+	float particleSize;
+	float birthTime;
+	float deathTime;
+	float blendingTime;
+	float rotationSpeed;
+};
+
+//FNV-1a
+static uint32_t computeChecksum(const unsigned char* data, size_t size)
+{
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= data[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+//size & modification time of the XML file, false if it doesn't exist
+static bool getSourceStamp(const char* xmlPath, int64_t& size, int64_t& time)
+{
+	struct stat fileStat;
+	if (stat(xmlPath, &fileStat) != 0)
+		return false;
+	size = (int64_t)fileStat.st_size;
+	time = (int64_t)fileStat.st_mtime;
+	return true;
+}
+
+std::string CompiledEffect::getCompiledPath(const char* xmlPath)
+{
+	std::string path(xmlPath);
+	size_t dot = path.find_last_of('.');
+	size_t slash = path.find_last_of("/\\");
+	if (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+		path = path.substr(0, dot);
+	return path + ".gkfx";
+}
+
+bool CompiledEffect::write(const char* path, const char* xmlPath, std::vector<Emitter*>& emitters)
+{
+	CompiledEffectHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = COMPILED_EFFECT_MAGIC;
+	header.version = COMPILED_EFFECT_VERSION;
+	header.recordSize = sizeof(CompiledEmitterRecord);
+	header.emitterCount = (uint32_t)emitters.size();
+	getSourceStamp(xmlPath, header.sourceSize, header.sourceTime);
+
+	std::vector<unsigned char> body(emitters.size() * sizeof(CompiledEmitterRecord));
+	std::string strings;
+
+	for (size_t i = 0; i < emitters.size(); i++)
+	{
+		Emitter* emitter = emitters[i];
+		CompiledEmitterRecord record;
+		memset(&record, 0, sizeof(record));
+
+		record.outputType = emitter->getOutputType();
+		glm::vec3 position = emitter->getLocalPosition();
+		record.position[0] = position.x;
+		record.position[1] = position.y;
+		record.position[2] = position.z;
+		record.emitterLifetime = emitter->getEmitterLifetime();
+		record.emitFrequency = emitter->getEmitFrequency();
+		record.particlesPerEmit = emitter->getParticlesPerEmit();
+		record.particleLifetime = emitter->getParticleLifetime();
+		record.startTime = emitter->getStartTime();
+		record.velocityType = emitter->getVelocityType();
+
+		if (emitter->getParticleMortality()) record.flags |= FLAG_PARTICLE_MORTAL;
+		if (emitter->getUseGeometryShader()) record.flags |= FLAG_GEOMETRY_SHADER;
+		if (emitter->getMovable()) record.flags |= FLAG_MOVABLE;
+		if (emitter->getAreaEmittingXY()) record.flags |= FLAG_AREA_XY;
+		if (emitter->getAreaEmittingXZ()) record.flags |= FLAG_AREA_XZ;
+		if (emitter->getUseTexture()) record.flags |= FLAG_USE_TEXTURE;
+		if (emitter->getTexUseScaling()) record.flags |= FLAG_USE_SCALING;
+		if (emitter->getTexRotateLeft()) record.flags |= FLAG_ROTATE_LEFT;
+		if (emitter->getPhysicAttUseLocalCoordinates()) record.flags |= FLAG_LOCAL_COORDINATES;
+		if (emitter->getPhysicAttMovementVertical()) record.flags |= FLAG_MOVEMENT_VERTICAL;
+		if (emitter->getPhysicAttMovementHorizontalX()) record.flags |= FLAG_MOVEMENT_HORIZONTAL_X;
+		if (emitter->getPhysicAttMovementHorizontalZ()) record.flags |= FLAG_MOVEMENT_HORIZONTAL_Z;
+		if (emitter->getDepthSort()) record.flags |= FLAG_DEPTH_SORT;
+
+		//the same order as in Effect::saveEffect
+		if (emitter->getPhysicTrajectory()) record.physic = PHYSIC_TRAJECTORY;
+		else if (emitter->getPhysicDirectionGravity()) record.physic = PHYSIC_DIRECTION_GRAVITY;
+		else if (emitter->getPhysicPointGravity()) record.physic = PHYSIC_POINT_GRAVITY;
+		else if (emitter->getPhysicSwarmCircleMotion()) record.physic = PHYSIC_SWARM_CIRCLE_MOTION;
+		else record.physic = PHYSIC_NONE;
+
+		glm::vec4 gravity = emitter->getGravity();
+		record.gravity[0] = gravity.x;
+		record.gravity[1] = gravity.y;
+		record.gravity[2] = gravity.z;
+		record.gravity[3] = gravity.w;
+		record.speed = emitter->getSpeed();
+		record.gravityImpact = emitter->getPhysicAttGravityImpact();
+		record.gravityRange = emitter->getPhysicAttGravityRange();
+		record.gravityFunction = emitter->getPhysicAttGravityFunction();
+
+		record.areaSize = emitter->getAreaSize();
+		record.areaAccuracy = emitter->getAreaAccuracy();
+
+		int textureCount = 0;
+		for (auto texture : emitter->m_textureList)
+		{
+			if (textureCount == MAX_TEXTURES)
+				break;
+			record.textureName[textureCount] = (uint32_t)strings.size();
+			record.textureTime[textureCount] = emitter->blendingTime[textureCount];
+			strings += texture->getFilepath();
+			strings += '\0';
+			textureCount++;
+		}
+		record.textureCount = textureCount;
+
+		record.scalingCount = emitter->getTexScalingCount();
+		if (record.scalingCount < 0 || record.scalingCount > MAX_SCALING_DATA)
+			record.scalingCount = 0;
+		for (int k = 0; k < record.scalingCount; k++)
+			record.scalingData[k] = emitter->m_scalingData[k];
+		record.particleSize = emitter->getTexParticleDefaultSize();
+		record.birthTime = emitter->getTexBirthTime();
+		record.deathTime = emitter->getTexDeathTime();
+		record.blendingTime = emitter->getTexBlendingTime();
+		record.rotationSpeed = emitter->getRotationSpeed();
+
+		memcpy(&body[i * sizeof(CompiledEmitterRecord)], &record, sizeof(record));
+	}
+
+	body.insert(body.end(), strings.begin(), strings.end());
+	header.stringTableSize = (uint32_t)strings.size();
+	header.checksum = computeChecksum(body.data(), body.size());
+
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr)
+		return false;
+	bool success = fwrite(&header, sizeof(header), 1, file) == 1;
+	if (!body.empty())
+		success = success && fwrite(body.data(), body.size(), 1, file) == 1;
+	success = (fclose(file) == 0) && success;
+
+	//a broken file would be rejected by the checksum anyway, but don't leave it behind
+	if (!success)
+		remove(path);
+	return success;
+}
+
+static bool validate(const CompiledEmitterRecord& record, uint32_t stringTableSize)
+{
+	if (record.textureCount < 0 || record.textureCount > MAX_TEXTURES)
+		return false;
+	for (int k = 0; k < record.textureCount; k++)
+	{
+		if (record.textureName[k] >= stringTableSize)
+			return false;
+	}
+	if (record.scalingCount < 0 || record.scalingCount > MAX_SCALING_DATA || record.scalingCount % 2 != 0)
+		return false;
+	if (record.physic < PHYSIC_NONE || record.physic > PHYSIC_SWARM_CIRCLE_MOTION)
+		return false;
+	if (record.velocityType < 0 || record.particlesPerEmit < 0)
+		return false;
+	return true;
+}
+
+static Emitter* createEmitter(const CompiledEmitterRecord& record, const char* strings)
+{
+	//the same calls in the same order as Effect::loadEffect
+	Emitter* emitter = new Emitter(record.outputType, glm::vec3(record.position[0], record.position[1], record.position[2]),
+		record.emitterLifetime, record.emitFrequency, record.particlesPerEmit, record.particleLifetime, (record.flags & FLAG_PARTICLE_MORTAL) != 0);
+
+	if (record.flags & FLAG_GEOMETRY_SHADER) emitter->switchToGeometryShader();
+	if (record.flags & FLAG_MOVABLE) emitter->setMovable(true);
+	if (record.flags & FLAG_DEPTH_SORT) emitter->setDepthSort(true);
+	emitter->setStartTime(record.startTime);
+	emitter->setVelocity(record.velocityType);
+
+	glm::vec4 gravity(record.gravity[0], record.gravity[1], record.gravity[2], record.gravity[3]);
+	switch (record.physic)
+	{
+	case PHYSIC_TRAJECTORY:
+		emitter->usePhysicTrajectory(gravity, record.speed);
+		break;
+	case PHYSIC_DIRECTION_GRAVITY:
+		emitter->usePhysicDirectionGravity(gravity, record.speed);
+		break;
+	case PHYSIC_POINT_GRAVITY:
+		emitter->usePhysicPointGravity(glm::vec3(gravity.x, gravity.y, gravity.z), record.gravityImpact, record.gravityRange, record.gravityFunction,
+			record.speed, (record.flags & FLAG_LOCAL_COORDINATES) != 0);
+		break;
+	case PHYSIC_SWARM_CIRCLE_MOTION:
+		emitter->usePhysicSwarmCircleMotion((record.flags & FLAG_MOVEMENT_VERTICAL) != 0, (record.flags & FLAG_MOVEMENT_HORIZONTAL_X) != 0,
+			(record.flags & FLAG_MOVEMENT_HORIZONTAL_Z) != 0, record.speed);
+		break;
+	}
+
+	if (record.flags & (FLAG_AREA_XY | FLAG_AREA_XZ))
+		emitter->setAreaEmitting((record.flags & FLAG_AREA_XY) != 0, (record.flags & FLAG_AREA_XZ) != 0, record.areaSize, record.areaAccuracy);
+
+	for (int k = 0; k < record.textureCount; k++)
+	{
+		std::string spath = RESOURCES_PATH + std::string(strings + record.textureName[k]);
+		emitter->addTexture(spath, record.textureTime[k]);
+	}
+
+	bool useTexture = (record.flags & FLAG_USE_TEXTURE) != 0;
+	bool rotateLeft = (record.flags & FLAG_ROTATE_LEFT) != 0;
+	if (record.flags & FLAG_USE_SCALING)
+	{
+		std::vector<float> scalingSize;
+		std::vector<float> scalingMoment;
+		for (int k = 0; k < record.scalingCount; k = k + 2)
+		{
+			scalingMoment.push_back(record.scalingData[k]);
+			scalingSize.push_back(record.scalingData[k + 1]);
+		}
+		emitter->defineLook(useTexture, scalingSize, scalingMoment,
+			record.birthTime, record.deathTime, record.blendingTime, rotateLeft, record.rotationSpeed);
+	}
+	else
+	{
+		emitter->defineLook(useTexture, record.particleSize,
+			record.birthTime, record.deathTime, record.blendingTime, rotateLeft, record.rotationSpeed);
+	}
+
+	return emitter;
+}
+
+bool CompiledEffect::read(const char* path, const char* xmlPath, std::vector<Emitter*>& emitters)
+{
+	MappedFile file;
+	if (!file.open(path))
+		return false;
+	if (file.getSize() < sizeof(CompiledEffectHeader))
+		return false;
+
+	CompiledEffectHeader header;
+	memcpy(&header, file.getData(), sizeof(header));
+	if (header.magic != COMPILED_EFFECT_MAGIC || header.version != COMPILED_EFFECT_VERSION
+		|| header.recordSize != sizeof(CompiledEmitterRecord))
+		return false;
+
+	//a changed XML file has to be compiled again. Without the XML file the compiled file is used as it is
+	int64_t sourceSize, sourceTime;
+	if (getSourceStamp(xmlPath, sourceSize, sourceTime) && (sourceSize != header.sourceSize || sourceTime != header.sourceTime))
+		return false;
+
+	uint64_t bodySize = (uint64_t)header.emitterCount * sizeof(CompiledEmitterRecord) + header.stringTableSize;
+	if (file.getSize() - sizeof(CompiledEffectHeader) != bodySize)
+		return false;
+
+	const unsigned char* body = file.getData() + sizeof(CompiledEffectHeader);
+	if (computeChecksum(body, (size_t)bodySize) != header.checksum)
+		return false;
+
+	const char* strings = (const char*)body + header.emitterCount * sizeof(CompiledEmitterRecord);
+	if (header.stringTableSize > 0 && strings[header.stringTableSize - 1] != '\0')
+		return false;
+
+	std::vector<CompiledEmitterRecord> records(header.emitterCount);
+	if (header.emitterCount > 0)
+		memcpy(records.data(), body, header.emitterCount * sizeof(CompiledEmitterRecord));
+	for (auto& record : records)
+	{
+		if (!validate(record, header.stringTableSize))
+			return false;
+	}
+
+	for (auto& record : records)
+		emitters.push_back(createEmitter(record, strings));
+	return true;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "GeKo_Graphics/ParticleSystem/Emitter.h"
+
+///Binary version of an effect XML file
+/*
+Description: The XML files stay the authoring format. Effect::loadEffect writes a compiled file next to the XML file with the first load
+and uses it for every further load, until the XML file changes (size & modification time are stored in the compiled file).
+
+File layout (version 2):
+-header: magic "GKFX", version, record size, number of emitters, size of the string table, size & time of the XML file, checksum
+-one fixed size record per emitter: constructor values, physic, area emitting, scaling table, look & texture references
+-string table: the texture paths (relative to RESOURCES_PATH), null-terminated
+
+The file is mapped with MappedFile. It is only used, if the header, the sizes, all counts & string offsets and the checksum are valid.
+The records use the memory layout of the compiler, the version & record size reject files of other builds.
+*/
+
+class CompiledEffect
+{
+public:
+	///"Effect_Fire.xml" -> "Effect_Fire.gkfx"
+	static std::string getCompiledPath(const char* xmlPath);
+
+	///Writes the emitters into a compiled file, returns false if the file can't be written
+	static bool write(const char* path, const char* xmlPath, std::vector<Emitter*>& emitters);
+
+	///Creates the emitters of a compiled file and appends them, returns false (and appends nothing) if the file is missing, stale or invalid
+	static bool read(const char* path, const char* xmlPath, std::vector<Emitter*>& emitters);
+};
@@ -1,13 +1,20 @@
 #include "Effect.h"
+#include <algorithm>
 
 using namespace tinyxml2;
 
+//the shaders get compiled with the first update or render, so an Effect can be loaded without a GL context
 Effect::Effect()
 {
 	emitterVec.clear();
 	notStartedEmitters.clear();
 	m_isStarted = false;
-	setShader();
+	m_visible = true;
+	m_simulated = true;
+	emitterShader = nullptr;
+	emitterShaderGeom = nullptr;
+	compute = nullptr;
+	sortCompute = nullptr;
 }
 
 
@@ -16,32 +23,28 @@ Effect::Effect(const char*filepath)
 	emitterVec.clear();
 	notStartedEmitters.clear();
 	m_isStarted = false;
-	setShader();
+	m_visible = true;
+	m_simulated = true;
+	emitterShader = nullptr;
+	emitterShaderGeom = nullptr;
+	compute = nullptr;
+	sortCompute = nullptr;
 	loadEffect(filepath);
 }
 
+//the shaders belong to the ShaderManager. Only the emitters of loadEffect belong to the Effect, added emitters belong to the caller
 Effect::~Effect()
 {
-	glDeleteShader(emitterShader->handle);
-	glDeleteProgram(emitterShader->handle);
-	delete emitterShader;
-
-	glDeleteShader(emitterShaderGeom->handle);
-	glDeleteProgram(emitterShaderGeom->handle);
-	delete emitterShader;
-
-	glDeleteShader(compute->handle);
-	glDeleteProgram(compute->handle);
-	delete emitterShader;
-
-	emitterVec.~vector();
+	for (auto emitter : m_loadedEmitters){
+		delete emitter;
+	}
 }
 
 
 void Effect::start(){
 	if (!m_isStarted) {
 		m_isStarted = true;
-		m_startTime = glfwGetTime();
+		m_startTime = Emitter::getTime();
 		for (auto emitter : emitterVec){
 			if (emitter->getStartTime() == 0.0) {
 				emitter->start();
@@ -68,14 +71,34 @@ void Effect::addEmitter(Emitter* emitter)
 
 void Effect::removeEmitter(int arrayPosition)
 {
+	//a removed loaded emitter belongs to the caller now
+	Emitter* emitter = emitterVec.at(arrayPosition);
+	m_loadedEmitters.erase(std::remove(m_loadedEmitters.begin(), m_loadedEmitters.end(), emitter), m_loadedEmitters.end());
 	emitterVec.erase(emitterVec.begin() + arrayPosition);
 }
 
 void Effect::updateEmitters(Camera &cam)
+{
+	startDelayedEmitters();
+
+	//this cannot be in startDelayedEmitters because there may be living particles when the ParticleSystem gets stopped.
+	for (auto emitter : emitterVec) {
+		if (compute == nullptr && !emitter->getUseCPUSimulation())
+			setShader();
+		if (emitter->getMovable()) {
+			emitter->update(compute, glm::vec3(cam.getPosition().x, cam.getPosition().y, cam.getPosition().z));
+		}
+		else {
+			emitter->update(compute);
+		}
+	}
+}
+
+void Effect::startDelayedEmitters()
 {
 	//start remaining emitters if their startTime is lower than the passed time
 	if (m_isStarted) {
-		double timePassed = glfwGetTime() - m_startTime;
+		double timePassed = Emitter::getTime() - m_startTime;
 		int i = 0;
 		std::vector<int> toDelete;
 		for (auto emitter : notStartedEmitters) {
@@ -93,21 +116,22 @@ void Effect::updateEmitters(Camera &cam)
 		}
 
 	}
+}
 
-	//this cannot be in the block above because there may be living particles when the ParticleSystem gets stopped.
-	for (auto emitter : emitterVec) {
-		if (emitter->getMovable()) {
-			emitter->update(compute, glm::vec3(cam.getPosition().x, cam.getPosition().y, cam.getPosition().z));
-		}
-		else {
-			emitter->update(compute);
-		}
-	}
+std::vector<Emitter*>* Effect::getEmitters()
+{
+	return &emitterVec;
 }
 
 void Effect::renderEmitters(Camera &cam)
 {
+	if (emitterShader == nullptr && !emitterVec.empty())
+		setShader();
+
 	for (auto emitter : emitterVec){
+		if (emitter->getDepthSort())
+			emitter->sortParticles(sortCompute, cam);
+
 		if (emitter->getUseGeometryShader()){
 			emitter->render(emitterShaderGeom, cam);
 		}
@@ -131,27 +155,148 @@ void Effect::setPosition(glm::vec3 newPosition)
 	}
 }
 
+void Effect::useCPUSimulation(bool on, int threadCount)
+{
+	for (auto emitter : emitterVec){
+		emitter->useCPUSimulation(on, threadCount);
+	}
+}
+
+void Effect::loadBuffers()
+{
+	for (auto emitter : emitterVec){
+		if (!emitter->getBuffersLoaded())
+			emitter->loadBuffer();
+	}
+}
+
+void Effect::clearParticles()
+{
+	for (auto emitter : emitterVec){
+		emitter->clearParticles();
+	}
+}
+
+bool Effect::isFinished()
+{
+	if (!notStartedEmitters.empty())
+		return false;
+	for (auto emitter : emitterVec){
+		if (!emitter->isFinished())
+			return false;
+	}
+	return true;
+}
+
+bool Effect::getBoundingSphere(glm::vec3 &center, float &radius)
+{
+	if (emitterVec.empty())
+		return false;
+
+	//the box around the spheres of the emitters
+	glm::vec3 boxMin, boxMax;
+	for (int i = 0; i < (int)emitterVec.size(); i++){
+		float emitterRadius = emitterVec[i]->getBoundingRadius();
+		if (emitterRadius < 0.0f)
+			return false;
+		glm::vec3 position = emitterVec[i]->getPosition();
+		glm::vec3 extent(emitterRadius, emitterRadius, emitterRadius);
+		if (i == 0){
+			boxMin = position - extent;
+			boxMax = position + extent;
+		}
+		else{
+			boxMin = glm::min(boxMin, position - extent);
+			boxMax = glm::max(boxMax, position + extent);
+		}
+	}
+
+	center = (boxMin + boxMax) * 0.5f;
+	radius = glm::length(boxMax - center);
+	return true;
+}
+
+void Effect::setLOD(float emissionScale, float sizeScale)
+{
+	for (auto emitter : emitterVec){
+		emitter->setLOD(emissionScale, sizeScale);
+	}
+}
+
+void Effect::setVisible(bool visible)
+{
+	m_visible = visible;
+}
+
+bool Effect::isVisible()
+{
+	return m_visible;
+}
+
+void Effect::setSimulated(bool simulated)
+{
+	m_simulated = simulated;
+}
+
+bool Effect::isSimulated()
+{
+	return m_simulated;
+}
+
 void Effect::setShader(){
+	//the programs are shared by all effects, only the first effect compiles them
+	ShaderManager* shaderManager = ShaderManager::getInstance();
+
 	//Point Sprites shader
-	VertexShader vsParticle(loadShaderSource(SHADERS_PATH + std::string("/ParticleSystem/ParticleSystemPointSprites.vert")));
-	FragmentShader fsParticle(loadShaderSource(SHADERS_PATH + std::string("/ParticleSystem/ParticleSystemPointSprites.frag")));
-	emitterShader = new ShaderProgram(vsParticle, fsParticle);
-	//glDeleteShader(emitterShader->handle);
+	emitterShader = shaderManager->getProgram("/ParticleSystem/ParticleSystemPointSprites.vert", "/ParticleSystem/ParticleSystemPointSprites.frag");
 
 	//...with Geometry Shader
-	VertexShader vsParticleGeom(loadShaderSource(SHADERS_PATH + std::string("/ParticleSystem/ParticleSystemGeometryShader.vert")));
-	GeometryShader gsParticleGeom(loadShaderSource(SHADERS_PATH + std::string("/ParticleSystem/ParticleSystemGeometryShader.geom")));
-	FragmentShader fsParticleGeom(loadShaderSource(SHADERS_PATH + std::string("/ParticleSystem/ParticleSystemGeometryShader.frag")));
-	emitterShaderGeom = new ShaderProgram(vsParticleGeom, gsParticleGeom, fsParticleGeom);
-	//glDeleteShader(emitterShader->handle);
+	emitterShaderGeom = shaderManager->getProgram("/ParticleSystem/ParticleSystemGeometryShader.vert",
+		"/ParticleSystem/ParticleSystemGeometryShader.geom", "/ParticleSystem/ParticleSystemGeometryShader.frag");
 
 	//our default compute shader
-	ComputeShader csParticle(loadShaderSource(SHADERS_PATH + std::string("/ParticleSystem/ParticleSystem.comp")));
-	compute = new ShaderProgram(csParticle);
-	//glDeleteShader(compute->handle);
+	compute = shaderManager->getComputeProgram("/ParticleSystem/ParticleSystem.comp");
+
+	//sorts the particles of emitters with depth sort
+	sortCompute = shaderManager->getComputeProgram("/ParticleSystem/ParticleSystemSort.comp");
 }
 
 int Effect::loadEffect(const char* filepath)
+{
+	//the XML file gets parsed only once, every further load maps the compiled file
+	std::string compiledPath = CompiledEffect::getCompiledPath(filepath);
+	size_t first = emitterVec.size();
+	if (CompiledEffect::read(compiledPath.c_str(), filepath, emitterVec))
+	{
+		m_loadedEmitters.insert(m_loadedEmitters.end(), emitterVec.begin() + first, emitterVec.end());
+		printf("EFFECT: loading compiled Effect successfully\n");
+		return XML_SUCCESS;
+	}
+
+	int result = loadEffectXML(filepath);
+	m_loadedEmitters.insert(m_loadedEmitters.end(), emitterVec.begin() + first, emitterVec.end());
+	if (result == XML_SUCCESS)
+	{
+		//only the emitters of this file, the Effect may have had emitters before
+		std::vector<Emitter*> loaded(emitterVec.begin() + first, emitterVec.end());
+		if (!CompiledEffect::write(compiledPath.c_str(), filepath, loaded))
+			printf("WARNING: could not write the compiled Effect %s\n", compiledPath.c_str());
+	}
+	return result;
+}
+
+int Effect::compileEffect(const char* filepath)
+{
+	std::string compiledPath = CompiledEffect::getCompiledPath(filepath);
+	if (!CompiledEffect::write(compiledPath.c_str(), filepath, emitterVec))
+	{
+		printf("WARNING: could not write the compiled Effect %s\n", compiledPath.c_str());
+		return XML_ERROR_FILE_COULD_NOT_BE_OPENED;
+	}
+	return XML_SUCCESS;
+}
+
+int Effect::loadEffectXML(const char* filepath)
 {
 	//load file
 	XMLDocument doc;
@@ -234,6 +379,15 @@ int Effect::loadEffect(const char* filepath)
 			if (mov) emitter->setMovable(mov);
 		}
 
+		//Depth sort
+		item = emitterNode->FirstChildElement("DepthSort");
+		if (item != nullptr){
+			bool sort;
+			error = item->QueryBoolText(&sort);
+			XMLCheckResult(error);
+			emitter->setDepthSort(sort);
+		}
+
 		//Start time
 		item = emitterNode->FirstChildElement("StartTime");
 		if (item != nullptr){
@@ -413,16 +567,13 @@ int Effect::loadEffect(const char* filepath)
 			while (tex != nullptr){
 				std::string filepath = tex->GetText();
 				std::string spath = RESOURCES_PATH + filepath;
-				char* cpath = new char[spath.length() + 1];
-				strcpy(cpath, spath.c_str());
 
-				Texture* texture = new Texture(cpath);
-				
 				float time;
 				error = tex->QueryFloatAttribute("time", &time);
 				XMLCheckResult(error);
-				
-				emitter->addTexture(texture, time);
+
+				//the same file is only loaded once for all effects, the emitter releases it
+				emitter->addTexture(spath, time);
 
 				tex = tex->NextSiblingElement("Tex");
 			}
@@ -596,6 +747,11 @@ int Effect::saveEffect(char* filepath)
 		element->SetText(emitter->getMovable());
 		emitterNode->InsertEndChild(element);
 
+		//Depth sort
+		element = doc.NewElement("DepthSort");
+		element->SetText(emitter->getDepthSort());
+		emitterNode->InsertEndChild(element);
+
 		//Start time
 		element = doc.NewElement("StartTime");
 		element->SetText(emitter->getStartTime());
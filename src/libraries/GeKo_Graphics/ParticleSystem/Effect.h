@@ -1,5 +1,8 @@
 #pragma once
 #include "GeKo_Graphics/ParticleSystem/Emitter.h"
+#include "GeKo_Graphics/ParticleSystem/CompiledEffect.h"
+#include "GeKo_Graphics/Shader/ShaderManager.h"
+#include "GeKo_Graphics/Material/TextureManager.h"
 #include "tinyxml2.h"
 
 /*
@@ -9,7 +12,7 @@ class Effect{
 public:
 	Effect();	//creates an Effect with no Emitters
 	Effect(const char* filepath);	//creates an Effect loaded from a XML file
-	~Effect(); //deletes the Effect
+	~Effect(); //deletes the Effect and the Emitters it loaded
 
 	void start();
 	void stop();
@@ -19,26 +22,48 @@ public:
 
 	void updateEmitters(Camera &cam);	//compute Shader
 	void renderEmitters(Camera &cam);	//render Shader
+	void startDelayedEmitters();	//starts the Emitters whose start time has passed, part of updateEmitters
+	std::vector<Emitter*>* getEmitters();
 
-	int loadEffect(const char* filepath);	//load an effect from an XML file and replace the current Effect
+	int loadEffect(const char* filepath);	//load an effect from an XML file and replace the current Effect. Uses the compiled file (CompiledEffect) if it is up to date
+	int compileEffect(const char* filepath);	//write the compiled file of this effect, filepath is the XML file it was loaded from
 	int saveEffect(char* filepath);		//save the settings of this effect to a XML file
 
 	void setPosition(glm::vec3 newPosition);	//updates the positions of every Emitter
+	void useCPUSimulation(bool on, int threadCount = 1);	//switches every Emitter to the CPU or compute shader simulation
+
+	void loadBuffers();		//creates the buffers of every Emitter now instead of with the first update, needs the GL context
+	void clearParticles();	//kills the particles of every Emitter
+	bool isFinished();		//true if every Emitter is finished (see Emitter::isFinished) and no Emitter waits for its start time
+
+	bool getBoundingSphere(glm::vec3 &center, float &radius);	//the sphere around all particles, false if an Emitter is unbounded (see Emitter::getBoundingRadius)
+	void setLOD(float emissionScale, float sizeScale);	//level of detail of every Emitter, see Emitter::setLOD
+	void setVisible(bool visible);		//set by the ParticleSystem LOD, invisible effects are not drawn by the ParticleBatch
+	bool isVisible();
+	void setSimulated(bool simulated);	//set by the ParticleSystem LOD, the ParticleBatch skips the update of not simulated effects
+	bool isSimulated();
 
 private:
-	void setShader(); //for the constructor
+	void setShader(); //compiles the shaders, called with the first update or render
+	int loadEffectXML(const char* filepath);	//parses the XML file
 
 	std::vector<Emitter*> emitterVec;	//contains all Emitters of the Effect
+	std::vector<Emitter*> m_loadedEmitters;	//created by loadEffect, deleted with the Effect
 	
 	//for starting emitters at different moments
 	bool m_isStarted;
 	double m_startTime;
 	std::vector<Emitter*> notStartedEmitters;
 
-	//Our Vertex, Fragment & Compute Shader
+	//level of detail, see ParticleSystem::updateLOD
+	bool m_visible;
+	bool m_simulated;
+
+	//Our Vertex, Fragment & Compute Shader, shared by all effects (ShaderManager)
 	ShaderProgram *emitterShader;
 	ShaderProgram *emitterShaderGeom;
 	ShaderProgram *compute;
+	ShaderProgram *sortCompute;	//back to front order, see ParticleSort
 
 	//check for a XML Error. Gives feedback what went wrong if something goes wrong
 	int XMLCheckResult(int result);
@@ -1,7 +1,54 @@
 #include "Emitter.h"
+#include <algorithm>
+#include "GeKo_Graphics/ParticleSystem/ParticleSort.h"
+#include "GeKo_Graphics/ParticleSystem/ParticleUploadBuffer.h"
+#include "GeKo_Graphics/Material/TextureManager.h"
+#include "GeKo_Graphics/Shader/Uniforms.h"
+
+//uniforms of ParticleSystem.comp & the particle render shaders
+static const UniformHandle s_particleCount("particleCount");
+static const UniformHandle s_spawnOffset("spawnOffset");
+static const UniformHandle s_spawnCount("spawnCount");
+static const UniformHandle s_spawnSeed("spawnSeed");
+static const UniformHandle s_spawnFrame("spawnFrame");
+static const UniformHandle s_spawnPos("spawnPos");
+static const UniformHandle s_spawnSpeed("spawnSpeed");
+static const UniformHandle s_velocityType("velocityType");
+static const UniformHandle s_areaEmittingXY("areaEmittingXY");
+static const UniformHandle s_areaEmittingXZ("areaEmittingXZ");
+static const UniformHandle s_areaSize("areaSize");
+static const UniformHandle s_areaAccuracy("areaAccuracy");
+static const UniformHandle s_deltaTime("deltaTime");
+static const UniformHandle s_emitterPos("emitterPos");
+static const UniformHandle s_fullLifetime("fullLifetime");
+static const UniformHandle s_particleMortal("particleMortal");
+static const UniformHandle s_gravity("gravity");
+static const UniformHandle s_gravityRange("gravityRange");
+static const UniformHandle s_gravityFunc("gravityFunc");
+static const UniformHandle s_useTrajectory("useTrajectory");
+static const UniformHandle s_useDirectionGravity("useDirectionGravity");
+static const UniformHandle s_usePointGravity("usePointGravity");
+static const UniformHandle s_useChaoticSwarmMotion("useChaoticSwarmMotion");
+static const UniformHandle s_useMovementVertical("useMovementVertical");
+static const UniformHandle s_useMovementHorizontalX("useMovementHorizontalX");
+static const UniformHandle s_useMovementHorizontalZ("useMovementHorizontalZ");
+static const UniformHandle s_textureCount("textureCount");
+static const UniformHandle s_birthTime("birthTime");
+static const UniformHandle s_deathTime("deathTime");
+static const UniformHandle s_blendingTime("blendingTime");
+static const UniformHandle s_time("time");
+static const UniformHandle s_useScaling("useScaling");
+static const UniformHandle s_scalingCount("scalingCount");
+static const UniformHandle s_scalingData("scalingData");
+static const UniformHandle s_size("size");
+static const UniformHandle s_rotateLeft("rotateLeft");
+static const UniformHandle s_rotationSpeed("rotationSpeed");
 
 //TODO: COMMENTS & VAR RENAMING
 
+double(*Emitter::s_clock)() = &glfwGetTime;
+unsigned int Emitter::s_emitterCount = 0;
+
 Emitter::Emitter(const int OUTPUT, glm::vec3 position, double emitterLifetime, double emitFrequency,
 	int particlesPerEmit, double particleLifeTime, bool particleMortal)
 {
@@ -34,11 +81,15 @@ Emitter::Emitter(const int OUTPUT, glm::vec3 position, double emitterLifetime, d
 //TODO: Memory?
 Emitter::~Emitter()
 {
+	for (auto texture : m_managedTextures)
+		TextureManager::getInstance()->release(texture);
+	m_managedTextures.clear();
 	m_textureList.clear();
+	deleteBuffers();
 }
 
 void Emitter::startTime(){
-	updateTime = glfwGetTime();
+	updateTime = getTime();
 	deltaTime = updateTime;
 	generateTime = deltaTime;
 }
@@ -46,6 +97,7 @@ void Emitter::startTime(){
 void Emitter::start(){
 	if (m_output == UNUSED){
 		m_isStarted = true;
+		m_spawnFrame = 0;
 		startTime();
 		setOutputMode(m_outputType);
 	}
@@ -58,49 +110,168 @@ void Emitter::stop(){
 }
 
 void Emitter::loadBuffer(){
-	//create and fill a buffer with positions
-	glGenBuffers(1, &position_ssbo);
-	glBindBuffer(GL_SHADER_STORAGE_BUFFER, position_ssbo);
-	glBufferData(GL_SHADER_STORAGE_BUFFER, numMaxParticle * sizeof(glm::vec4), NULL, GL_STREAM_DRAW);
-	glm::vec4* positions = (glm::vec4*) glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_WRITE_ONLY);
-	for (int i = 0; i < numMaxParticle; i++)
-	{
-		positions[i] = glm::vec4(getPosition(), -1.0f);
+	//the size changed, the old buffer is not needed anymore
+	deleteBuffers();
+
+	//one buffer with all particle data, the CPU simulation only needs the positions for drawing
+	glGenBuffers(1, &particle_ssbo);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, particle_ssbo);
+	if (m_useCPUSimulation){
+		std::vector<glm::vec4> positions(numMaxParticle, glm::vec4(getPosition(), -1.0f));
+		glBufferData(GL_SHADER_STORAGE_BUFFER, numMaxParticle * sizeof(glm::vec4), positions.data(), GL_STREAM_DRAW);
+	}
+	else{
+		ParticleData deadParticle;
+		deadParticle.position = glm::vec4(getPosition(), -1.0f);
+		deadParticle.velocity = glm::vec4(0.0, 0.0, 0.0, 0.0);
+		deadParticle.angle = glm::vec4(0.0, 0.0, 0.0, 0.0);
+		std::vector<ParticleData> particles(numMaxParticle, deadParticle);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, numMaxParticle * sizeof(ParticleData), particles.data(), GL_DYNAMIC_COPY);
+
+		//positions of the living particles, written by the compute shader
+		glGenBuffers(1, &alive_ssbo);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, alive_ssbo);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, numMaxParticle * sizeof(glm::vec4), NULL, GL_DYNAMIC_COPY);
+
+		//DrawArraysIndirectCommand: count (atomic counter of the compute shader), instanceCount, first, baseInstance
+		GLuint drawCommand[4] = { 0, 1, 0, 0 };
+		glGenBuffers(1, &draw_indirect);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, draw_indirect);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(drawCommand), drawCommand, GL_DYNAMIC_COPY);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
 	}
-	glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
 	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
-	//create and fill a buffer with velocitys
-	glGenBuffers(1, &velocity_ssbo);
-	glBindBuffer(GL_SHADER_STORAGE_BUFFER, velocity_ssbo);
-	glBufferData(GL_SHADER_STORAGE_BUFFER, numMaxParticle * sizeof(glm::vec4), NULL, GL_STREAM_DRAW);
-	glm::vec4* velocity = (glm::vec4*) glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_WRITE_ONLY);
-	for (int i = 0; i < numMaxParticle; i++)
-	{
-		velocity[i] = glm::vec4(0.0, 0.0, 0.0, 0.0);
+	m_buffersLoaded = true;
+}
+
+void Emitter::deleteBuffers(){
+	if (m_buffersLoaded){
+		glDeleteBuffers(1, &particle_ssbo);
+		glDeleteBuffers(1, &alive_ssbo);	//0 for the CPU simulation, glDeleteBuffers ignores it
+		glDeleteBuffers(1, &draw_indirect);
+		particle_ssbo = 0;
+		alive_ssbo = 0;
+		draw_indirect = 0;
+		m_buffersLoaded = false;
 	}
-	glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
-	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
 
-	//create and fill a buffer with angles
-	glGenBuffers(1, &angle_ssbo);
-	glBindBuffer(GL_SHADER_STORAGE_BUFFER, angle_ssbo);
-	glBufferData(GL_SHADER_STORAGE_BUFFER, numMaxParticle * sizeof(glm::vec4), NULL, GL_STREAM_DRAW);
-	glm::vec4* angle = (glm::vec4*) glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_WRITE_ONLY);
-	for (int i = 0; i < numMaxParticle; i++)
-	{
-		angle[i] = glm::vec4(0.0, 0.0, 0.0, 0.0);
+bool Emitter::getBuffersLoaded(){
+	return m_buffersLoaded;
+}
+
+void Emitter::clearParticles(){
+	m_hasParticles = false;
+	m_spawnCount = 0;
+	indexBuffer = 0;
+
+	if (m_useCPUSimulation){
+		m_cpuSimulation.resize(numMaxParticle, getPosition());
+		return;
+	}
+	if (m_buffersLoaded){
+		ParticleData deadParticle;
+		deadParticle.position = glm::vec4(getPosition(), -1.0f);
+		deadParticle.velocity = glm::vec4(0.0, 0.0, 0.0, 0.0);
+		deadParticle.angle = glm::vec4(0.0, 0.0, 0.0, 0.0);
+		std::vector<ParticleData> particles(numMaxParticle, deadParticle);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, particle_ssbo);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, numMaxParticle * sizeof(ParticleData), particles.data());
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+		//nothing to draw until the next dispatch
+		GLuint count = 0;
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, draw_indirect);
+		glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(GLuint), &count);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
 	}
-	glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
-	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
-void Emitter::update(ShaderProgram* compute, glm::vec3 playerPosition){
+bool Emitter::isFinished(){
+	if (m_output != UNUSED)
+		return false;
+	if (!m_hasParticles)
+		return true;
+	if (!m_particleMortal)
+		return false;
+	return getTime() - m_lastEmitTime >= m_particleLifetime;
+}
+
+void Emitter::setLOD(float emissionScale, float sizeScale){
+	m_lodEmission = std::min(std::max(emissionScale, 0.0f), 1.0f);
+	m_lodSize = sizeScale;
+}
+
+float Emitter::getLODEmission(){
+	return m_lodEmission;
+}
+
+float Emitter::getLODSize(){
+	return m_lodSize;
+}
+
+void Emitter::getLODScalingData(float* data){
+	//moment, size, moment, size, ..
+	for (int i = 0; i < 32; i++)
+		data[i] = (i % 2 == 1) ? m_scalingData[i] * m_lodSize : m_scalingData[i];
+}
+
+int Emitter::getLODParticlesPerEmit(){
+	if (particlesPerEmit <= 0 || m_lodEmission >= 1.0f)
+		return particlesPerEmit;
+	return std::max(1, (int)(particlesPerEmit * m_lodEmission + 0.5f));
+}
+
+void Emitter::setDepthSort(bool on){
+	m_depthSort = on;
+}
+
+bool Emitter::getDepthSort(){
+	return m_depthSort;
+}
+
+void Emitter::sortParticles(ShaderProgram* sort, Camera &cam){
+	if (m_useCPUSimulation || !m_buffersLoaded)
+		return;
+	glm::vec3 camPos(cam.getPosition().x, cam.getPosition().y, cam.getPosition().z);
+	ParticleSort::sortByDepth(sort, camPos, alive_ssbo, draw_indirect, 0, 0, numMaxParticle);
+}
+
+float Emitter::getBoundingRadius(){
+	if (m_movable || !m_particleMortal)
+		return -1.0f;
 
+	float lifetime = m_particleLifetime;
+	float radius = m_areaSize + m_speed * lifetime;
+
+	if (m_useTrajectory)
+		radius += 0.5f * std::abs(m_gravity.w) * lifetime * lifetime;
+	if (m_usePointGravity){
+		//the particles circle around the gravity point
+		glm::vec3 point(m_gravity.x, m_gravity.y, m_gravity.z);
+		if (m_useLocalCoordinates)
+			point += m_emitterPosition;
+		glm::vec3 distance = point - m_emitterPosition;
+		radius = std::max(radius, std::sqrt(glm::dot(distance, distance)) + m_gravityRange);
+	}
+	if (m_useChaoticSwarmMotion && m_speed > 0.0f)
+		radius += lifetime / m_speed;
+
+	//the biggest particle
+	float size = m_particleDefaultSize;
+	if (m_useScaling){
+		for (int i = 1; i < 32; i += 2)
+			size = std::max(size, m_scalingData[i]);
+	}
+	return radius + size;
+}
+
+EmitterUpdate Emitter::prepareUpdate(glm::vec3 playerPosition){
 	generateParticle(playerPosition);
 
-	deltaTime = glfwGetTime() - updateTime; //time remain since last update
-	updateTime = glfwGetTime();
+	deltaTime = getTime() - updateTime; //time remain since last update
+	updateTime = getTime();
 
 	if (m_isStarted && m_emitLifetime > 0) {
 		m_emitLifetime -= deltaTime;
@@ -108,176 +279,198 @@ void Emitter::update(ShaderProgram* compute, glm::vec3 playerPosition){
 	if (m_emitLifetime <= 0 && m_emitterMortal){ //it's only for dying emitters relevant
 		m_output = UNUSED;
 	}
-	compute->bind();
-	//Bind CS and all SSBO's
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, position_ssbo);
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, velocity_ssbo);
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, angle_ssbo);
-
-	//Uniform Vars
-	compute->sendFloat("deltaTime", (float)deltaTime);
-	compute->sendVec3("emitterPos", getPosition()); //can be saved position, or parameter
-	compute->sendFloat("fullLifetime", m_particleLifetime);
-	compute->sendInt("particleMortal", m_particleMortal);
 
+	EmitterUpdate state;
+	state.deltaTime = (float)deltaTime;
+	state.emitterPosition = getPosition();
+	state.gravity = m_gravity;
 	if (m_usePointGravity && m_useLocalCoordinates){
 		glm::vec3 newPosition(0,0,0);
 		newPosition.x = m_emitterPosition.x + m_gravity.x;
 		newPosition.y = m_emitterPosition.y + m_gravity.y;
 		newPosition.z = m_emitterPosition.z + m_gravity.z;
-		compute->sendVec4("gravity", glm::vec4(newPosition, m_gravityImpact));
-		
+		state.gravity = glm::vec4(newPosition, m_gravityImpact);
 	}
-	else{
-		compute->sendVec4("gravity", m_gravity);
-		
+
+	//new particles of the compute shader, it takes the slots after indexBuffer. The CPU simulation spawns them in pushParticle
+	state.spawnOffset = indexBuffer;
+	state.spawnCount = m_spawnCount;
+	state.spawnSeed = m_spawnSeed;
+	state.spawnFrame = m_spawnFrame++;
+	state.spawnPosition = m_spawnPosition;
+	if (numMaxParticle > 0)
+		indexBuffer = (indexBuffer + m_spawnCount) % numMaxParticle;
+	m_spawnCount = 0;
+
+	return state;
+}
+
+void Emitter::update(ShaderProgram* compute, glm::vec3 playerPosition){
+	//the buffers are created with the first update, so an emitter can be set up without a GL context
+	if (!m_useCPUSimulation && !m_buffersLoaded)
+		loadBuffer();
+
+	EmitterUpdate state = prepareUpdate(playerPosition);
+
+	if (m_useCPUSimulation){
+		ParticleSimulationParameters parameters;
+		parameters.deltaTime = state.deltaTime;
+		parameters.emitterPosition = state.emitterPosition;
+		parameters.fullLifetime = m_particleLifetime;
+		parameters.particleMortal = m_particleMortal;
+		parameters.gravity = state.gravity;
+		parameters.gravityRange = m_gravityRange;
+		parameters.gravityFunction = m_gravityFunction;
+		parameters.useTrajectory = m_useTrajectory;
+		parameters.useDirectionGravity = m_useDirectionGravity;
+		parameters.usePointGravity = m_usePointGravity;
+		parameters.useChaoticSwarmMotion = m_useChaoticSwarmMotion;
+		parameters.movementVertical = m_movementVertical;
+		parameters.movementHorizontalX = m_movementHorizontalX;
+		parameters.movementHorizontalZ = m_movementHorizontalZ;
+
+		m_cpuSimulation.update(parameters);
+		return;
 	}
-	compute->sendFloat("gravityRange", m_gravityRange);
-	compute->sendInt("gravityFunc", m_gravityFunction);
 
-	compute->sendInt("useTrajectory", m_useTrajectory);
-	compute->sendInt("useDirectionGravity", m_useDirectionGravity);
-	compute->sendInt("usePointGravity", m_usePointGravity);
-	compute->sendInt("useChaoticSwarmMotion", m_useChaoticSwarmMotion);
+	//reset the number of living particles, the compute shader counts them again
+	GLuint aliveCount = 0;
+	glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, draw_indirect);
+	glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(GLuint), &aliveCount);
+	glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
+
+	compute->bind();
+	//Bind CS and all SSBO's
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, particle_ssbo);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, alive_ssbo);
+	glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, draw_indirect);
 
-	compute->sendInt("useMovementVertical", m_movementVertical);
-	compute->sendInt("useMovementHorizontalX", m_movementHorizontalX);
-	compute->sendInt("useMovementHorizontalZ", m_movementHorizontalZ);
+	//Uniform Vars
+	compute->sendInt(s_particleCount, numMaxParticle);
+
+	//new particles
+	compute->sendInt(s_spawnOffset, state.spawnOffset);
+	compute->sendInt(s_spawnCount, state.spawnCount);
+	compute->sendInt(s_spawnSeed, (int)state.spawnSeed);
+	compute->sendInt(s_spawnFrame, (int)state.spawnFrame);
+	compute->sendVec3(s_spawnPos, state.spawnPosition);
+	compute->sendFloat(s_spawnSpeed, getSpeed());
+	compute->sendInt(s_velocityType, m_velocityType);
+	compute->sendInt(s_areaEmittingXY, m_areaEmittingXY);
+	compute->sendInt(s_areaEmittingXZ, m_areaEmittingXZ);
+	compute->sendFloat(s_areaSize, m_areaSize);
+	compute->sendInt(s_areaAccuracy, m_areaAccuracy);
+	compute->sendFloat(s_deltaTime, state.deltaTime);
+	compute->sendVec3(s_emitterPos, state.emitterPosition); //can be saved position, or parameter
+	compute->sendFloat(s_fullLifetime, m_particleLifetime);
+	compute->sendInt(s_particleMortal, m_particleMortal);
+	compute->sendVec4(s_gravity, state.gravity);
+	compute->sendFloat(s_gravityRange, m_gravityRange);
+	compute->sendInt(s_gravityFunc, m_gravityFunction);
+
+	compute->sendInt(s_useTrajectory, m_useTrajectory);
+	compute->sendInt(s_useDirectionGravity, m_useDirectionGravity);
+	compute->sendInt(s_usePointGravity, m_usePointGravity);
+	compute->sendInt(s_useChaoticSwarmMotion, m_useChaoticSwarmMotion);
+
+	compute->sendInt(s_useMovementVertical, m_movementVertical);
+	compute->sendInt(s_useMovementHorizontalX, m_movementHorizontalX);
+	compute->sendInt(s_useMovementHorizontalZ, m_movementHorizontalZ);
 
 	//Unbind CD and all SSBO's
 	glDispatchCompute(computeGroupCount, 1, 1); //runs the compute shader
-	glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT); //essential for memory synchronisation
+	glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT); //essential for memory synchronisation
 	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0); //unbind SSBOs
 	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, 0);
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, 0);
+	glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, 0);
 	compute->unbind();
 }
 void Emitter::pushParticle(int numberNewParticle, glm::vec3 playerPosition){
-	auto emitPosition = getPosition() + playerPosition;
-	auto areaEmittingXY = getAreaEmittingXY();
-	auto areaEmittingXZ = getAreaEmittingXZ();
-
-	glBindBuffer(GL_SHADER_STORAGE_BUFFER, position_ssbo);
-
-	glm::vec4* positions = (glm::vec4*) glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_WRITE_ONLY);
-	if (areaEmittingXY && areaEmittingXZ){
-		auto accuracy = getAreaAccuracy(); //how near it will be generated
-		auto areaSize = getAreaSize(); //how big the area is
-		float randomNumber;
-		glm::vec3 pos;
-
-		for (int i = 0; i < numberNewParticle; i++)
-		{
-			int index = (indexBuffer + i) % numMaxParticle;
+	m_hasParticles = true;
+	m_lastEmitTime = getTime();
 
-			randomNumber = (rand() % (2 * accuracy + 1) - accuracy) / (float)accuracy; //-1 .. 1 with a certain comma accuracy
-			pos.x = emitPosition.x + areaSize * randomNumber;
-			randomNumber = (rand() % (2 * accuracy + 1) - accuracy) / (float)accuracy; //-1 .. 1
-			pos.y = emitPosition.y + areaSize * randomNumber;
-			randomNumber = (rand() % (2 * accuracy + 1) - accuracy) / (float)accuracy; //-1 .. 1
-			pos.z = emitPosition.z + areaSize * randomNumber;
-
-			positions[index] = glm::vec4(pos, m_particleLifetime);
-		}
-	}
-	else if (areaEmittingXZ){ //emits in a xz area, like rain
-		auto accuracy = getAreaAccuracy(); //how near it will be generated
-		auto areaSize = getAreaSize(); //how big the area is
-		float randomNumber;
-		glm::vec3 pos;
-
-		for (int i = 0; i < numberNewParticle; i++)
-		{
-			int index = (indexBuffer + i) % numMaxParticle;
-
-			randomNumber = (rand() % (2 * accuracy + 1) - accuracy) / (float)accuracy; //-1 .. 1 with a certain comma accuracy
-			pos.x = emitPosition.x + areaSize * randomNumber;
-			randomNumber = (rand() % (2 * accuracy + 1) - accuracy) / (float)accuracy; //-1 .. 1
-			pos.z = emitPosition.z + areaSize * randomNumber;
-			pos.y = emitPosition.y;
-
-			positions[index] = glm::vec4(pos, m_particleLifetime);
-		}
-	}
-	else if (areaEmittingXY){ //will be emitted in xy area
-		auto accuracy = getAreaAccuracy();
-		auto areaSize = getAreaSize();
-		float randomNumber;
-		glm::vec3 pos;
-
-		for (int i = 0; i < numberNewParticle; i++)
-		{
-			int index = (indexBuffer + i) % numMaxParticle;
-
-			randomNumber = (rand() % (2 * accuracy + 1) - accuracy) / (float)accuracy; //-1 .. 1 with a certain comma accuracy
-			pos.x = emitPosition.x + areaSize * randomNumber;
-			randomNumber = (rand() % (2 * accuracy + 1) - accuracy) / (float)accuracy; //-1 .. 1
-			pos.y = emitPosition.y + areaSize * randomNumber;
-			pos.z = emitPosition.z;
+	auto emitPosition = getPosition() + playerPosition;
+	auto speed = getSpeed();
+	int phi = 50.0; // (rand() % 360); //x&z axis
+	int theta = 50; //y axis
 
-			positions[index] = glm::vec4(pos, m_particleLifetime);
-		}
-	}
-	else{ //will be emitted like a jet
-		for (int i = 0; i < numberNewParticle; i++)
+	if (m_useCPUSimulation){
+		//the same numbers as the compute shader: (seed, slot, frame), 4 particles at once
+		bool areaEmitting = getAreaEmittingXY() || getAreaEmittingXZ();
+		for (int first = 0; first < numberNewParticle; first += 4)
 		{
-			int index = (indexBuffer + i) % numMaxParticle;
-			positions[index] = glm::vec4(emitPosition, m_particleLifetime);
+			uint32_t index[4];
+			float random[4][4];
+			float randomArea[4][4];
+			for (int i = 0; i < 4; i++)
+				index[i] = (uint32_t)((indexBuffer + first + i) % numMaxParticle);
+			ParticleRandom::uniform4(m_spawnSeed, index, m_spawnFrame, 0, random);
+			if (areaEmitting)
+				ParticleRandom::uniform4(m_spawnSeed, index, m_spawnFrame, 1, randomArea);
+
+			int count = std::min(4, numberNewParticle - first);
+			for (int i = 0; i < count; i++)
+			{
+				glm::vec3 position = areaEmitting ? getSpawnPosition(emitPosition, random[3][i], randomArea[0][i], randomArea[1][i]) : emitPosition;
+				glm::vec3 direction = getSpawnDirection(glm::vec3(random[0][i], random[1][i], random[2][i]));
+				m_cpuSimulation.emit((int)index[i], position, m_particleLifetime, direction, speed, phi, theta);
+			}
 		}
+		indexBuffer = (indexBuffer + numberNewParticle) % numMaxParticle;
+		return;
 	}
 
-	glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
-	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-
-	auto speed = getSpeed();
-
-	glBindBuffer(GL_SHADER_STORAGE_BUFFER, velocity_ssbo);
-
-	glm::vec4* velocity = (glm::vec4*) glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_WRITE_ONLY); //direction of movement
-	for (int i = 0; i < numberNewParticle; i++)
-	{
-		glm::vec3 vel = this->m_pfunc(); //gets a random vector from the desired vector space
-		if (glm::length(vel) != 0.0)
-			vel = glm::normalize(vel);
-		int index = (indexBuffer + i) % numMaxParticle;
-		velocity[index] = glm::vec4(vel, speed);
-	}
+	//the compute shader spawns them with the next dispatch, only the last numMaxParticle particles would survive
+	m_spawnCount = std::min(m_spawnCount + numberNewParticle, numMaxParticle);
+	m_spawnPosition = emitPosition;
+}
+glm::vec3 Emitter::getSpawnPosition(glm::vec3 emitPosition, float randomX, float randomY, float randomZ){
+	auto areaEmittingXY = getAreaEmittingXY();
+	auto areaEmittingXZ = getAreaEmittingXZ();
+	if (!areaEmittingXY && !areaEmittingXZ) //will be emitted like a jet
+		return emitPosition;
 
-	glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
-	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	auto accuracy = getAreaAccuracy(); //how near it will be generated
+	auto areaSize = getAreaSize(); //how big the area is
+	glm::vec3 pos = emitPosition;
 
-	glBindBuffer(GL_SHADER_STORAGE_BUFFER, angle_ssbo);
+	//xz area is like rain, xy area is like a wall, both is a cube. -1 .. 1 with a certain comma accuracy
+	pos.x = emitPosition.x + areaSize * ParticleRandom::area(randomX, accuracy);
+	if (areaEmittingXY)
+		pos.y = emitPosition.y + areaSize * ParticleRandom::area(randomY, accuracy);
+	if (areaEmittingXZ)
+		pos.z = emitPosition.z + areaSize * ParticleRandom::area(randomZ, accuracy);
+	return pos;
+}
+glm::vec3 Emitter::getSpawnDirection(glm::vec3 random){
+	//a normalized vector from the desired vector space
+	return ParticleRandom::direction(random, m_velocityType);
+}
 
-	glm::vec4* angle = (glm::vec4*) glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_WRITE_ONLY); //angle of movement as option to velocity
-	for (int i = 0; i < numberNewParticle; i++)
-	{
-		int index = (indexBuffer + i) % numMaxParticle;
-		int phi = 50.0; // (rand() % 360); //x&z axis
-		int theta = 50; //y axis
-		angle[index] = glm::vec4(phi, theta, 0.0, 0.0);
-	}
-	glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
-	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+void Emitter::setSeed(unsigned int seed){
+	m_spawnSeed = seed;
+}
 
-	indexBuffer = (indexBuffer + numberNewParticle) % numMaxParticle;
+unsigned int Emitter::getSeed(){
+	return m_spawnSeed;
 }
 void Emitter::generateParticle(glm::vec3 playerPosition)
 {
 	switch (m_output)
 	{
 	case CONSTANT: //we generate constant new particle
-		if (glfwGetTime() - generateTime >= m_emitFrequency){
-			deltaTime = glfwGetTime() - generateTime;
+		if (getTime() - generateTime >= m_emitFrequency){
+			deltaTime = getTime() - generateTime;
 			while (deltaTime >= m_emitFrequency) {
-				pushParticle(particlesPerEmit, playerPosition);
+				pushParticle(getLODParticlesPerEmit(), playerPosition);
 				deltaTime -= m_emitFrequency;
 			}
-			generateTime = glfwGetTime();
+			generateTime = getTime();
 		}
 		break;
 	case ONCE: //we generate only one time particle
-		if (glfwGetTime() - generateTime >= m_emitFrequency){
-			pushParticle(particlesPerEmit, playerPosition);
+		if (getTime() - generateTime >= m_emitFrequency){
+			pushParticle(getLODParticlesPerEmit(), playerPosition);
 			m_output = UNUSED;
 		}
 		break;
@@ -286,9 +479,49 @@ void Emitter::generateParticle(glm::vec3 playerPosition)
 	}
 }
 
+void Emitter::uploadPositions()
+{
+	//the last draw may still read particle_ssbo, the ring is copied behind it on the GPU instead of a glBufferSubData
+	ParticleUploadBuffer* ring = ParticleUploadBuffer::getShared();
+	int count = (int)m_cpuPositions.size();
+	GLintptr offset;
+	glm::vec4* positions = ring->allocate(count, offset);
+	if (positions == nullptr){
+		glBindBuffer(GL_ARRAY_BUFFER, particle_ssbo);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(glm::vec4), m_cpuPositions.data());
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		return;
+	}
+
+	std::copy(m_cpuPositions.begin(), m_cpuPositions.end(), positions);
+	ring->copyTo(particle_ssbo, offset, count);
+	ring->fence();
+}
+
 void Emitter::render(ShaderProgram* emitterShader, Camera &cam)
 {
+	if (!m_buffersLoaded)
+		loadBuffer();
+
+	//the CPU simulation uploads all positions, the compute shader writes the living ones to alive_ssbo
+	GLuint vertexBuffer = alive_ssbo;
+	if (m_useCPUSimulation){
+		vertexBuffer = particle_ssbo;
+		m_cpuSimulation.writePositions(m_cpuPositions);
+		if (m_depthSort){
+			glm::vec3 camPos(cam.getPosition().x, cam.getPosition().y, cam.getPosition().z);
+			std::sort(m_cpuPositions.begin(), m_cpuPositions.end(), [camPos](const glm::vec4& a, const glm::vec4& b){
+				glm::vec3 distanceA = glm::vec3(a.x, a.y, a.z) - camPos;
+				glm::vec3 distanceB = glm::vec3(b.x, b.y, b.z) - camPos;
+				return glm::dot(distanceA, distanceA) > glm::dot(distanceB, distanceB);
+			});
+		}
+		uploadPositions();
+	}
+
 	auto useTexture = getUseTexture();
+	float scalingData[32];
+	getLODScalingData(scalingData);
 	glDepthMask(GL_FALSE);
 
 	glEnable(GL_BLEND);
@@ -296,88 +529,80 @@ void Emitter::render(ShaderProgram* emitterShader, Camera &cam)
 
 	if (getUsePointSprites()){ //if we dont use a geometry shader..
 		emitterShader->bind();
-		glBindBuffer(GL_ARRAY_BUFFER, position_ssbo);
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
 
 		if (useTexture){
 			glEnable(GL_POINT_SPRITE);
 			glTexEnvi(GL_POINT_SPRITE, GL_COORD_REPLACE, GL_TRUE);	//the fragment color gets interpolated
 			glEnable(GL_PROGRAM_POINT_SIZE);
-			std::string s = "tex";
 			for (int i = 0; i < m_textureCount; i++){
-				std::string i2 = std::to_string(i);
-				s += i2;
-				emitterShader->sendSampler2D(s, m_textureList.at(i)->getTexture(), i + 1);
-				s = "tex";
+				emitterShader->sendSampler2D(Uniforms::particleTextures[i], m_textureList.at(i)->getTexture(), i + 1);
 			}
-			emitterShader->sendInt("textureCount", m_textureCount);
+			emitterShader->sendInt(s_textureCount, m_textureCount);
 		}
 		//Uniform Vars
-		emitterShader->sendFloat("fullLifetime", (float)m_particleLifetime);
-		emitterShader->sendInt("particleMortal", m_particleMortal);
-		emitterShader->sendFloat("birthTime", m_birthTime);
-		emitterShader->sendFloat("deathTime", m_deathTime);
-		emitterShader->sendMat4("viewMatrix", cam.getViewMatrix());
-		emitterShader->sendMat4("projectionMatrix", cam.getProjectionMatrix());
-		emitterShader->sendInt("useTexture", useTexture);
-		emitterShader->sendFloat("blendingTime", m_blendingTime);
-		emitterShader->sendFloatArray("time", 4, blendingTime);
+		emitterShader->sendFloat(s_fullLifetime, (float)m_particleLifetime);
+		emitterShader->sendInt(s_particleMortal, m_particleMortal);
+		emitterShader->sendFloat(s_birthTime, m_birthTime);
+		emitterShader->sendFloat(s_deathTime, m_deathTime);
+		emitterShader->sendMat4(Uniforms::viewMatrix, cam.getViewMatrix());
+		emitterShader->sendMat4(Uniforms::projectionMatrix, cam.getProjectionMatrix());
+		emitterShader->sendInt(Uniforms::useTexture, useTexture);
+		emitterShader->sendFloat(s_blendingTime, m_blendingTime);
+		emitterShader->sendFloatArray(s_time, 4, blendingTime);
 		if (m_useScaling){
-			emitterShader->sendInt("useScaling", 1);
-			emitterShader->sendInt("scalingCount", m_scalingCount);
-			emitterShader->sendFloatArray("scalingData", m_scalingCount, m_scalingData);
-			emitterShader->sendFloat("fullLifetime", (float)m_particleLifetime);
-			emitterShader->sendInt("particleMortal", m_particleMortal);
+			emitterShader->sendInt(s_useScaling, 1);
+			emitterShader->sendInt(s_scalingCount, m_scalingCount);
+			emitterShader->sendFloatArray(s_scalingData, m_scalingCount, scalingData);
+			emitterShader->sendFloat(s_fullLifetime, (float)m_particleLifetime);
+			emitterShader->sendInt(s_particleMortal, m_particleMortal);
 		}
 		else{
-			emitterShader->sendInt("useScaling", 0);
-			emitterShader->sendFloat("size", m_particleDefaultSize);
+			emitterShader->sendInt(s_useScaling, 0);
+			emitterShader->sendFloat(s_size, m_particleDefaultSize * m_lodSize);
 		}
 		glVertexPointer(4, GL_FLOAT, 0, (void*)0);
 		glEnableClientState(GL_VERTEX_ARRAY);
-		glDrawArrays(GL_POINTS, 0, numMaxParticle);
+		drawParticles();
 		glDisableClientState(GL_VERTEX_ARRAY);
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 		emitterShader->unbind();
 	}
 	else if (getUseGeometryShader() && useTexture){
 		emitterShader->bind();
-		glBindBuffer(GL_ARRAY_BUFFER, position_ssbo);
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
 
 		//Uniform Vars
-		emitterShader->sendMat4("viewMatrix", cam.getViewMatrix());
-		emitterShader->sendMat4("projectionMatrix", cam.getProjectionMatrix());
-		emitterShader->sendFloat("birthTime", m_birthTime);
-		emitterShader->sendFloat("deathTime", m_deathTime);
-		emitterShader->sendFloat("fullLifetime", (float)m_particleLifetime);
-		emitterShader->sendVec4("camPos", cam.getPosition());
-		emitterShader->sendInt("rotateLeft", m_rotateLeft);
-		emitterShader->sendFloat("rotationSpeed", m_rotationSpeed);
-		emitterShader->sendInt("useTexture", useTexture);
-		emitterShader->sendFloat("blendingTime", m_blendingTime);
-		emitterShader->sendFloatArray("time", 4, blendingTime);
+		emitterShader->sendMat4(Uniforms::viewMatrix, cam.getViewMatrix());
+		emitterShader->sendMat4(Uniforms::projectionMatrix, cam.getProjectionMatrix());
+		emitterShader->sendFloat(s_birthTime, m_birthTime);
+		emitterShader->sendFloat(s_deathTime, m_deathTime);
+		emitterShader->sendFloat(s_fullLifetime, (float)m_particleLifetime);
+		emitterShader->sendVec4(Uniforms::camPos, cam.getPosition());
+		emitterShader->sendInt(s_rotateLeft, m_rotateLeft);
+		emitterShader->sendFloat(s_rotationSpeed, m_rotationSpeed);
+		emitterShader->sendInt(Uniforms::useTexture, useTexture);
+		emitterShader->sendFloat(s_blendingTime, m_blendingTime);
+		emitterShader->sendFloatArray(s_time, 4, blendingTime);
 		if (m_useTexture){
-			std::string s = "tex";
 			for (int i = 0; i < m_textureCount; i++){
-				std::string i2 = std::to_string(i);
-				s += i2;
-				emitterShader->sendSampler2D(s, m_textureList.at(i)->getTexture(), i + 1);
-				s = "tex";
+				emitterShader->sendSampler2D(Uniforms::particleTextures[i], m_textureList.at(i)->getTexture(), i + 1);
 			}
-			emitterShader->sendInt("textureCount", m_textureCount);
+			emitterShader->sendInt(s_textureCount, m_textureCount);
 		}
 		if (m_useScaling){
-			emitterShader->sendInt("useScaling", 1);
-			emitterShader->sendInt("scalingCount", m_scalingCount);
-			emitterShader->sendFloatArray("scalingData", m_scalingCount, m_scalingData);
-			emitterShader->sendInt("particleMortal", m_particleMortal);
+			emitterShader->sendInt(s_useScaling, 1);
+			emitterShader->sendInt(s_scalingCount, m_scalingCount);
+			emitterShader->sendFloatArray(s_scalingData, m_scalingCount, scalingData);
+			emitterShader->sendInt(s_particleMortal, m_particleMortal);
 		}
 		else{
-			emitterShader->sendInt("useScaling", 0);
-			emitterShader->sendFloat("size", m_particleDefaultSize);
+			emitterShader->sendInt(s_useScaling, 0);
+			emitterShader->sendFloat(s_size, m_particleDefaultSize * m_lodSize);
 		}
 		glEnableVertexAttribArray(0);
 		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, 0);
-		glDrawArrays(GL_POINTS, 0, numMaxParticle);
+		drawParticles();
 		glDisableVertexAttribArray(0);
 
 		glDisableClientState(GL_VERTEX_ARRAY);
@@ -391,6 +616,19 @@ void Emitter::render(ShaderProgram* emitterShader, Camera &cam)
 	glDisable(GL_BLEND);
 }
 
+//only the living particles are drawn, their number is in draw_indirect
+void Emitter::drawParticles()
+{
+	if (m_useCPUSimulation){
+		glDrawArrays(GL_POINTS, 0, numMaxParticle);
+	}
+	else{
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, draw_indirect);
+		glDrawArraysIndirect(GL_POINTS, (void*)0);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+}
+
 void Emitter::updateSize()
 {
 	if (!m_particleMortal){
@@ -402,7 +640,11 @@ void Emitter::updateSize()
 	}
 	computeGroupCount = (int)(numMaxParticle / 16) + 1; //+1 to make sure every particle gets updated. 16 is the local_size_x in the CS
 
-	loadBuffer();
+	//the buffers get created with the next update or render, not for every setter
+	deleteBuffers();
+	indexBuffer = 0;
+	if (m_useCPUSimulation)
+		m_cpuSimulation.resize(numMaxParticle, getPosition());
 }
 
 //GS & PS swichting
@@ -415,6 +657,34 @@ void Emitter::switchToPointSprites(){
 	m_useGeometryShader = false;
 }
 
+//CPU simulation
+void Emitter::useCPUSimulation(bool on, int threadCount){
+	m_useCPUSimulation = on;
+	m_cpuSimulation.setThreadCount(threadCount);
+	if (on)
+		m_cpuSimulation.resize(numMaxParticle, getPosition());
+	else
+		m_cpuSimulation.resize(0, getPosition());
+
+	//the particles of the other backend are lost
+	deleteBuffers();
+	indexBuffer = 0;
+}
+bool Emitter::getUseCPUSimulation(){
+	return m_useCPUSimulation;
+}
+ParticleSimulationCPU* Emitter::getCPUSimulation(){
+	return &m_cpuSimulation;
+}
+
+//clock
+void Emitter::setClock(double(*clock)()){
+	s_clock = clock;
+}
+double Emitter::getTime(){
+	return s_clock();
+}
+
 //physic:
 
 void Emitter::usePhysicTrajectory(glm::vec4 gravity, float speed){
@@ -585,6 +855,18 @@ void Emitter::addTexture(Texture* texture, float time){
 	}
 }
 
+void Emitter::addTexture(const std::string& path, float time){
+	Texture* texture = TextureManager::getInstance()->getTexture(path);
+	int count = m_textureCount;
+	addTexture(texture, time);
+
+	//a rejected texture is given back at once
+	if (m_textureCount > count)
+		m_managedTextures.push_back(texture);
+	else
+		TextureManager::getInstance()->release(texture);
+}
+
 void Emitter::defineLook(bool useTexture, float particleSize, float birthTime, float deathTime, float blendingTime, bool rotateLeft, float rotationSpeed){
 	m_useTexture = useTexture;
 
@@ -626,70 +908,29 @@ void Emitter::defineLook(bool useTexture, std::vector<float> scalingSize, std::v
 	}
 }
 
-//Velocity Getter
-glm::vec3 Emitter::useVelocityZero(){
-	return glm::vec3(0.0, 0.0, 0.0);
-}
-glm::vec3 Emitter::useVelocityLeftQuarterCircle(){
-	return glm::vec3(((rand() % 100) / 100.0f) - 1.0f,
-					((rand() % 100) / 100.0f),
-					0.0f);
-}
-glm::vec3 Emitter::useVelocityRightQuarterCircle(){
-	return glm::vec3(((rand() % 100) / 100.0f),
-					((rand() % 100) / 100.0f),
-					0.0f);
-}
-glm::vec3 Emitter::useVelocitySemiCircle(){
-	return glm::vec3(((rand() % 200) / 100.0f) - 1.0f,
-					((rand() % 100) / 100.0f),
-					0.0f);
-}
-glm::vec3 Emitter::useVelocityCircle(){
-	return	glm::vec3(((rand() % 200) / 100.0f) - 1.0f,
-					((rand() % 200) / 100.0f) - 1.0f,
-					0.0f);
-}
-glm::vec3 Emitter::useVelocitySemiSphere(){
-	return glm::vec3(((rand() % 200) / 100.0f) - 1.0f,
-					((rand() % 100) / 100.0f),
-					((rand() % 200) / 100.0f) - 1.0f);
-}
-glm::vec3 Emitter::useVelocitySphere(){
-	return glm::vec3(((rand() % 200) / 100.0f) - 1.0f,
-					((rand() % 200) / 100.0f) - 1.0f,
-					((rand() % 200) / 100.0f) - 1.0f);
-}
 void Emitter::setVelocity(int velocityType){
 	switch (velocityType)
 	{
 	case 0:
 		m_velocityType = 0;
-		m_pfunc = &Emitter::useVelocityZero;
 		break;
 	case 1:
 		m_velocityType = 1;
-		m_pfunc = &Emitter::useVelocityLeftQuarterCircle;
 		break;
 	case 2:
 		m_velocityType = 2;
-		m_pfunc = &Emitter::useVelocityRightQuarterCircle;
 		break;
 	case 3:
 		m_velocityType = 3;
-		m_pfunc = &Emitter::useVelocitySemiCircle;
 		break;
 	case 4:
 		m_velocityType = 4;
-		m_pfunc = &Emitter::useVelocityCircle;
 		break;
 	case 5:
 		m_velocityType = 5;
-		m_pfunc = &Emitter::useVelocitySemiSphere;
 		break;
 	case 6:
 		m_velocityType = 6;
-		m_pfunc = &Emitter::useVelocitySphere;
 		break;
 	default:
 		m_velocityType = -1;
@@ -835,6 +1076,9 @@ float Emitter::getTexParticleDefaultSize(){
 bool Emitter::getTexRotateLeft(){
 	return m_rotateLeft;
 }
+int Emitter::getNumMaxParticle(){
+	return numMaxParticle;
+}
 int Emitter::getTexTextureCount(){
 	return m_textureCount;
 }
@@ -855,6 +1099,22 @@ void Emitter::setAttributes(){
 	//Var for the buffer iteration
 	indexBuffer = 0;
 
+	//Buffers
+	particle_ssbo = 0;
+	alive_ssbo = 0;
+	draw_indirect = 0;
+	m_spawnCount = 0;
+	m_spawnPosition = glm::vec3(0.0, 0.0, 0.0);
+	m_spawnSeed = ParticleRandom::hashSeed(s_emitterCount++);
+	m_spawnFrame = 0;
+	m_buffersLoaded = false;
+	m_hasParticles = false;
+	m_lastEmitTime = 0.0;
+	m_depthSort = false;
+	m_lodEmission = 1.0f;
+	m_lodSize = 1.0f;
+	m_useCPUSimulation = false;
+
 	//property of the emitter
 	m_emitterPosition = glm::vec3(0.0, 0.0, 0.0);
 	m_localPosition = glm::vec3(0.0, 0.0, 0.0);
@@ -3,6 +3,27 @@
 #include "GeKo_Graphics/Camera/Camera.h"
 #include "GeKo_Graphics/GeometryInclude.h"
 #include "GeKo_Graphics/Material/Texture.h"
+#include "GeKo_Graphics/ParticleSystem/ParticleSimulationCPU.h"
+#include "GeKo_Graphics/ParticleSystem/ParticleRandom.h"
+
+///One particle in the particle buffer of an Emitter, the layout of the struct in ParticleSystem.comp
+struct ParticleData{
+	glm::vec4 position;	//xyz position, w remaining lifetime
+	glm::vec4 velocity;	//xyz direction, w speed
+	glm::vec4 angle;	//x phi, y theta of the trajectory
+};
+
+///The values of one update that change every frame, see Emitter::prepareUpdate
+struct EmitterUpdate{
+	float deltaTime;
+	glm::vec3 emitterPosition;
+	glm::vec4 gravity;			//the point of the point gravity is moved with the emitter
+	int spawnOffset;			//the spawnCount particles after spawnOffset (ring) are new
+	int spawnCount;
+	unsigned int spawnSeed;		//the seed of the emitter & the frame of the spawn, see ParticleRandom
+	unsigned int spawnFrame;
+	glm::vec3 spawnPosition;
+};
 
 /*
 Description:
@@ -17,6 +38,7 @@ Methods:
 -setAreaEmitting: if the particle should not come from the source, but in an area
 -addTexture & useTexture: to generate with textures
 -switchToGeometryShader or switchToPointSprites: to use Geometry Shader or PointSprites
+-useCPUSimulation: to simulate the particles without compute shader
 */
 class Emitter{
 public:
@@ -48,14 +70,50 @@ public:
 	void start();
 	void stop();
 
-	//update & generate the particle
+	//update & generate the particle. compute can be nullptr, if the CPU simulation is used
 	void update(ShaderProgram* compute, glm::vec3 playerPosition = glm::vec3(0.0, 0.0, 0.0));
+	//the CPU part of update: generates the particles, advances the time and returns what the compute shader needs. Used by the ParticleBatch
+	EmitterUpdate prepareUpdate(glm::vec3 playerPosition);
 	void generateParticle(glm::vec3 playerPosition);
 	void pushParticle(int numberNewParticle, glm::vec3 playerPosition);
 	void movePosition(glm::vec3 playerPosition);
 
-	//handle the buffer
+	//handle the buffer. It gets loaded with the first update or render, so no GL context is needed before
 	void loadBuffer();
+	bool getBuffersLoaded();
+	//kills all particles, the emitter can be started again at another position without the old particles
+	void clearParticles();
+	//true if the emitter doesn't emit anymore and all its particles are dead. Particles that never die only end with clearParticles
+	bool isFinished();
+
+	//level of detail: emissionScale (0..1] scales the particles per emit, sizeScale the size of the particles
+	void setLOD(float emissionScale, float sizeScale);
+	float getLODEmission();
+	float getLODSize();
+	//m_scalingData with the sizes scaled by the LOD, 32 floats
+	void getLODScalingData(float* data);
+	//how far from getPosition the particles can get (incl. their size). Negative if it is unbounded: movable emitters & immortal particles
+	float getBoundingRadius();
+
+	//the random numbers of the spawned particles only depend on the seed, the particle index and the updates since the start (ParticleRandom).
+	//Every emitter gets its own seed from a counter of created emitters, the same effect plays the same way every time
+	void setSeed(unsigned int seed);
+	unsigned int getSeed();
+
+	//draw the living particles back to front, for the blending of overlapping particles. Off by default
+	void setDepthSort(bool on);
+	bool getDepthSort();
+	//sorts alive_ssbo with ParticleSort, called by the Effect before render. The CPU simulation sorts in render
+	void sortParticles(ShaderProgram* sort, Camera &cam);
+
+	//simulate the particles on the CPU (SSE and threads) instead of the compute shader. The buffers are only used for drawing
+	void useCPUSimulation(bool on, int threadCount = 1);
+	bool getUseCPUSimulation();
+	ParticleSimulationCPU* getCPUSimulation();
+
+	//the clock of all emitters and effects, glfwGetTime is default. Without a window a own clock can be set
+	static void setClock(double(*clock)());
+	static double getTime();
 
 	//switch between Point Sprites & Geometry Shader. PS is default. Differents CS can be loaded 
 	void switchToGeometryShader();
@@ -67,18 +125,10 @@ public:
 
 	//our method & var for velocity
 	void setAreaEmitting(bool areaEmittingXY, bool areaEmittingXZ, float size, int accuracy);
-	static glm::vec3 useVelocityZero();
-	static glm::vec3 useVelocityLeftQuarterCircle();
-	static glm::vec3 useVelocityRightQuarterCircle();
-	static glm::vec3 useVelocitySemiCircle();
-	static glm::vec3 useVelocityCircle();
-	static glm::vec3 useVelocitySemiSphere();
-	static glm::vec3 useVelocitySphere();
 	/*0 = Zero; 1 = LeftQuarterCircle; 2 = RightQuarterCircle;
 	3 = SemiCircle; 4 = Circle; 5 = SemiSphere; 6 = Sphere*/
 	void setVelocity(int velocityType);
 	int getVelocityType();
-	glm::vec3(*m_pfunc)();
 
 	//our physic possibilities
 	void usePhysicTrajectory(glm::vec4 gravity, float speed);
@@ -91,6 +141,8 @@ public:
 		WARNING: Only 2 Textures at the same time are interpolating. if you have a too small fading time not all textures are interpolationg
 	*/
 	void addTexture(Texture* texture, float time);
+	///Like addTexture, the texture of the file comes from the TextureManager. The emitter gives the reference back in its destructor
+	void addTexture(const std::string& path, float time);
 	/*
 		WARNING: Only 2 Textures at the same time are interpolating. if you have a too small fading time not all textures are interpolationg
 	*/
@@ -102,6 +154,7 @@ public:
 	void defineLook(bool useTexture, std::vector<float> scalingSize, std::vector<float> scalingMoment,
 		float birthTime = 0.0, float deathTime = 0.0, float blendingTime = 0.0, bool rotateLeft = false, float rotationSpeed = 0.0);
 	std::vector<Texture*> m_textureList;
+	std::vector<Texture*> m_managedTextures;	//the textures of addTexture(path), references of the TextureManager
 
 	//change properties
 	void setOutputMode(const int OUTPUT);	//the currently used output mode (depends on emitter start/stop)
@@ -163,6 +216,7 @@ public:
 	float getTexParticleDefaultSize();
 	bool getTexRotateLeft();
 	int getTexTextureCount();
+	int getNumMaxParticle();
 	float getTexBlendingTime();
 
 	//scaling and blending
@@ -178,11 +232,46 @@ private:
 
 	//updates the buffer and compute size
 	void updateSize();
-
-	//Buffers
-	GLuint position_ssbo;
-	GLuint velocity_ssbo;
-	GLuint angle_ssbo;
+	void deleteBuffers();
+	void drawParticles();
+	//copies m_cpuPositions into particle_ssbo through the ParticleUploadBuffer
+	void uploadPositions();
+
+	//position & direction of a new particle, from 0 .. 1 random numbers (ParticleRandom streams)
+	glm::vec3 getSpawnPosition(glm::vec3 emitPosition, float randomX, float randomY, float randomZ);
+	glm::vec3 getSpawnDirection(glm::vec3 random);
+
+	//Buffer with the ParticleData of all particles. The compute shader writes the living ones to alive_ssbo and counts them in draw_indirect
+	GLuint particle_ssbo;
+	GLuint alive_ssbo;
+	GLuint draw_indirect;
+	bool m_buffersLoaded;
+
+	//the compute shader spawns the particles, we only count them
+	int m_spawnCount;
+	glm::vec3 m_spawnPosition;
+	unsigned int m_spawnSeed;
+	unsigned int m_spawnFrame;	//updates since the start
+	static unsigned int s_emitterCount;	//for the seeds
+
+	//for isFinished
+	bool m_hasParticles;
+	double m_lastEmitTime;
+
+	//back to front order of the particles
+	bool m_depthSort;
+
+	//level of detail
+	float m_lodEmission;
+	float m_lodSize;
+	int getLODParticlesPerEmit();
+
+	//CPU simulation
+	bool m_useCPUSimulation;
+	ParticleSimulationCPU m_cpuSimulation;
+	std::vector<glm::vec4> m_cpuPositions;	//for the upload to particle_ssbo
+
+	static double(*s_clock)();
 
 	//Var how the Output should flow
 	enum FLOW { UNUSED = -1, CONSTANT = 0, ONCE = 1 } m_output;
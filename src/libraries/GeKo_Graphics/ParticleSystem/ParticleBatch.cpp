@@ -0,0 +1,564 @@
+#include "GeKo_Graphics/ParticleSystem/ParticleBatch.h"
+#include "GeKo_Graphics/ParticleSystem/ParticleSort.h"
+#include "GeKo_Graphics/Shader/Uniforms.h"
+#include <algorithm>
+
+//local_size_x of ParticleSystem.comp with PARTICLE_BATCH
+static const int BATCH_GROUP_SIZE = 64;
+//trajectory, direction gravity, point gravity, swarm motion, none
+static const int BATCH_PHYSIC_COUNT = 5;
+//binding of look_ssbo in the render shaders
+static const int BATCH_LOOK_BINDING = 5;
+//the particle shaders read the emitters from the batch buffers instead of the uniforms
+static const std::string BATCH_DEFINE = "#define PARTICLE_BATCH\n";
+
+static const UniformHandle s_physic("physic");
+static const UniformHandle s_groupOffset("groupOffset");
+
+static int getPhysic(Emitter* emitter)
+{
+	if (emitter->getPhysicTrajectory()) return 0;
+	if (emitter->getPhysicDirectionGravity()) return 1;
+	if (emitter->getPhysicPointGravity()) return 2;
+	if (emitter->getPhysicSwarmCircleMotion()) return 3;
+	return 4;
+}
+
+//the draws are grouped by shader & textures
+static bool renderLess(Emitter* a, Emitter* b)
+{
+	if (a->getUseGeometryShader() != b->getUseGeometryShader())
+		return a->getUseGeometryShader() < b->getUseGeometryShader();
+	if (a->getUseTexture() != b->getUseTexture())
+		return a->getUseTexture() < b->getUseTexture();
+	return a->m_textureList < b->m_textureList;
+}
+
+ParticleBatch::ParticleBatch()
+{
+	m_particleCapacity = 0;
+	m_dispatchCount = 0;
+	m_drawCount = 0;
+	m_buffersLoaded = false;
+	m_particleBuffer = 0;
+	m_aliveBuffer = 0;
+	m_parameterBuffer = 0;
+	m_lookBuffer = 0;
+	m_commandBuffer = 0;
+	m_groupBuffer = 0;
+	m_emitterIndexBuffer = 0;
+	m_vao = 0;
+	m_parameterCapacity = 0;
+	m_lookCapacity = 0;
+	m_commandCapacity = 0;
+	m_groupCapacity = 0;
+	m_emitterIndexCapacity = 0;
+	m_compute = nullptr;
+	m_sort = nullptr;
+	m_pointSprites = nullptr;
+	m_geometryShader = nullptr;
+	m_singleShader = nullptr;
+	m_singleShaderGeom = nullptr;
+	for (int i = 0; i < BATCH_PHYSIC_COUNT; i++)
+	{
+		m_groupOffset[i] = 0;
+		m_groupCount[i] = 0;
+	}
+}
+
+ParticleBatch::~ParticleBatch()
+{
+}
+
+void ParticleBatch::addEffect(Effect* effect)
+{
+	if (!containsEffect(effect))
+		m_effects.push_back(effect);
+}
+
+void ParticleBatch::removeEffect(Effect* effect)
+{
+	auto it = std::find(m_effects.begin(), m_effects.end(), effect);
+	if (it == m_effects.end())
+		return;
+	m_effects.erase(it);
+	releaseRanges(effect);
+}
+
+bool ParticleBatch::containsEffect(Effect* effect)
+{
+	return std::find(m_effects.begin(), m_effects.end(), effect) != m_effects.end();
+}
+
+void ParticleBatch::loadShaders()
+{
+	ShaderManager* shaderManager = ShaderManager::getInstance();
+
+	m_compute = shaderManager->getDefinedComputeProgram(BATCH_DEFINE, "/ParticleSystem/ParticleSystem.comp");
+	m_sort = shaderManager->getComputeProgram("/ParticleSystem/ParticleSystemSort.comp");
+	m_pointSprites = shaderManager->getDefinedProgram(BATCH_DEFINE, "/ParticleSystem/ParticleSystemPointSprites.vert",
+		"/ParticleSystem/ParticleSystemPointSprites.frag");
+	m_geometryShader = shaderManager->getDefinedProgram(BATCH_DEFINE, "/ParticleSystem/ParticleSystemGeometryShader.vert",
+		"/ParticleSystem/ParticleSystemGeometryShader.geom", "/ParticleSystem/ParticleSystemGeometryShader.frag");
+
+	//the same programs as Effect, for the CPU simulation
+	m_singleShader = shaderManager->getProgram("/ParticleSystem/ParticleSystemPointSprites.vert", "/ParticleSystem/ParticleSystemPointSprites.frag");
+	m_singleShaderGeom = shaderManager->getProgram("/ParticleSystem/ParticleSystemGeometryShader.vert",
+		"/ParticleSystem/ParticleSystemGeometryShader.geom", "/ParticleSystem/ParticleSystemGeometryShader.frag");
+}
+
+void ParticleBatch::loadBuffers()
+{
+	glGenBuffers(1, &m_parameterBuffer);
+	glGenBuffers(1, &m_lookBuffer);
+	glGenBuffers(1, &m_commandBuffer);
+	glGenBuffers(1, &m_groupBuffer);
+	glGenBuffers(1, &m_emitterIndexBuffer);
+	glGenVertexArrays(1, &m_vao);
+	m_buffersLoaded = true;
+}
+
+void ParticleBatch::clear()
+{
+	if (m_buffersLoaded)
+	{
+		glDeleteBuffers(1, &m_particleBuffer);
+		glDeleteBuffers(1, &m_aliveBuffer);
+		glDeleteBuffers(1, &m_parameterBuffer);
+		glDeleteBuffers(1, &m_lookBuffer);
+		glDeleteBuffers(1, &m_commandBuffer);
+		glDeleteBuffers(1, &m_groupBuffer);
+		glDeleteBuffers(1, &m_emitterIndexBuffer);
+		glDeleteVertexArrays(1, &m_vao);
+	}
+	m_buffersLoaded = false;
+	m_particleBuffer = 0;
+	m_aliveBuffer = 0;
+	m_particleCapacity = 0;
+	m_parameterCapacity = 0;
+	m_lookCapacity = 0;
+	m_commandCapacity = 0;
+	m_groupCapacity = 0;
+	m_emitterIndexCapacity = 0;
+
+	m_ranges.clear();
+	m_freeRanges.clear();
+	m_items.clear();
+	m_singleEmitters.clear();
+}
+
+void ParticleBatch::reserve(int numberOfParticles)
+{
+	if (!m_buffersLoaded)
+		loadBuffers();
+
+	int freeParticles = 0;
+	for (auto& range : m_freeRanges)
+		freeParticles += range.count;
+	if (freeParticles < numberOfParticles)
+		resizeParticleBuffers(m_particleCapacity + numberOfParticles - freeParticles);
+}
+
+void ParticleBatch::resizeParticleBuffers(int capacity)
+{
+	if (capacity <= m_particleCapacity)
+		return;
+
+	//the particles keep their offsets, the old ones get copied
+	GLuint particleBuffer;
+	glGenBuffers(1, &particleBuffer);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, particleBuffer);
+	glBufferData(GL_COPY_WRITE_BUFFER, capacity * sizeof(ParticleData), NULL, GL_DYNAMIC_COPY);
+	if (m_particleCapacity > 0)
+	{
+		glBindBuffer(GL_COPY_READ_BUFFER, m_particleBuffer);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, m_particleCapacity * sizeof(ParticleData));
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glDeleteBuffers(1, &m_particleBuffer);
+	}
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	m_particleBuffer = particleBuffer;
+
+	//the living particles are written again with every update
+	glDeleteBuffers(1, &m_aliveBuffer);
+	glGenBuffers(1, &m_aliveBuffer);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_aliveBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, capacity * sizeof(glm::vec4), NULL, GL_DYNAMIC_COPY);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	Range added = { m_particleCapacity, capacity - m_particleCapacity };
+	m_particleCapacity = capacity;
+	freeRange(added);
+}
+
+int ParticleBatch::allocateRange(int count)
+{
+	for (size_t i = 0; i < m_freeRanges.size(); i++)
+	{
+		Range& range = m_freeRanges[i];
+		if (range.count >= count)
+		{
+			int offset = range.offset;
+			range.offset += count;
+			range.count -= count;
+			if (range.count == 0)
+				m_freeRanges.erase(m_freeRanges.begin() + i);
+			return offset;
+		}
+	}
+
+	resizeParticleBuffers(std::max(m_particleCapacity * 2, m_particleCapacity + count));
+	return allocateRange(count);
+}
+
+void ParticleBatch::freeRange(Range range)
+{
+	auto it = m_freeRanges.begin();
+	while (it != m_freeRanges.end() && it->offset < range.offset)
+		it++;
+	it = m_freeRanges.insert(it, range);
+
+	//merge with the next & the previous range
+	auto next = it + 1;
+	if (next != m_freeRanges.end() && it->offset + it->count == next->offset)
+	{
+		it->count += next->count;
+		m_freeRanges.erase(next);
+	}
+	if (it != m_freeRanges.begin())
+	{
+		auto previous = it - 1;
+		if (previous->offset + previous->count == it->offset)
+		{
+			previous->count += it->count;
+			m_freeRanges.erase(it);
+		}
+	}
+}
+
+void ParticleBatch::clearRange(Range range)
+{
+	ParticleData deadParticle;
+	deadParticle.position = glm::vec4(0.0, 0.0, 0.0, -1.0);
+	deadParticle.velocity = glm::vec4(0.0, 0.0, 0.0, 0.0);
+	deadParticle.angle = glm::vec4(0.0, 0.0, 0.0, 0.0);
+	std::vector<ParticleData> particles(range.count, deadParticle);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_particleBuffer);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, range.offset * sizeof(ParticleData), range.count * sizeof(ParticleData), particles.data());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+ParticleBatch::Range ParticleBatch::getRange(Emitter* emitter)
+{
+	int count = emitter->getNumMaxParticle();
+	auto it = m_ranges.find(emitter);
+	if (it != m_ranges.end())
+	{
+		if (it->second.count == count)
+			return it->second;
+		//the emitter changed its size
+		freeRange(it->second);
+		m_ranges.erase(it);
+	}
+
+	Range range = { allocateRange(count), count };
+	clearRange(range);
+	m_ranges[emitter] = range;
+	return range;
+}
+
+void ParticleBatch::releaseRanges(Effect* effect)
+{
+	for (auto emitter : *effect->getEmitters())
+	{
+		auto it = m_ranges.find(emitter);
+		if (it != m_ranges.end())
+		{
+			freeRange(it->second);
+			m_ranges.erase(it);
+		}
+	}
+}
+
+bool ParticleBatch::sameRenderState(Emitter* a, Emitter* b)
+{
+	if (a->getUseGeometryShader() != b->getUseGeometryShader() || a->getUseTexture() != b->getUseTexture())
+		return false;
+	return !a->getUseTexture() || a->m_textureList == b->m_textureList;
+}
+
+void ParticleBatch::uploadBuffer(GLenum target, GLuint buffer, int& capacity, const void* data, int size)
+{
+	glBindBuffer(target, buffer);
+	if (size > capacity)
+	{
+		capacity = std::max(size, capacity * 2);
+		glBufferData(target, capacity, NULL, GL_DYNAMIC_DRAW);
+	}
+	if (size > 0)
+		glBufferSubData(target, 0, size, data);
+	glBindBuffer(target, 0);
+}
+
+void ParticleBatch::update(Camera &cam)
+{
+	if (!m_buffersLoaded)
+		loadBuffers();
+	if (m_compute == nullptr)
+		loadShaders();
+
+	glm::vec3 camPosition(cam.getPosition().x, cam.getPosition().y, cam.getPosition().z);
+	m_items.clear();
+	m_singleEmitters.clear();
+	m_dispatchCount = 0;
+
+	for (auto effect : m_effects)
+	{
+		effect->startDelayedEmitters();
+		//fast forward of a culled effect (ParticleSystem::updateLOD), its particles stay in their range
+		if (!effect->isSimulated())
+			continue;
+
+		for (auto emitter : *effect->getEmitters())
+		{
+			if (emitter->getUseCPUSimulation())
+			{
+				emitter->update(nullptr, emitter->getMovable() ? camPosition : glm::vec3(0.0, 0.0, 0.0));
+				if (effect->isVisible())
+					m_singleEmitters.push_back(emitter);
+				continue;
+			}
+			if (emitter->getNumMaxParticle() <= 0)
+				continue;
+
+			glm::vec3 distance = emitter->getPosition() - camPosition;
+
+			BatchItem item;
+			item.emitter = emitter;
+			item.range = getRange(emitter);
+			item.physic = getPhysic(emitter);
+			item.visible = effect->isVisible();
+			item.depth = glm::dot(distance, distance);
+			m_items.push_back(item);
+		}
+	}
+
+	//back to front for the blending. Neighbours with the same shader & textures are one glMultiDrawArraysIndirect,
+	//emitters at the same distance are grouped by render state
+	std::stable_sort(m_items.begin(), m_items.end(),
+		[](const BatchItem& a, const BatchItem& b) { return a.depth != b.depth ? a.depth > b.depth : renderLess(a.emitter, b.emitter); });
+
+	int emitterCount = (int)m_items.size();
+	m_parameters.resize(emitterCount);
+	m_looks.resize(emitterCount);
+	m_commands.assign(4 * emitterCount, 0);
+
+	for (int i = 0; i < emitterCount; i++)
+	{
+		Emitter* emitter = m_items[i].emitter;
+		Range range = m_items[i].range;
+		EmitterUpdate state = emitter->prepareUpdate(emitter->getMovable() ? camPosition : glm::vec3(0.0, 0.0, 0.0));
+
+		int areaFlags = (emitter->getAreaEmittingXY() ? 1 : 0) | (emitter->getAreaEmittingXZ() ? 2 : 0);
+		int movementFlags = (emitter->getPhysicAttMovementVertical() ? 1 : 0) | (emitter->getPhysicAttMovementHorizontalX() ? 2 : 0)
+			| (emitter->getPhysicAttMovementHorizontalZ() ? 4 : 0);
+
+		BatchEmitterParameters& parameters = m_parameters[i];
+		parameters.position = glm::vec4(state.emitterPosition, emitter->getParticleLifetime());
+		parameters.spawnPosition = glm::vec4(state.spawnPosition, emitter->getSpeed());
+		parameters.gravity = state.gravity;
+		parameters.values = glm::vec4(state.deltaTime, emitter->getPhysicAttGravityRange(), emitter->getAreaSize(), 0.0);
+		parameters.range = glm::ivec4(range.offset, range.count, state.spawnOffset, state.spawnCount);
+		parameters.spawn = glm::ivec4((int)state.spawnSeed, emitter->getVelocityType(), emitter->getAreaAccuracy(), areaFlags);
+		parameters.flags = glm::ivec4(emitter->getParticleMortality(), emitter->getPhysicAttGravityFunction(), movementFlags, (int)state.spawnFrame);
+
+		BatchEmitterLook& look = m_looks[i];
+		look.lifetime = glm::vec4(emitter->getParticleLifetime(), emitter->getTexBirthTime(), emitter->getTexDeathTime(), emitter->getTexBlendingTime());
+		look.time = glm::vec4(emitter->blendingTime[0], emitter->blendingTime[1], emitter->blendingTime[2], emitter->blendingTime[3]);
+		look.size = glm::vec4(emitter->getTexParticleDefaultSize() * emitter->getLODSize(), emitter->getRotationSpeed(), 0.0, 0.0);
+		look.flags = glm::ivec4(emitter->getParticleMortality(), emitter->getUseTexture(), emitter->getTexTextureCount(), emitter->getTexUseScaling());
+		look.flags2 = glm::ivec4(emitter->getTexScalingCount(), emitter->getTexRotateLeft(), 0, 0);
+		emitter->getLODScalingData(look.scalingData);
+
+		//count is set by the compute shader, culled emitters are simulated but not drawn
+		m_commands[4 * i + 1] = m_items[i].visible ? 1 : 0;
+		m_commands[4 * i + 2] = range.offset;
+		m_commands[4 * i + 3] = i;
+	}
+
+	//the work groups of every physic are neighbours, so every physic is one dispatch
+	m_groups.clear();
+	for (int physic = 0; physic < BATCH_PHYSIC_COUNT; physic++)
+	{
+		m_groupOffset[physic] = (int)m_groups.size();
+		for (int i = 0; i < emitterCount; i++)
+		{
+			if (m_items[i].physic != physic)
+				continue;
+			for (int first = 0; first < m_items[i].range.count; first += BATCH_GROUP_SIZE)
+				m_groups.push_back(glm::ivec2(i, first));
+		}
+		m_groupCount[physic] = (int)m_groups.size() - m_groupOffset[physic];
+	}
+
+	if (emitterCount == 0)
+		return;
+
+	uploadBuffer(GL_SHADER_STORAGE_BUFFER, m_parameterBuffer, m_parameterCapacity, m_parameters.data(), emitterCount * sizeof(BatchEmitterParameters));
+	uploadBuffer(GL_SHADER_STORAGE_BUFFER, m_lookBuffer, m_lookCapacity, m_looks.data(), emitterCount * sizeof(BatchEmitterLook));
+	uploadBuffer(GL_SHADER_STORAGE_BUFFER, m_commandBuffer, m_commandCapacity, m_commands.data(), (int)m_commands.size() * sizeof(GLuint));
+	uploadBuffer(GL_SHADER_STORAGE_BUFFER, m_groupBuffer, m_groupCapacity, m_groups.data(), (int)m_groups.size() * sizeof(glm::ivec2));
+
+	m_compute->bind();
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_particleBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_aliveBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_parameterBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_groupBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, m_commandBuffer);
+
+	for (int physic = 0; physic < BATCH_PHYSIC_COUNT; physic++)
+	{
+		if (m_groupCount[physic] == 0)
+			continue;
+		m_compute->sendInt(s_physic, physic);
+		m_compute->sendInt(s_groupOffset, m_groupOffset[physic]);
+		glDispatchCompute(m_groupCount[physic], 1, 1);
+		m_dispatchCount++;
+	}
+	glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+
+	for (int binding = 0; binding < 5; binding++)
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, 0);
+	m_compute->unbind();
+
+	//back to front order inside the range of an emitter
+	for (int i = 0; i < emitterCount; i++)
+	{
+		if (m_items[i].visible && m_items[i].emitter->getDepthSort())
+			ParticleSort::sortByDepth(m_sort, camPosition, m_aliveBuffer, m_commandBuffer, m_items[i].range.offset, i, m_items[i].range.count);
+	}
+}
+
+void ParticleBatch::render(Camera &cam)
+{
+	m_drawCount = 0;
+	int emitterCount = (int)m_items.size();
+
+	if (emitterCount > 0)
+	{
+		//the instanced emitter index of the draws: baseInstance + 0
+		if (emitterCount > m_emitterIndexCapacity)
+		{
+			std::vector<GLint> indices(emitterCount);
+			for (int i = 0; i < emitterCount; i++)
+				indices[i] = i;
+			glBindBuffer(GL_ARRAY_BUFFER, m_emitterIndexBuffer);
+			glBufferData(GL_ARRAY_BUFFER, emitterCount * sizeof(GLint), indices.data(), GL_STATIC_DRAW);
+			m_emitterIndexCapacity = emitterCount;
+		}
+
+		glBindVertexArray(m_vao);
+		glBindBuffer(GL_ARRAY_BUFFER, m_aliveBuffer);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, 0);
+		glBindBuffer(GL_ARRAY_BUFFER, m_emitterIndexBuffer);
+		glEnableVertexAttribArray(1);
+		glVertexAttribIPointer(1, 1, GL_INT, 0, 0);
+		glVertexAttribDivisor(1, 1);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BATCH_LOOK_BINDING, m_lookBuffer);
+
+		glDepthMask(GL_FALSE);
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		ShaderProgram* boundShader = nullptr;
+		int first = 0;
+		while (first < emitterCount)
+		{
+			Emitter* emitter = m_items[first].emitter;
+			int last = first + 1;
+			while (last < emitterCount && sameRenderState(emitter, m_items[last].emitter))
+				last++;
+
+			bool useTexture = emitter->getUseTexture();
+			bool useGeometryShader = !emitter->getUsePointSprites();
+			if (useGeometryShader && !useTexture)
+			{
+				perror("Problem in ParticleBatch.cpp: Geometry Shader maybe miss a texture");
+				first = last;
+				continue;
+			}
+
+			ShaderProgram* shader = useGeometryShader ? m_geometryShader : m_pointSprites;
+			if (shader != boundShader)
+			{
+				shader->bind();
+				shader->sendMat4(Uniforms::viewMatrix, cam.getViewMatrix());
+				shader->sendMat4(Uniforms::projectionMatrix, cam.getProjectionMatrix());
+				if (useGeometryShader)
+					shader->sendVec4(Uniforms::camPos, cam.getPosition());
+				boundShader = shader;
+			}
+
+			if (useTexture)
+			{
+				if (!useGeometryShader)
+				{
+					glEnable(GL_POINT_SPRITE);
+					glTexEnvi(GL_POINT_SPRITE, GL_COORD_REPLACE, GL_TRUE);
+					glEnable(GL_PROGRAM_POINT_SIZE);
+				}
+				for (int i = 0; i < (int)emitter->m_textureList.size() && i < 4; i++)
+				{
+					shader->sendSampler2D(Uniforms::particleTextures[i], emitter->m_textureList.at(i)->getTexture(), i + 1);
+				}
+			}
+
+			glMultiDrawArraysIndirect(GL_POINTS, (void*)(first * 4 * sizeof(GLuint)), last - first, 0);
+			m_drawCount++;
+			first = last;
+		}
+
+		if (boundShader != nullptr)
+			boundShader->unbind();
+		glDepthMask(GL_TRUE);
+		glDisable(GL_BLEND);
+
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BATCH_LOOK_BINDING, 0);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+		glVertexAttribDivisor(1, 0);
+		glDisableVertexAttribArray(1);
+		glDisableVertexAttribArray(0);
+		glBindVertexArray(0);
+	}
+
+	for (auto emitter : m_singleEmitters)
+	{
+		emitter->render(emitter->getUseGeometryShader() ? m_singleShaderGeom : m_singleShader, cam);
+		m_drawCount++;
+	}
+}
+
+int ParticleBatch::getEmitterCount()
+{
+	return (int)(m_items.size() + m_singleEmitters.size());
+}
+
+int ParticleBatch::getDispatchCount()
+{
+	return m_dispatchCount;
+}
+
+int ParticleBatch::getDrawCount()
+{
+	return m_drawCount;
+}
+
+int ParticleBatch::getParticleCapacity()
+{
+	return m_particleCapacity;
+}
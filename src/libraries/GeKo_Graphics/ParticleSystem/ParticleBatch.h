@@ -0,0 +1,127 @@
+#pragma once
+#include <map>
+#include <vector>
+#include "GeKo_Graphics/ParticleSystem/Effect.h"
+
+///Parameters of one emitter for ParticleSystem.comp with PARTICLE_BATCH, std430 layout
+struct BatchEmitterParameters{
+	glm::vec4 position;		//xyz emitter position, fullLifetime
+	glm::vec4 spawnPosition;	//xyz spawn position, spawn speed
+	glm::vec4 gravity;		//xyz gravity position or direction, gravity strength
+	glm::vec4 values;		//deltaTime, gravityRange, areaSize
+	glm::ivec4 range;		//particle offset, particle count, spawn offset, spawn count
+	glm::ivec4 spawn;		//spawn seed, velocity type, area accuracy, area flags (1 XY, 2 XZ)
+	glm::ivec4 flags;		//particleMortal, gravityFunc, movement flags (1 vertical, 2 horizontal X, 4 horizontal Z), spawn frame
+};
+
+///Look of one emitter for the batch render shaders, std430 layout
+struct BatchEmitterLook{
+	glm::vec4 lifetime;		//fullLifetime, birthTime, deathTime, blendingTime
+	glm::vec4 time;			//blending moments of the textures
+	glm::vec4 size;			//size, rotationSpeed
+	glm::ivec4 flags;		//particleMortal, useTexture, textureCount, useScaling
+	glm::ivec4 flags2;		//scalingCount, rotateLeft
+	float scalingData[32];
+};
+
+/*
+Description:
+Updates & renders the emitters of many effects together. All particles live in shared buffers, every emitter gets a range of them.
+The parameters & looks of all emitters are uploaded once per frame, ParticleSystem.comp (with PARTICLE_BATCH) is dispatched once per physic.
+The emitters are sorted back to front when the frame is built, neighbours with the same shader & texture set are one glMultiDrawArraysIndirect.
+Effects loaded from the same file share their textures (TextureManager), so instances of an effect next to each other are one draw.
+
+The emitters of the batch don't use their own buffers. Emitters with the CPU simulation are updated & rendered one by one, like in Effect.
+The Effects stay owned by the caller, remove them before they get deleted. The shared buffers belong to the batch and are
+deleted by clear(), not by the destructor.
+*/
+class ParticleBatch{
+public:
+	ParticleBatch();
+	~ParticleBatch();
+
+	void addEffect(Effect* effect);
+	void removeEffect(Effect* effect);
+	bool containsEffect(Effect* effect);
+
+	///Reserves the shared buffers for this number of particles, so adding effects doesn't resize them. Needs the GL context
+	void reserve(int numberOfParticles);
+
+	void update(Camera &cam);
+	void render(Camera &cam);
+
+	///Deletes the buffers, needs the GL context
+	void clear();
+
+	//statistics of the last frame
+	int getEmitterCount();
+	int getDispatchCount();
+	int getDrawCount();
+	int getParticleCapacity();
+
+private:
+	struct Range{
+		int offset;
+		int count;
+	};
+
+	//one emitter of the last update, sorted back to front & by render state
+	struct BatchItem{
+		Emitter* emitter;
+		Range range;
+		int physic;
+		bool visible;
+		float depth;	//squared distance to the camera
+	};
+
+	void loadShaders();
+	void loadBuffers();
+	void resizeParticleBuffers(int capacity);
+	int allocateRange(int count);
+	void freeRange(Range range);
+	void clearRange(Range range);
+	Range getRange(Emitter* emitter);
+	void releaseRanges(Effect* effect);
+	bool sameRenderState(Emitter* a, Emitter* b);
+	void uploadBuffer(GLenum target, GLuint buffer, int& capacity, const void* data, int size);
+
+	std::vector<Effect*> m_effects;
+	std::map<Emitter*, Range> m_ranges;
+	std::vector<Range> m_freeRanges;	//sorted by offset
+	int m_particleCapacity;
+
+	std::vector<BatchItem> m_items;
+	std::vector<Emitter*> m_singleEmitters;	//CPU simulation
+	int m_dispatchCount;
+	int m_drawCount;
+
+	//per frame data
+	std::vector<BatchEmitterParameters> m_parameters;
+	std::vector<BatchEmitterLook> m_looks;
+	std::vector<GLuint> m_commands;		//DrawArraysIndirectCommand: count, instanceCount, first, baseInstance
+	std::vector<glm::ivec2> m_groups;	//emitter & first particle of every work group, ordered by physic
+	int m_groupOffset[5];
+	int m_groupCount[5];
+
+	bool m_buffersLoaded;
+	GLuint m_particleBuffer;
+	GLuint m_aliveBuffer;
+	GLuint m_parameterBuffer;
+	GLuint m_lookBuffer;
+	GLuint m_commandBuffer;
+	GLuint m_groupBuffer;
+	GLuint m_emitterIndexBuffer;	//0, 1, 2, .. the instanced vertex attribute of the emitter
+	GLuint m_vao;
+	int m_parameterCapacity;
+	int m_lookCapacity;
+	int m_commandCapacity;
+	int m_groupCapacity;
+	int m_emitterIndexCapacity;
+
+	ShaderProgram* m_compute;
+	ShaderProgram* m_sort;
+	ShaderProgram* m_pointSprites;
+	ShaderProgram* m_geometryShader;
+	ShaderProgram* m_singleShader;
+	ShaderProgram* m_singleShaderGeom;
+};
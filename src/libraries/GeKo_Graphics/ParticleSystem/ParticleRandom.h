@@ -0,0 +1,157 @@
+#pragma once
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GEKO_RANDOM_SSE2
+#include <emmintrin.h>
+#endif
+
+/*
+Description:
+Counter based random numbers (Philox4x32-10) for the spawning of particles. A number only depends on
+(emitter seed, particle index, frame, stream), there is no state: every particle draws its numbers on its own,
+in any order, on any thread, and the same effect plays the same way every time.
+
+The shaders use the same functions (src/shaders/ParticleSystem/ParticleRandom.glsl), the CPU simulation and
+the compute shader spawn the same particles. uniform4 does 4 particles at once with SSE2 and gives the same numbers.
+
+Streams of a spawned particle:
+-0: xyz direction (see direction), w x of the area emitting
+-1: x y, y z of the area emitting
+*/
+namespace ParticleRandom
+{
+	struct Counter
+	{
+		uint32_t x, y, z, w;
+	};
+
+	static const uint32_t PHILOX_M0 = 0xD2511F53u;
+	static const uint32_t PHILOX_M1 = 0xCD9E8D57u;
+	static const uint32_t PHILOX_W0 = 0x9E3779B9u;
+	static const uint32_t PHILOX_W1 = 0xBB67AE85u;
+	//the second half of the key, the first is the emitter seed
+	static const uint32_t PHILOX_KEY1 = 0x8F1BBCDCu;
+	static const int PHILOX_ROUNDS = 10;
+
+	inline Counter philox(Counter counter, uint32_t key0, uint32_t key1)
+	{
+		for (int i = 0; i < PHILOX_ROUNDS; i++)
+		{
+			uint64_t product0 = (uint64_t)PHILOX_M0 * counter.x;
+			uint64_t product1 = (uint64_t)PHILOX_M1 * counter.z;
+			Counter next;
+			next.x = (uint32_t)(product1 >> 32) ^ counter.y ^ key0;
+			next.y = (uint32_t)product1;
+			next.z = (uint32_t)(product0 >> 32) ^ counter.w ^ key1;
+			next.w = (uint32_t)product0;
+			counter = next;
+			key0 += PHILOX_W0;
+			key1 += PHILOX_W1;
+		}
+		return counter;
+	}
+
+	///24 bit: 0 .. 1 (excluded), exact in float
+	inline float toFloat(uint32_t bits)
+	{
+		return (float)(bits >> 8) * (1.0f / 16777216.0f);
+	}
+
+	///4 numbers 0 .. 1 of a particle
+	inline glm::vec4 uniform(uint32_t seed, uint32_t index, uint32_t frame, uint32_t stream)
+	{
+		Counter counter = { index, frame, stream, 0u };
+		Counter bits = philox(counter, seed, PHILOX_KEY1);
+		return glm::vec4(toFloat(bits.x), toFloat(bits.y), toFloat(bits.z), toFloat(bits.w));
+	}
+
+#ifdef GEKO_RANDOM_SSE2
+	//high & low 32 bit of the products of the 4 lanes
+	inline void mulHiLo(__m128i a, uint32_t b, __m128i& hi, __m128i& lo)
+	{
+		__m128i factor = _mm_set1_epi32((int)b);
+		__m128i even = _mm_mul_epu32(a, factor);
+		__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), factor);
+		lo = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+		hi = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 3, 1)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 3, 1)));
+	}
+#endif
+
+	///The numbers of 4 particles at once, out[component][particle]
+	inline void uniform4(uint32_t seed, const uint32_t index[4], uint32_t frame, uint32_t stream, float out[4][4])
+	{
+#ifdef GEKO_RANDOM_SSE2
+		__m128i x = _mm_setr_epi32((int)index[0], (int)index[1], (int)index[2], (int)index[3]);
+		__m128i y = _mm_set1_epi32((int)frame);
+		__m128i z = _mm_set1_epi32((int)stream);
+		__m128i w = _mm_setzero_si128();
+		uint32_t key0 = seed;
+		uint32_t key1 = PHILOX_KEY1;
+
+		for (int i = 0; i < PHILOX_ROUNDS; i++)
+		{
+			__m128i hi0, lo0, hi1, lo1;
+			mulHiLo(x, PHILOX_M0, hi0, lo0);
+			mulHiLo(z, PHILOX_M1, hi1, lo1);
+			x = _mm_xor_si128(_mm_xor_si128(hi1, y), _mm_set1_epi32((int)key0));
+			y = lo1;
+			z = _mm_xor_si128(_mm_xor_si128(hi0, w), _mm_set1_epi32((int)key1));
+			w = lo0;
+			key0 += PHILOX_W0;
+			key1 += PHILOX_W1;
+		}
+
+		const __m128 scale = _mm_set1_ps(1.0f / 16777216.0f);
+		_mm_storeu_ps(out[0], _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(x, 8)), scale));
+		_mm_storeu_ps(out[1], _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(y, 8)), scale));
+		_mm_storeu_ps(out[2], _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(z, 8)), scale));
+		_mm_storeu_ps(out[3], _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(w, 8)), scale));
+#else
+		for (int particle = 0; particle < 4; particle++)
+		{
+			glm::vec4 numbers = uniform(seed, index[particle], frame, stream);
+			out[0][particle] = numbers.x;
+			out[1][particle] = numbers.y;
+			out[2][particle] = numbers.z;
+			out[3][particle] = numbers.w;
+		}
+#endif
+	}
+
+	///-1 .. 1 with a certain comma accuracy (2 * accuracy + 1 steps), the area emitting of the Emitter
+	inline float area(float u, int accuracy)
+	{
+		if (accuracy <= 0)
+			return 0.0f;
+		float steps = (float)(2 * accuracy + 1);
+		float step = glm::min(glm::floor(u * steps), steps - 1.0f);
+		return (step - (float)accuracy) / (float)accuracy;
+	}
+
+	///A normalized direction of the velocity type (see Emitter::setVelocity), u are 3 numbers 0 .. 1
+	inline glm::vec3 direction(glm::vec3 u, int velocityType)
+	{
+		glm::vec3 direction(0.0f, 0.0f, 0.0f);
+		switch (velocityType)
+		{
+		case 1: direction = glm::vec3(u.x - 1.0f, u.y, 0.0f); break;	//LeftQuarterCircle
+		case 2: direction = glm::vec3(u.x, u.y, 0.0f); break;	//RightQuarterCircle
+		case 3: direction = glm::vec3(2.0f * u.x - 1.0f, u.y, 0.0f); break;	//SemiCircle
+		case 4: direction = glm::vec3(2.0f * u.x - 1.0f, 2.0f * u.y - 1.0f, 0.0f); break;	//Circle
+		case 5: direction = glm::vec3(2.0f * u.x - 1.0f, u.y, 2.0f * u.z - 1.0f); break;	//SemiSphere
+		case 6: direction = glm::vec3(2.0f * u.x - 1.0f, 2.0f * u.y - 1.0f, 2.0f * u.z - 1.0f); break;	//Sphere
+		}
+		if (glm::length(direction) != 0.0f)
+			direction = glm::normalize(direction);
+		return direction;
+	}
+
+	///A well mixed seed of a number, e.g. a counter of emitters
+	inline uint32_t hashSeed(uint32_t value)
+	{
+		Counter counter = { value, 0u, 0u, 0u };
+		return philox(counter, 0u, PHILOX_KEY1).x;
+	}
+}
@@ -0,0 +1,353 @@
+#include "ParticleSimulationCPU.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <thread>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define GEKO_PARTICLE_SSE
+#include <xmmintrin.h>
+#endif
+
+#define PI 3.14159f
+
+ParticleSimulationCPU::ParticleSimulationCPU()
+{
+	m_numberOfParticles = 0;
+	m_paddedNumberOfParticles = 0;
+	m_threadCount = 1;
+	m_useSIMD = true;
+}
+
+ParticleSimulationCPU::~ParticleSimulationCPU()
+{
+}
+
+void ParticleSimulationCPU::resize(int numberOfParticles, glm::vec3 emitterPosition)
+{
+	m_numberOfParticles = std::max(numberOfParticles, 0);
+	m_paddedNumberOfParticles = (m_numberOfParticles + 3) & ~3;
+
+	m_positionX.assign(m_paddedNumberOfParticles, emitterPosition.x);
+	m_positionY.assign(m_paddedNumberOfParticles, emitterPosition.y);
+	m_positionZ.assign(m_paddedNumberOfParticles, emitterPosition.z);
+	m_lifetime.assign(m_paddedNumberOfParticles, -1.0f);
+
+	m_directionX.assign(m_paddedNumberOfParticles, 0.0f);
+	m_directionY.assign(m_paddedNumberOfParticles, 0.0f);
+	m_directionZ.assign(m_paddedNumberOfParticles, 0.0f);
+	m_speed.assign(m_paddedNumberOfParticles, 0.0f);
+
+	m_trajectoryX.assign(m_paddedNumberOfParticles, 0.0f);
+	m_trajectoryY.assign(m_paddedNumberOfParticles, 0.0f);
+	m_trajectoryZ.assign(m_paddedNumberOfParticles, 0.0f);
+}
+
+void ParticleSimulationCPU::emit(int index, glm::vec3 position, float lifetime, glm::vec3 direction, float speed, float phi, float theta)
+{
+	if (index < 0 || index >= m_numberOfParticles)
+		return;
+
+	m_positionX[index] = position.x;
+	m_positionY[index] = position.y;
+	m_positionZ[index] = position.z;
+	m_lifetime[index] = lifetime;
+
+	m_directionX[index] = direction.x;
+	m_directionY[index] = direction.y;
+	m_directionZ[index] = direction.z;
+	m_speed[index] = speed;
+
+	//the compute shader converts the angles every frame, we do it once
+	float phiRadians = glm::radians(phi);
+	float thetaRadians = glm::radians(theta);
+	m_trajectoryX[index] = cos(thetaRadians) * cos(phiRadians);
+	m_trajectoryY[index] = sin(thetaRadians);
+	m_trajectoryZ[index] = cos(thetaRadians) * sin(phiRadians);
+}
+
+void ParticleSimulationCPU::update(const ParticleSimulationParameters& parameters)
+{
+	if (m_paddedNumberOfParticles == 0)
+		return;
+
+	int threadCount = std::min(m_threadCount, m_paddedNumberOfParticles / 4);
+	if (threadCount <= 1){
+		updateRange(parameters, 0, m_paddedNumberOfParticles);
+		return;
+	}
+
+	//every thread gets a range which is a multiple of 4, the calling thread takes the first one
+	int rangeSize = ((m_paddedNumberOfParticles / threadCount) + 3) & ~3;
+	std::vector<std::thread> threads;
+	for (int begin = rangeSize; begin < m_paddedNumberOfParticles; begin += rangeSize){
+		int end = std::min(begin + rangeSize, m_paddedNumberOfParticles);
+		threads.push_back(std::thread(&ParticleSimulationCPU::updateRange, this, std::cref(parameters), begin, end));
+	}
+	updateRange(parameters, 0, std::min(rangeSize, m_paddedNumberOfParticles));
+
+	for (auto& thread : threads)
+		thread.join();
+}
+
+void ParticleSimulationCPU::writePositions(std::vector<glm::vec4>& positions)
+{
+	positions.resize(m_numberOfParticles);
+	for (int i = 0; i < m_numberOfParticles; i++)
+	{
+		positions[i] = glm::vec4(m_positionX[i], m_positionY[i], m_positionZ[i], m_lifetime[i]);
+	}
+}
+
+int ParticleSimulationCPU::getNumberOfParticles()
+{
+	return m_numberOfParticles;
+}
+
+void ParticleSimulationCPU::setThreadCount(int threadCount)
+{
+	m_threadCount = std::max(threadCount, 1);
+}
+
+int ParticleSimulationCPU::getThreadCount()
+{
+	return m_threadCount;
+}
+
+void ParticleSimulationCPU::setUseSIMD(bool useSIMD)
+{
+	m_useSIMD = useSIMD;
+}
+
+bool ParticleSimulationCPU::getUseSIMD()
+{
+	return m_useSIMD;
+}
+
+bool ParticleSimulationCPU::isSIMDAvailable()
+{
+#ifdef GEKO_PARTICLE_SSE
+	return true;
+#else
+	return false;
+#endif
+}
+
+void ParticleSimulationCPU::updateRange(const ParticleSimulationParameters& parameters, int begin, int end)
+{
+	//sin & cos have no SSE instruction, these modes use the scalar code
+	bool needsTrigonometry = parameters.useChaoticSwarmMotion || (parameters.usePointGravity && parameters.gravityFunction == 3);
+
+	if (isSIMDAvailable() && m_useSIMD && !needsTrigonometry)
+		updateRangeSIMD(parameters, begin, end);
+	else
+		updateRangeScalar(parameters, begin, end);
+}
+
+//the same physic as ParticleSystem.comp, one particle after another
+void ParticleSimulationCPU::updateRangeScalar(const ParticleSimulationParameters& parameters, int begin, int end)
+{
+	const glm::vec3& emitterPosition = parameters.emitterPosition;
+	const glm::vec4& gravity = parameters.gravity;
+	float deltaTime = parameters.deltaTime;
+
+	for (int i = begin; i < end; i++)
+	{
+		if (m_lifetime[i] > 0.0f || !parameters.particleMortal){
+
+			//trajectory, the gravity direction is 0/-1/0
+			if (parameters.useTrajectory){
+				float lifetime = parameters.fullLifetime - m_lifetime[i];
+				float distance = m_speed[i] * lifetime;
+
+				m_positionX[i] = distance * m_trajectoryX[i] + emitterPosition.x;
+				m_positionZ[i] = distance * m_trajectoryZ[i] + emitterPosition.z;
+				m_positionY[i] = distance * m_trajectoryY[i] + 0.5f * (-gravity.w) * lifetime * lifetime + emitterPosition.y;
+			}
+
+			//constant speed, the direction gets bent by the gravity
+			else if (parameters.useDirectionGravity){
+				float step = m_speed[i] * deltaTime;
+				m_positionX[i] += m_directionX[i] * step;
+				m_positionY[i] += m_directionY[i] * step;
+				m_positionZ[i] += m_directionZ[i] * step;
+
+				m_directionX[i] += gravity.x * gravity.w * deltaTime;
+				m_directionY[i] += gravity.y * gravity.w * deltaTime;
+				m_directionZ[i] += gravity.z * gravity.w * deltaTime;
+
+				float length = sqrt(m_directionX[i] * m_directionX[i] + m_directionY[i] * m_directionY[i] + m_directionZ[i] * m_directionZ[i]);
+				if (length != 0.0f){
+					m_directionX[i] /= length;
+					m_directionY[i] /= length;
+					m_directionZ[i] /= length;
+				}
+			}
+
+			//gravity is a position. 0=linear, 1=const, 2=x^4, 3=cos
+			else if (parameters.usePointGravity){
+				float distanceX = gravity.x - m_positionX[i];
+				float distanceY = gravity.y - m_positionY[i];
+				float distanceZ = gravity.z - m_positionZ[i];
+				float distanceValue = sqrt(distanceX * distanceX + distanceY * distanceY + distanceZ * distanceZ);
+				float distanceFactor = std::min(std::max(parameters.gravityRange - distanceValue, 0.0f) / parameters.gravityRange, 1.0f);
+
+				if (parameters.gravityFunction == 1)
+					distanceFactor = ceil(distanceFactor);
+				else if (parameters.gravityFunction == 2)
+					distanceFactor = distanceFactor * distanceFactor * distanceFactor * distanceFactor;
+				else if (parameters.gravityFunction == 3)
+					distanceFactor = cos(distanceFactor * PI * 2) + 1.01f;
+
+				float step = m_speed[i] * deltaTime;
+				m_positionX[i] += m_directionX[i] * step;
+				m_positionY[i] += m_directionY[i] * step;
+				m_positionZ[i] += m_directionZ[i] * step;
+
+				m_directionX[i] = (m_directionX[i] + distanceFactor * distanceX * gravity.w * deltaTime) / 1.01f;
+				m_directionY[i] = (m_directionY[i] + distanceFactor * distanceY * gravity.w * deltaTime) / 1.01f;
+				m_directionZ[i] = (m_directionZ[i] + distanceFactor * distanceZ * gravity.w * deltaTime) / 1.01f;
+			}
+
+			//circle/sphere motion
+			else if (parameters.useChaoticSwarmMotion){
+				if (parameters.movementHorizontalX)
+					m_positionX[i] += sin(m_lifetime[i]) * deltaTime / m_speed[i];
+				if (parameters.movementVertical)
+					m_positionY[i] += cos(m_lifetime[i]) * deltaTime / m_speed[i];
+				if (parameters.movementHorizontalZ)
+					m_positionZ[i] += cos(m_lifetime[i]) * deltaTime / m_speed[i];
+			}
+
+			if (parameters.particleMortal)
+				m_lifetime[i] -= deltaTime;
+		}
+		else{
+			m_positionX[i] = emitterPosition.x;
+			m_positionY[i] = emitterPosition.y;
+			m_positionZ[i] = emitterPosition.z;
+			m_lifetime[i] = -1.0f;
+
+			m_directionX[i] = 0.0f;
+			m_directionY[i] = 0.0f;
+			m_directionZ[i] = 0.0f;
+			m_speed[i] = 0.0f;
+		}
+	}
+}
+
+#ifdef GEKO_PARTICLE_SSE
+//mask ? a : b
+static inline __m128 select(__m128 mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+#endif
+
+//the same as updateRangeScalar, but for 4 particles at once. begin & end are multiples of 4
+void ParticleSimulationCPU::updateRangeSIMD(const ParticleSimulationParameters& parameters, int begin, int end)
+{
+#ifdef GEKO_PARTICLE_SSE
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 dead = _mm_set1_ps(-1.0f);
+	const __m128 deltaTime = _mm_set1_ps(parameters.deltaTime);
+	const __m128 emitterX = _mm_set1_ps(parameters.emitterPosition.x);
+	const __m128 emitterY = _mm_set1_ps(parameters.emitterPosition.y);
+	const __m128 emitterZ = _mm_set1_ps(parameters.emitterPosition.z);
+	const __m128 fullLifetime = _mm_set1_ps(parameters.fullLifetime);
+	const __m128 immortal = parameters.particleMortal ? zero : _mm_cmpeq_ps(zero, zero);
+
+	const __m128 gravityX = _mm_set1_ps(parameters.gravity.x);
+	const __m128 gravityY = _mm_set1_ps(parameters.gravity.y);
+	const __m128 gravityZ = _mm_set1_ps(parameters.gravity.z);
+	const __m128 halfGravity = _mm_set1_ps(0.5f * -parameters.gravity.w);
+	const __m128 gravityStep = _mm_set1_ps(parameters.gravity.w * parameters.deltaTime);
+	const __m128 gravityRange = _mm_set1_ps(parameters.gravityRange);
+	const __m128 damping = _mm_set1_ps(1.01f);
+
+	for (int i = begin; i < end; i += 4)
+	{
+		__m128 lifetime = _mm_loadu_ps(&m_lifetime[i]);
+		__m128 alive = _mm_or_ps(_mm_cmpgt_ps(lifetime, zero), immortal);
+
+		__m128 positionX = _mm_loadu_ps(&m_positionX[i]);
+		__m128 positionY = _mm_loadu_ps(&m_positionY[i]);
+		__m128 positionZ = _mm_loadu_ps(&m_positionZ[i]);
+		__m128 directionX = _mm_loadu_ps(&m_directionX[i]);
+		__m128 directionY = _mm_loadu_ps(&m_directionY[i]);
+		__m128 directionZ = _mm_loadu_ps(&m_directionZ[i]);
+		__m128 speed = _mm_loadu_ps(&m_speed[i]);
+
+		if (parameters.useTrajectory){
+			__m128 time = _mm_sub_ps(fullLifetime, lifetime);
+			__m128 distance = _mm_mul_ps(speed, time);
+
+			positionX = _mm_add_ps(_mm_mul_ps(distance, _mm_loadu_ps(&m_trajectoryX[i])), emitterX);
+			positionZ = _mm_add_ps(_mm_mul_ps(distance, _mm_loadu_ps(&m_trajectoryZ[i])), emitterZ);
+			positionY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(distance, _mm_loadu_ps(&m_trajectoryY[i])),
+				_mm_mul_ps(halfGravity, _mm_mul_ps(time, time))), emitterY);
+		}
+		else if (parameters.useDirectionGravity){
+			__m128 step = _mm_mul_ps(speed, deltaTime);
+			positionX = _mm_add_ps(positionX, _mm_mul_ps(directionX, step));
+			positionY = _mm_add_ps(positionY, _mm_mul_ps(directionY, step));
+			positionZ = _mm_add_ps(positionZ, _mm_mul_ps(directionZ, step));
+
+			directionX = _mm_add_ps(directionX, _mm_mul_ps(gravityX, gravityStep));
+			directionY = _mm_add_ps(directionY, _mm_mul_ps(gravityY, gravityStep));
+			directionZ = _mm_add_ps(directionZ, _mm_mul_ps(gravityZ, gravityStep));
+
+			__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(directionX, directionX), _mm_mul_ps(directionY, directionY)), _mm_mul_ps(directionZ, directionZ)));
+			__m128 notZero = _mm_cmpneq_ps(length, zero);
+			__m128 inverseLength = _mm_div_ps(one, select(notZero, length, one));
+			directionX = _mm_mul_ps(directionX, inverseLength);
+			directionY = _mm_mul_ps(directionY, inverseLength);
+			directionZ = _mm_mul_ps(directionZ, inverseLength);
+		}
+		else if (parameters.usePointGravity){
+			__m128 distanceX = _mm_sub_ps(gravityX, positionX);
+			__m128 distanceY = _mm_sub_ps(gravityY, positionY);
+			__m128 distanceZ = _mm_sub_ps(gravityZ, positionZ);
+			__m128 distanceValue = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(distanceX, distanceX), _mm_mul_ps(distanceY, distanceY)), _mm_mul_ps(distanceZ, distanceZ)));
+			__m128 distanceFactor = _mm_min_ps(_mm_div_ps(_mm_max_ps(_mm_sub_ps(gravityRange, distanceValue), zero), gravityRange), one);
+
+			if (parameters.gravityFunction == 1){
+				//ceil of a value in [0,1]
+				distanceFactor = _mm_and_ps(_mm_cmpgt_ps(distanceFactor, zero), one);
+			}
+			else if (parameters.gravityFunction == 2){
+				distanceFactor = _mm_mul_ps(distanceFactor, distanceFactor);
+				distanceFactor = _mm_mul_ps(distanceFactor, distanceFactor);
+			}
+
+			__m128 step = _mm_mul_ps(speed, deltaTime);
+			positionX = _mm_add_ps(positionX, _mm_mul_ps(directionX, step));
+			positionY = _mm_add_ps(positionY, _mm_mul_ps(directionY, step));
+			positionZ = _mm_add_ps(positionZ, _mm_mul_ps(directionZ, step));
+
+			__m128 pull = _mm_mul_ps(distanceFactor, gravityStep);
+			directionX = _mm_div_ps(_mm_add_ps(directionX, _mm_mul_ps(pull, distanceX)), damping);
+			directionY = _mm_div_ps(_mm_add_ps(directionY, _mm_mul_ps(pull, distanceY)), damping);
+			directionZ = _mm_div_ps(_mm_add_ps(directionZ, _mm_mul_ps(pull, distanceZ)), damping);
+		}
+
+		if (parameters.particleMortal)
+			lifetime = _mm_sub_ps(lifetime, deltaTime);
+
+		//dead particles wait at the emitter
+		_mm_storeu_ps(&m_positionX[i], select(alive, positionX, emitterX));
+		_mm_storeu_ps(&m_positionY[i], select(alive, positionY, emitterY));
+		_mm_storeu_ps(&m_positionZ[i], select(alive, positionZ, emitterZ));
+		_mm_storeu_ps(&m_lifetime[i], select(alive, lifetime, dead));
+		_mm_storeu_ps(&m_directionX[i], _mm_and_ps(alive, directionX));
+		_mm_storeu_ps(&m_directionY[i], _mm_and_ps(alive, directionY));
+		_mm_storeu_ps(&m_directionZ[i], _mm_and_ps(alive, directionZ));
+		_mm_storeu_ps(&m_speed[i], _mm_and_ps(alive, speed));
+	}
+#else
+	updateRangeScalar(parameters, begin, end);
+#endif
+}
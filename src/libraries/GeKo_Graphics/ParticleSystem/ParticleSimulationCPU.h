@@ -0,0 +1,94 @@
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+
+///All values one simulation step of an Emitter needs, the same as the uniforms of ParticleSystem.comp
+struct ParticleSimulationParameters{
+	float deltaTime;
+	glm::vec3 emitterPosition;
+	float fullLifetime;
+	bool particleMortal;
+
+	glm::vec4 gravity;	//xyz gravity direction/position, w strength
+	float gravityRange;
+	int gravityFunction;
+
+	bool useTrajectory;
+	bool useDirectionGravity;
+	bool usePointGravity;
+	bool useChaoticSwarmMotion;
+
+	bool movementVertical;
+	bool movementHorizontalX;
+	bool movementHorizontalZ;
+};
+
+/*
+Description:
+CPU backend of the particle simulation. Does the same physic as ParticleSystem.comp, so an Emitter can run without a compute shader
+(or without any OpenGL context, e.g. for benchmarks).
+
+The particles are stored as structure of arrays, 4 particles are updated at once with SSE if the compiler supports it.
+The number of particles is padded to a multiple of 4, the padding is simulated but never written out.
+
+Tipps:
+-Threads only pay off for big emitters, every update starts and joins its threads.
+-Point gravity with the cosinus function and the swarm motion need sin/cos and run with the scalar code.
+*/
+class ParticleSimulationCPU{
+public:
+	ParticleSimulationCPU();
+	~ParticleSimulationCPU();
+
+	///Sets the number of particles, all particles are dead and at the emitterPosition afterwards
+	void resize(int numberOfParticles, glm::vec3 emitterPosition);
+
+	///Spawns a particle at the index. phi & theta are the angles (degree) of the trajectory
+	void emit(int index, glm::vec3 position, float lifetime, glm::vec3 direction, float speed, float phi, float theta);
+
+	///Simulates one step of all particles
+	void update(const ParticleSimulationParameters& parameters);
+
+	///Writes xyz position & remaining lifetime of every particle, the layout of the position SSBO
+	void writePositions(std::vector<glm::vec4>& positions);
+
+	int getNumberOfParticles();
+
+	/**The number of threads which share the update, 1 means only the calling thread*/
+	void setThreadCount(int threadCount);
+	int getThreadCount();
+
+	/**If false, the scalar code is used, also if SSE is available. For comparing both*/
+	void setUseSIMD(bool useSIMD);
+	bool getUseSIMD();
+
+	///True if this build has the SSE kernels
+	static bool isSIMDAvailable();
+
+private:
+	void updateRange(const ParticleSimulationParameters& parameters, int begin, int end);
+	void updateRangeScalar(const ParticleSimulationParameters& parameters, int begin, int end);
+	void updateRangeSIMD(const ParticleSimulationParameters& parameters, int begin, int end);
+
+	int m_numberOfParticles;
+	int m_paddedNumberOfParticles;	//multiple of 4
+	int m_threadCount;
+	bool m_useSIMD;
+
+	//position & remaining lifetime
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_positionZ;
+	std::vector<float> m_lifetime;
+
+	//direction of the movement & speed
+	std::vector<float> m_directionX;
+	std::vector<float> m_directionY;
+	std::vector<float> m_directionZ;
+	std::vector<float> m_speed;
+
+	//direction of the trajectory, computed from the angles when emitting
+	std::vector<float> m_trajectoryX;
+	std::vector<float> m_trajectoryY;
+	std::vector<float> m_trajectoryZ;
+};
@@ -0,0 +1,70 @@
+#include "GeKo_Graphics/ParticleSystem/ParticleSort.h"
+#include "GeKo_Graphics/Shader/Uniforms.h"
+
+//ParticleSystemSort.comp: local_size_x & the particles of one work group in shared memory
+static const int SORT_LOCAL_SIZE = 256;
+static const int SORT_LOCAL_ELEMENTS = 512;
+
+enum SortMode
+{
+	SORT_LOCAL = 0,
+	SORT_FLIP = 1,
+	SORT_DISPERSE = 2,
+	SORT_LOCAL_DISPERSE = 3
+};
+
+static const UniformHandle s_rangeOffset("rangeOffset");
+static const UniformHandle s_commandIndex("commandIndex");
+static const UniformHandle s_mode("mode");
+static const UniformHandle s_height("height");
+
+void ParticleSort::sortByDepth(ShaderProgram* sort, glm::vec3 camPos, GLuint aliveBuffer, GLuint commandBuffer,
+	int rangeOffset, int commandIndex, int maxCount)
+{
+	if (sort == nullptr || maxCount < 2)
+		return;
+
+	int count = 1;
+	while (count < maxCount)
+		count *= 2;
+	//one work group sorts SORT_LOCAL_ELEMENTS, every thread of the global steps swaps one pair
+	int localGroups = (count + SORT_LOCAL_ELEMENTS - 1) / SORT_LOCAL_ELEMENTS;
+	int globalGroups = (count / 2 + SORT_LOCAL_SIZE - 1) / SORT_LOCAL_SIZE;
+
+	sort->bind();
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, aliveBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, commandBuffer);
+	sort->sendInt(s_rangeOffset, rangeOffset);
+	sort->sendInt(s_commandIndex, commandIndex);
+	sort->sendVec3(Uniforms::camPos, camPos);
+
+	sort->sendInt(s_mode, SORT_LOCAL);
+	glDispatchCompute(localGroups, 1, 1);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+	for (int height = SORT_LOCAL_ELEMENTS * 2; height <= count; height *= 2)
+	{
+		sort->sendInt(s_mode, SORT_FLIP);
+		sort->sendInt(s_height, height);
+		glDispatchCompute(globalGroups, 1, 1);
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+		for (int disperse = height / 2; disperse > SORT_LOCAL_ELEMENTS; disperse /= 2)
+		{
+			sort->sendInt(s_mode, SORT_DISPERSE);
+			sort->sendInt(s_height, disperse);
+			glDispatchCompute(globalGroups, 1, 1);
+			glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+		}
+
+		sort->sendInt(s_mode, SORT_LOCAL_DISPERSE);
+		sort->sendInt(s_height, SORT_LOCAL_ELEMENTS);
+		glDispatchCompute(localGroups, 1, 1);
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+	}
+
+	glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, 0);
+	sort->unbind();
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "GeKo_Graphics/ParticleSystem/Emitter.h"
+
+///Back to front order of the living particles on the GPU
+/*
+Description: Dispatches ParticleSystemSort.comp (bitonic sort) on a list of alive positions, like alive_ssbo of an Emitter
+or a range of the shared alive buffer of the ParticleBatch. The number of living particles is read from the draw command
+on the GPU, so nothing is read back. The list is padded to a power of two: log2(n) * (log2(n) + 1) / 2 steps, the steps
+inside blocks of 512 particles run in shared memory.
+
+It is optional per Emitter (Emitter::setDepthSort), for overlapping smoke & fire. Needs the simulation barrier before.
+*/
+
+class ParticleSort
+{
+public:
+	///Sorts aliveBuffer[rangeOffset .. rangeOffset + count of the draw command) back to front, maxCount is the size of the range
+	static void sortByDepth(ShaderProgram* sort, glm::vec3 camPos, GLuint aliveBuffer, GLuint commandBuffer,
+		int rangeOffset, int commandIndex, int maxCount);
+};
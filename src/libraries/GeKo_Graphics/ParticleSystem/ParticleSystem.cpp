@@ -1,29 +1,36 @@
 #include "GeKo_Graphics/ParticleSystem/ParticleSystem.h"
+#include <algorithm>
 
 ParticleSystem::ParticleSystem(glm::vec3 position)
 {
+	setAttributes();
 	effect = new Effect();
-	setEffect(effect);
+	m_ownsEffect = true;
 	setPosition(position);
 }
 
 ParticleSystem::ParticleSystem(glm::vec3 position, Effect* effect)
 {
-	this->effect = new Effect();
-	setEffect(effect);
+	setAttributes();
+	this->effect = effect;
+	m_ownsEffect = false;
 	setPosition(position);
 }
 
 ParticleSystem::ParticleSystem(glm::vec3 position, const char* filepath)
 {
+	setAttributes();
 	effect = new Effect();
+	m_ownsEffect = true;
 	loadEffect(filepath);
 	setPosition(position);
 }
 
+//an Effect given by the caller is not deleted, it may be used by other ParticleSystems
 ParticleSystem::~ParticleSystem()
 {
-	//TODO
+	if (m_ownsEffect)
+		delete effect;
 }
 
 
@@ -37,14 +44,91 @@ void ParticleSystem::stop()
 	effect->stop();
 }
 
+void ParticleSystem::setAttributes()
+{
+	m_useLOD = true;
+	m_lodNear = 30.0f;
+	m_lodFar = 150.0f;
+	m_lodMinEmission = 0.25f;
+	m_fastForwardInterval = 0.5f;
+	m_lastUpdateTime = 0.0;
+}
+
 void ParticleSystem::update(Camera &cam)
 {
-	effect->updateEmitters(cam);
+	if (updateLOD(cam))
+		effect->updateEmitters(cam);
 }
 
 void ParticleSystem::render(Camera &cam)
 {
-	effect->renderEmitters(cam);
+	if (effect->isVisible())
+		effect->renderEmitters(cam);
+}
+
+void ParticleSystem::setLOD(bool on, float nearDistance, float farDistance, float minEmission)
+{
+	m_useLOD = on;
+	m_lodNear = nearDistance;
+	m_lodFar = std::max(farDistance, nearDistance);
+	m_lodMinEmission = std::min(std::max(minEmission, 0.0f), 1.0f);
+	if (!on)
+	{
+		effect->setLOD(1.0f, 1.0f);
+		effect->setVisible(true);
+		effect->setSimulated(true);
+	}
+}
+
+void ParticleSystem::setFastForwardInterval(float seconds)
+{
+	m_fastForwardInterval = seconds;
+}
+
+bool ParticleSystem::updateLOD(Camera &cam)
+{
+	if (!m_useLOD)
+		return true;
+
+	glm::vec3 center;
+	float radius;
+	if (!effect->getBoundingSphere(center, radius))
+	{
+		effect->setLOD(1.0f, 1.0f);
+		effect->setVisible(true);
+		effect->setSimulated(true);
+		return true;
+	}
+
+	glm::vec3 camPos(cam.getPosition().x, cam.getPosition().y, cam.getPosition().z);
+	float distance = std::max(glm::length(center - camPos) - radius, 0.0f);
+
+	Frustum frustum(cam);
+	bool visible = frustum.containsSphere(center, radius);
+	effect->setVisible(visible);
+
+	//fewer particles in the distance, bigger ones to keep the coverage
+	float emission = 1.0f;
+	if (distance > m_lodNear)
+	{
+		float t = m_lodFar > m_lodNear ? std::min((distance - m_lodNear) / (m_lodFar - m_lodNear), 1.0f) : 1.0f;
+		emission = 1.0f - t * (1.0f - m_lodMinEmission);
+	}
+	float size = emission > 0.0f ? std::min(std::sqrt(1.0f / emission), 2.0f) : 2.0f;
+	effect->setLOD(emission, size);
+
+	//fast forward: the emitters take the whole time since the last update as one step
+	double time = Emitter::getTime();
+	bool simulated = visible || time - m_lastUpdateTime >= m_fastForwardInterval;
+	if (simulated)
+		m_lastUpdateTime = time;
+	effect->setSimulated(simulated);
+	return simulated;
+}
+
+bool ParticleSystem::isVisible()
+{
+	return effect->isVisible();
 }
 
 void ParticleSystem::setPosition(glm::vec3 newPosition)
@@ -55,7 +139,10 @@ void ParticleSystem::setPosition(glm::vec3 newPosition)
 
 void ParticleSystem::setEffect(Effect* newEffect)
 {
+	if (m_ownsEffect && newEffect != effect)
+		delete effect;
 	effect = newEffect;
+	m_ownsEffect = false;
 }
 
 void ParticleSystem::loadEffect(const char* filepath)
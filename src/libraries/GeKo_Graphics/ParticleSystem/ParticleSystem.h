@@ -1,7 +1,16 @@
 #pragma once
 #include "GeKo_Graphics/ParticleSystem/Effect.h"
 #include "GeKo_Graphics/ParticleSystem/ParticleType.h"
+#include "GeKo_Graphics/Camera/Frustum.h"
 
+/*
+Description:
+An Effect at a position. update & render use a level of detail: the bounding sphere of the effect (Effect::getBoundingSphere)
+is tested against the view frustum and systems outside are not rendered. Their simulation only runs every fastForwardInterval
+seconds with the time since the last update (fast forward), so they are in a plausible state when they get visible again.
+Between nearDistance and farDistance the emission goes down to minEmission and the particles get bigger to cover the same area.
+Effects with unbounded Emitters (movable ones or immortal particles) are always visible and in full detail.
+*/
 class ParticleSystem{
 public:
 	ParticleSystem(glm::vec3 position);
@@ -15,6 +24,14 @@ public:
 	void update(Camera &cam);
 	void render(Camera &cam);
 
+	///Level of detail, on by default. Distances are measured to the bounding sphere
+	void setLOD(bool on, float nearDistance = 30.0f, float farDistance = 150.0f, float minEmission = 0.25f);
+	///Seconds between the updates of systems outside the view frustum
+	void setFastForwardInterval(float seconds);
+	///Culls & sets the LOD of the effect for this frame, returns true if it has to be simulated. Part of update, used by the ParticleSystemPool
+	bool updateLOD(Camera &cam);
+	bool isVisible();
+
 	void setPosition(glm::vec3 newPosition);
 	void setEffect(Effect* newEffect);
 	void loadEffect(const char* filepath);
@@ -26,6 +43,17 @@ public:
 	ParticleType m_type;
 
 private:
+	void setAttributes();
+
 	glm::vec3 position;
 	Effect* effect;
+	bool m_ownsEffect;	//the Effect was created by the ParticleSystem
+
+	//level of detail
+	bool m_useLOD;
+	float m_lodNear;
+	float m_lodFar;
+	float m_lodMinEmission;
+	float m_fastForwardInterval;
+	double m_lastUpdateTime;
 };
\ No newline at end of file
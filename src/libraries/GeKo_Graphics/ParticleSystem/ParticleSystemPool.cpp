@@ -0,0 +1,238 @@
+#include "GeKo_Graphics/ParticleSystem/ParticleSystemPool.h"
+
+ParticleSystemPool::ParticleSystemPool()
+{
+}
+
+ParticleSystemPool::~ParticleSystemPool()
+{
+	clear();
+}
+
+void ParticleSystemPool::registerType(ParticleType type, const char* filepath, int preallocate, int cap)
+{
+	if (m_types.find(type) != m_types.end())
+	{
+		printf("WARNING: ParticleSystemPool: the type %i is already registered\n", (int)type);
+		return;
+	}
+	if (cap < 1)
+		cap = 1;
+	if (preallocate > cap)
+		preallocate = cap;
+
+	PoolType& poolType = m_types[type];
+	poolType.filepath = filepath;
+	poolType.cap = cap;
+	poolType.active = 0;
+
+	for (int i = 0; i < preallocate; i++)
+	{
+		poolType.free.push_back(createSystem(poolType));
+	}
+	poolType.free.reserve(cap);
+
+	//room in the shared buffers of the batch for every system of the type
+	if (!poolType.free.empty())
+	{
+		int particles = 0;
+		for (auto emitter : *poolType.free.back()->getEffect()->getEmitters())
+		{
+			particles += emitter->getNumMaxParticle();
+		}
+		m_batch.reserve(particles * cap);
+	}
+}
+
+bool ParticleSystemPool::hasType(ParticleType type)
+{
+	return m_types.find(type) != m_types.end();
+}
+
+ParticleSystem* ParticleSystemPool::createSystem(PoolType& poolType)
+{
+	//the emitters are simulated in the buffers of m_batch
+	return new ParticleSystem(glm::vec3(0.0, 0.0, 0.0), poolType.filepath.c_str());
+}
+
+ParticleHandle ParticleSystemPool::spawn(ParticleType type, glm::vec3 position)
+{
+	ParticleHandle invalid = { nullptr, 0, 0 };
+
+	auto it = m_types.find(type);
+	if (it == m_types.end())
+	{
+		printf("ERROR: ParticleSystemPool: the type %i is not registered\n", (int)type);
+		return invalid;
+	}
+
+	PoolType& poolType = it->second;
+	if (poolType.active >= poolType.cap)
+		return invalid;
+
+	ParticleSystem* system;
+	if (poolType.free.empty())
+	{
+		//more than preallocated, this loads the effect now
+		system = createSystem(poolType);
+	}
+	else
+	{
+		system = poolType.free.back();
+		poolType.free.pop_back();
+	}
+	system->m_type = type;
+
+	//released before its particles died, they must not appear at the new position
+	if (!system->getEffect()->isFinished())
+		system->getEffect()->clearParticles();
+
+	system->setPosition(position);
+	system->start();
+	m_batch.addEffect(system->getEffect());
+
+	ParticleHandle handle = m_handles.add(system);
+	if (handle.id >= m_activeIndex.size())
+		m_activeIndex.resize(handle.id + 1, -1);
+	m_activeIndex[handle.id] = (int)m_active.size();
+
+	ActiveSystem active = { handle, system };
+	m_active.push_back(active);
+	poolType.active++;
+
+	return handle;
+}
+
+ParticleHandle ParticleSystemPool::spawn(ParticleType type, glm::vec3 position, const void* owner)
+{
+	ParticleHandle& handle = m_owned[std::make_pair(type, owner)];
+	if (isValid(handle))
+		m_handles.get(handle)->setPosition(position);
+	else
+		handle = spawn(type, position);
+	return handle;
+}
+
+void ParticleSystemPool::release(ParticleHandle handle)
+{
+	if (!isValid(handle))
+		return;
+	recycle(m_activeIndex[handle.id]);
+}
+
+void ParticleSystemPool::release(ParticleType type, const void* owner)
+{
+	auto it = m_owned.find(std::make_pair(type, owner));
+	if (it == m_owned.end())
+		return;
+	release(it->second);
+	m_owned.erase(it);
+}
+
+void ParticleSystemPool::recycle(int activeIndex)
+{
+	ActiveSystem active = m_active[activeIndex];
+	active.system->stop();
+	m_batch.removeEffect(active.system->getEffect());
+
+	PoolType& poolType = m_types[active.system->m_type];
+	poolType.free.push_back(active.system);
+	poolType.active--;
+
+	m_handles.remove(active.handle);
+	m_activeIndex[active.handle.id] = -1;
+
+	//swap with the last one
+	if (activeIndex != (int)m_active.size() - 1)
+	{
+		m_active[activeIndex] = m_active.back();
+		m_activeIndex[m_active[activeIndex].handle.id] = activeIndex;
+	}
+	m_active.pop_back();
+}
+
+bool ParticleSystemPool::isValid(ParticleHandle handle)
+{
+	return handle.manager == &m_handles && handle.id < m_activeIndex.size()
+		&& m_activeIndex[handle.id] >= 0 && m_handles.validate(handle);
+}
+
+bool ParticleSystemPool::isPlaying(ParticleType type, const void* owner)
+{
+	auto it = m_owned.find(std::make_pair(type, owner));
+	return it != m_owned.end() && isValid(it->second);
+}
+
+ParticleSystem* ParticleSystemPool::get(ParticleHandle handle)
+{
+	if (!isValid(handle))
+		return nullptr;
+	return m_handles.get(handle);
+}
+
+void ParticleSystemPool::update(Camera &cam)
+{
+	for (auto& active : m_active)
+	{
+		active.system->updateLOD(cam);
+	}
+	m_batch.update(cam);
+	for (int i = 0; i < (int)m_active.size();)
+	{
+		ParticleSystem* system = m_active[i].system;
+		if (system->getEffect()->isFinished())
+		{
+			//the last one moves to i
+			recycle(i);
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
+
+void ParticleSystemPool::render(Camera &cam)
+{
+	m_batch.render(cam);
+}
+
+ParticleBatch* ParticleSystemPool::getBatch()
+{
+	return &m_batch;
+}
+
+int ParticleSystemPool::getActiveCount()
+{
+	return (int)m_active.size();
+}
+
+int ParticleSystemPool::getActiveCount(ParticleType type)
+{
+	auto it = m_types.find(type);
+	return it == m_types.end() ? 0 : it->second.active;
+}
+
+int ParticleSystemPool::getFreeCount(ParticleType type)
+{
+	auto it = m_types.find(type);
+	return it == m_types.end() ? 0 : (int)it->second.free.size();
+}
+
+void ParticleSystemPool::clear()
+{
+	while (!m_active.empty())
+	{
+		recycle((int)m_active.size() - 1);
+	}
+	for (auto& poolType : m_types)
+	{
+		for (auto system : poolType.second.free)
+		{
+			delete system;
+		}
+	}
+	m_types.clear();
+	m_owned.clear();
+	m_batch.clear();
+}
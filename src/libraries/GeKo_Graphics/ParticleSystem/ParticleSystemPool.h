@@ -0,0 +1,100 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+#include "GeKo_Graphics/ParticleSystem/ParticleSystem.h"
+#include "GeKo_Graphics/ParticleSystem/ParticleBatch.h"
+#include "Geko_Resource/Handle/Handle.hpp"
+
+typedef Handle::Handle<ParticleSystem*> ParticleHandle;
+
+///Pool of ParticleSystems for gameplay effects
+/*
+Description: Every ParticleType gets an effect file, a number of preallocated ParticleSystems and a cap.
+spawn(type, position) starts a free ParticleSystem of the type and returns a handle. The ParticleSystem goes back to the pool
+when its effect is finished (Effect::isFinished) or with release(handle); the handle gets invalid then (see Handle::HandleManager).
+Effects whose particles never die have to be released.
+
+Several ParticleSystems of the same type can play at the same time, up to the cap of the type.
+Gameplay code which has no place for the handle spawns with an owner (e.g. the AI): there is one ParticleSystem per type & owner,
+a second spawn only moves it, and release(type, owner) stops it.
+The preallocated ParticleSystems load their effect in registerType, so spawn doesn't load anything.
+All playing ParticleSystems are updated & rendered together by one ParticleBatch, registerType reserves its buffers.
+The Scene adds the effects of its particle set to this batch too (Scene::renderParticleSystems), they are never recycled.
+The pool & its batch hold GL objects until clear(), call it before the context is destroyed. The destructor calls clear() too,
+so the ParticleSystems are not leaked.
+
+Use:
+	pool.registerType(ParticleType::FIGHT, RESOURCES_PATH "/XML/Effect_ComicCloud.xml", 4, 8);
+	ParticleHandle fight = pool.spawn(ParticleType::FIGHT, position);
+	...
+	if (pool.isValid(fight)) pool.get(fight)->setPosition(newPosition);
+	pool.release(fight);
+
+	pool.spawn(ParticleType::SWARMOFFLIES, position, &ai);
+	...
+	pool.release(ParticleType::SWARMOFFLIES, &ai);
+*/
+class ParticleSystemPool
+{
+public:
+	ParticleSystemPool();
+	~ParticleSystemPool();
+
+	///Registers the effect file of a type, needs the GL context. preallocate ParticleSystems are created at once, at most cap play at the same time
+	void registerType(ParticleType type, const char* filepath, int preallocate, int cap);
+	bool hasType(ParticleType type);
+
+	///Starts a ParticleSystem of the type at the position. The handle is invalid if the type is unknown or its cap is reached
+	ParticleHandle spawn(ParticleType type, glm::vec3 position);
+	///Like spawn, but if the owner already plays a ParticleSystem of the type, it is moved to the position and its handle is returned
+	ParticleHandle spawn(ParticleType type, glm::vec3 position, const void* owner);
+	///Stops the ParticleSystem and puts it back to the pool
+	void release(ParticleHandle handle);
+	///Stops the ParticleSystem the owner spawned of the type, if it still plays
+	void release(ParticleType type, const void* owner);
+
+	///False if the ParticleSystem of the handle went back to the pool
+	bool isValid(ParticleHandle handle);
+	///True if the ParticleSystem the owner spawned of the type still plays
+	bool isPlaying(ParticleType type, const void* owner);
+	///Returns nullptr for invalid handles
+	ParticleSystem* get(ParticleHandle handle);
+
+	///Updates & renders the playing ParticleSystems, finished ones go back to the pool
+	void update(Camera &cam);
+	void render(Camera &cam);
+
+	int getActiveCount();
+	int getActiveCount(ParticleType type);
+	int getFreeCount(ParticleType type);
+	ParticleBatch* getBatch();
+
+	///Deletes all ParticleSystems and types, needs the GL context. All handles are invalid afterwards
+	void clear();
+
+private:
+	struct PoolType
+	{
+		std::string filepath;
+		int cap;
+		int active;
+		std::vector<ParticleSystem*> free;
+	};
+
+	struct ActiveSystem
+	{
+		ParticleHandle handle;
+		ParticleSystem* system;
+	};
+
+	ParticleSystem* createSystem(PoolType& poolType);
+	void recycle(int activeIndex);
+
+	std::map<ParticleType, PoolType> m_types;
+	Handle::HandleManager<ParticleSystem*> m_handles;
+	std::vector<ActiveSystem> m_active;
+	std::vector<int> m_activeIndex;	//index in m_active for every handle id
+	std::map<std::pair<ParticleType, const void*>, ParticleHandle> m_owned;	//handles of spawn with an owner, may be invalid already
+	ParticleBatch m_batch;
+};
@@ -0,0 +1,107 @@
+#include "ParticleUploadBuffer.h"
+#include <algorithm>
+#include <iostream>
+
+ParticleUploadBuffer::ParticleUploadBuffer(int numberOfParticles, int numberOfRegions)
+{
+	m_buffer = 0;
+	m_data = nullptr;
+	m_numberOfRegions = std::min(std::max(numberOfRegions, 2), 8);
+	m_regionSize = std::max(numberOfParticles / m_numberOfRegions, 1);
+	m_numberOfParticles = m_regionSize * m_numberOfRegions;
+	m_head = 0;
+	m_currentRegion = 0;
+	for (int i = 0; i < 8; i++)
+		m_fences[i] = 0;
+
+	m_supported = GLEW_ARB_buffer_storage != 0;
+	if (!m_supported){
+		std::cout << "WARNING: ParticleUploadBuffer needs ARB_buffer_storage, the emitters use glBufferSubData" << std::endl;
+		return;
+	}
+
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	GLsizeiptr size = m_numberOfParticles * sizeof(glm::vec4);
+
+	glGenBuffers(1, &m_buffer);
+	glBindBuffer(GL_COPY_READ_BUFFER, m_buffer);
+	glBufferStorage(GL_COPY_READ_BUFFER, size, nullptr, flags);
+	m_data = (glm::vec4*)glMapBufferRange(GL_COPY_READ_BUFFER, 0, size, flags);
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+	if (m_data == nullptr){
+		std::cout << "ERROR: ParticleUploadBuffer could not be mapped" << std::endl;
+		glDeleteBuffers(1, &m_buffer);
+		m_buffer = 0;
+		m_supported = false;
+	}
+}
+
+ParticleUploadBuffer* ParticleUploadBuffer::getShared()
+{
+	static ParticleUploadBuffer* shared = nullptr;
+	if (shared == nullptr)
+		shared = new ParticleUploadBuffer();
+	return shared;
+}
+
+bool ParticleUploadBuffer::isSupported()
+{
+	return m_supported;
+}
+
+int ParticleUploadBuffer::getMaxParticles()
+{
+	return m_regionSize;
+}
+
+glm::vec4* ParticleUploadBuffer::allocate(int count, GLintptr& offset)
+{
+	if (!m_supported || count <= 0 || count > m_regionSize)
+		return nullptr;
+
+	//an allocation never reaches into the next region, so the fence of its region covers the copy which reads it
+	if (m_head + count > (m_currentRegion + 1) * m_regionSize){
+		m_currentRegion = (m_currentRegion + 1) % m_numberOfRegions;
+		m_head = m_currentRegion * m_regionSize;
+		waitForRegion(m_currentRegion);
+	}
+
+	offset = m_head * sizeof(glm::vec4);
+	glm::vec4* data = m_data + m_head;
+	m_head += count;
+
+	return data;
+}
+
+void ParticleUploadBuffer::copyTo(GLuint buffer, GLintptr offset, int count)
+{
+	glBindBuffer(GL_COPY_READ_BUFFER, m_buffer);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, offset, 0, count * sizeof(glm::vec4));
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void ParticleUploadBuffer::fence()
+{
+	//the new fence signals after the old one, it covers every copy of the region
+	if (m_fences[m_currentRegion] != 0)
+		glDeleteSync(m_fences[m_currentRegion]);
+	m_fences[m_currentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void ParticleUploadBuffer::waitForRegion(int region)
+{
+	if (m_fences[region] == 0)
+		return;
+
+	GLenum result = glClientWaitSync(m_fences[region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+	while (result == GL_TIMEOUT_EXPIRED)
+		result = glClientWaitSync(m_fences[region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+	if (result == GL_WAIT_FAILED)
+		std::cout << "ERROR: ParticleUploadBuffer fence wait failed" << std::endl;
+
+	glDeleteSync(m_fences[region]);
+	m_fences[region] = 0;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+/*
+Description:
+Ring buffer for the particle positions of the CPU simulation, shared by all Emitters. The buffer is persistently mapped (ARB_buffer_storage),
+so the positions of a frame are written with plain stores and copied into the particle_ssbo of the emitter with glCopyBufferSubData,
+instead of a glBufferSubData into a buffer the last draw may still read.
+
+The ring is divided in regions, an allocation always lies in one region. After the copy of an allocation is submitted, fence() puts
+a fence behind it. Before the writing starts in a region again, we wait for the fence of the copies which read it the last time.
+Without ARB_buffer_storage isSupported() is false and the emitters use glBufferSubData.
+
+The ring is never deleted, it lives as long as the process (at its end there is no GL context anymore).
+*/
+class ParticleUploadBuffer{
+public:
+	/**numberOfParticles is the size of the whole ring, every region holds numberOfParticles / numberOfRegions*/
+	ParticleUploadBuffer(int numberOfParticles = 262144, int numberOfRegions = 4);
+
+	///The ring of all emitters, created with the first call. Needs a GL context
+	static ParticleUploadBuffer* getShared();
+
+	bool isSupported();
+
+	///The maximum number of positions of one allocate call
+	int getMaxParticles();
+
+	/**Returns memory for count positions or nullptr if count > getMaxParticles(). offset is the byte offset in the ring buffer.
+	The copy which reads the memory has to be submitted & fenced (fence) before the next allocate call*/
+	glm::vec4* allocate(int count, GLintptr& offset);
+
+	///Copies count positions from the ring (offset of allocate) to the start of the buffer
+	void copyTo(GLuint buffer, GLintptr offset, int count);
+
+	///Fences the region of the last allocation, call it after the commands which read the allocation
+	void fence();
+
+private:
+	void waitForRegion(int region);
+
+	GLuint m_buffer;
+	glm::vec4* m_data;
+	bool m_supported;
+
+	int m_numberOfParticles;
+	int m_numberOfRegions;
+	int m_regionSize;	//positions per region
+
+	int m_head;			//next free position
+	int m_currentRegion;
+	GLsync m_fences[8];	//one per region, 0 if no copy reads the region
+};
@@ -0,0 +1,70 @@
+#include "RadixSort.h"
+#include <algorithm>
+#include <cstring>
+
+//below this the passes cost more than std::sort
+static const size_t RADIX_SORT_THRESHOLD = 256;
+
+void RadixSort::sort(std::vector<uint64_t> &keys, std::vector<uint64_t> &temp)
+{
+	size_t count = keys.size();
+	if (count < RADIX_SORT_THRESHOLD)
+	{
+		std::sort(keys.begin(), keys.end());
+		return;
+	}
+
+	temp.resize(count);
+	uint64_t* source = keys.data();
+	uint64_t* target = temp.data();
+
+	//the histograms of all 8 digits in one read
+	size_t histogram[8][256];
+	std::memset(histogram, 0, sizeof(histogram));
+	for (size_t i = 0; i < count; i++)
+	{
+		uint64_t key = source[i];
+		for (int digit = 0; digit < 8; digit++)
+		{
+			histogram[digit][(key >> (digit * 8)) & 0xff]++;
+		}
+	}
+
+	for (int digit = 0; digit < 8; digit++)
+	{
+		size_t* bucket = histogram[digit];
+		int shift = digit * 8;
+
+		//all keys have the same digit, the pass wouldn't change anything
+		if (bucket[(source[0] >> shift) & 0xff] == count)
+			continue;
+
+		size_t offset = 0;
+		for (int i = 0; i < 256; i++)
+		{
+			size_t size = bucket[i];
+			bucket[i] = offset;
+			offset += size;
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			uint64_t key = source[i];
+			target[bucket[(key >> shift) & 0xff]++] = key;
+		}
+		std::swap(source, target);
+	}
+
+	//an odd number of passes ends in temp
+	if (source != keys.data())
+		std::memcpy(keys.data(), source, count * sizeof(uint64_t));
+}
+
+uint32_t RadixSort::floatKey(float value)
+{
+	if (!(value > 0.0f))
+		return 0;
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
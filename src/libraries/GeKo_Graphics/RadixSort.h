@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+///Sorting of packed 64 bit keys
+/*
+Description: The keys are sorted ascending, pack what is sorted by into the high bits and an index into the low bits.
+Few keys are sorted with std::sort, many with a LSD radix sort (8 bit digits) that skips the digits all keys share.
+The temp buffer is reused, keep both vectors between the frames and nothing is allocated once they are big enough.
+
+Floats >= 0 keep their order as uint32_t bits, see floatKey.
+*/
+
+namespace RadixSort
+{
+	///Sorts keys ascending, temp is a buffer for the passes
+	void sort(std::vector<uint64_t> &keys, std::vector<uint64_t> &temp);
+
+	///The bits of a float >= 0 as a sortable key (negative values get 0)
+	uint32_t floatKey(float value);
+}
@@ -0,0 +1,219 @@
+#include "RenderCommandBuffer.h"
+#include <GeKo_Graphics/Geometry/Geometry.h>
+#include <GeKo_Graphics/Material/TextureManager.h>
+#include <GeKo_Graphics/Shader/Uniforms.h>
+
+RenderCommandBuffer::RenderCommandBuffer()
+{
+	m_instanceBuffer = 0;
+	m_instanceBufferSize = 0;
+}
+
+RenderCommandBuffer::~RenderCommandBuffer()
+{
+	if (m_instanceBuffer)
+		glDeleteBuffers(1, &m_instanceBuffer);
+}
+
+void RenderCommandBuffer::clear()
+{
+	m_commands.clear();
+	m_objects.clear();
+	m_instanceMatrices.clear();
+	m_callbacks.clear();
+}
+
+void RenderCommandBuffer::bindProgram(ShaderProgram* program)
+{
+	RenderCommand command = RenderCommand();
+	command.type = RENDER_COMMAND_BIND_PROGRAM;
+	command.program = program;
+	m_commands.push_back(command);
+}
+
+void RenderCommandBuffer::sendInt(const UniformHandle& uniform, int value)
+{
+	RenderCommand command = RenderCommand();
+	command.type = RENDER_COMMAND_SEND_INT;
+	command.uniform = &uniform;
+	command.value = value;
+	m_commands.push_back(command);
+}
+
+void RenderCommandBuffer::bindTexture(int unit, GLuint texture)
+{
+	RenderCommand command = RenderCommand();
+	command.type = RENDER_COMMAND_BIND_TEXTURE;
+	command.handle = texture;
+	command.value = unit;
+	m_commands.push_back(command);
+}
+
+void RenderCommandBuffer::bindSampler(int unit, TextureSampler sampler)
+{
+	RenderCommand command = RenderCommand();
+	command.type = RENDER_COMMAND_BIND_SAMPLER;
+	command.value = unit;
+	command.index = sampler;
+	m_commands.push_back(command);
+}
+
+void RenderCommandBuffer::unbindSampler(int unit)
+{
+	RenderCommand command = RenderCommand();
+	command.type = RENDER_COMMAND_BIND_SAMPLER;
+	command.value = unit;
+	command.index = -1;
+	m_commands.push_back(command);
+}
+
+void RenderCommandBuffer::setObject(const ObjectUniforms& object)
+{
+	RenderCommand command = RenderCommand();
+	command.type = RENDER_COMMAND_SET_OBJECT;
+	command.index = (int)m_objects.size();
+	m_objects.push_back(object);
+	m_commands.push_back(command);
+}
+
+void RenderCommandBuffer::bindVertexArray(GLuint vao)
+{
+	RenderCommand command = RenderCommand();
+	command.type = RENDER_COMMAND_BIND_VERTEX_ARRAY;
+	command.handle = vao;
+	m_commands.push_back(command);
+}
+
+void RenderCommandBuffer::draw(Geometry* geometry)
+{
+	RenderCommand command = RenderCommand();
+	command.type = RENDER_COMMAND_DRAW;
+	command.geometry = geometry;
+	m_commands.push_back(command);
+}
+
+void RenderCommandBuffer::drawInstanced(Geometry* geometry, const glm::mat4* modelMatrices, int count)
+{
+	RenderCommand command = RenderCommand();
+	command.type = RENDER_COMMAND_DRAW_INSTANCED;
+	command.geometry = geometry;
+	command.value = count;
+	command.index = (int)m_instanceMatrices.size();
+	m_instanceMatrices.insert(m_instanceMatrices.end(), modelMatrices, modelMatrices + count);
+	m_commands.push_back(command);
+}
+
+void RenderCommandBuffer::addCallback(const std::function<void()>& callback)
+{
+	RenderCommand command = RenderCommand();
+	command.type = RENDER_COMMAND_CALLBACK;
+	command.index = (int)m_callbacks.size();
+	m_callbacks.push_back(callback);
+	m_commands.push_back(command);
+}
+
+void RenderCommandBuffer::execute()
+{
+	uploadInstances();
+
+	ShaderProgram* program = nullptr;
+	bool useObjectBlock = false;
+
+	for (auto& command : m_commands)
+	{
+		switch (command.type)
+		{
+		case RENDER_COMMAND_BIND_PROGRAM:
+			program = command.program;
+			program->bind();
+			useObjectBlock = program->hasUniformBlock(UNIFORM_BLOCK_OBJECT);
+			break;
+		case RENDER_COMMAND_SEND_INT:
+			program->sendInt(*command.uniform, command.value);
+			break;
+		case RENDER_COMMAND_BIND_TEXTURE:
+			glActiveTexture(GL_TEXTURE0 + command.value);
+			glBindTexture(GL_TEXTURE_2D, command.handle);
+			break;
+		case RENDER_COMMAND_BIND_SAMPLER:
+			if (command.index < 0)
+				glBindSampler(command.value, 0);
+			else
+				TextureManager::getInstance()->bindSampler(command.value, (TextureSampler)command.index);
+			break;
+		case RENDER_COMMAND_SET_OBJECT:
+			if (useObjectBlock)
+				UniformBlocks::getInstance()->pushObject(m_objects[command.index]);
+			else
+				sendObject(program, m_objects[command.index]);
+			break;
+		case RENDER_COMMAND_BIND_VERTEX_ARRAY:
+			glBindVertexArray(command.handle);
+			break;
+		case RENDER_COMMAND_DRAW:
+			command.geometry->drawGeometry();
+			break;
+		case RENDER_COMMAND_DRAW_INSTANCED:
+		{
+			//the matrices of the draw in the instance buffer, one per instance
+			glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+			for (GLuint column = 0; column < 4; column++)
+			{
+				GLuint location = INSTANCE_MATRIX_LOCATION + column;
+				size_t offset = command.index * sizeof(glm::mat4) + column * sizeof(glm::vec4);
+				glEnableVertexAttribArray(location);
+				glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (const void*)offset);
+				glVertexAttribDivisor(location, 1);
+			}
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+			command.geometry->drawGeometryInstanced(command.value);
+
+			for (GLuint column = 0; column < 4; column++)
+				glDisableVertexAttribArray(INSTANCE_MATRIX_LOCATION + column);
+			break;
+		}
+		case RENDER_COMMAND_CALLBACK:
+			m_callbacks[command.index]();
+			program = nullptr;
+			break;
+		}
+	}
+}
+
+int RenderCommandBuffer::getCommandCount()
+{
+	return (int)m_commands.size();
+}
+
+void RenderCommandBuffer::uploadInstances()
+{
+	if (m_instanceMatrices.empty())
+		return;
+
+	//one upload for all instanced draws, the old storage is orphaned
+	GLsizeiptr size = m_instanceMatrices.size() * sizeof(glm::mat4);
+	if (!m_instanceBuffer)
+		glGenBuffers(1, &m_instanceBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+	if (size > m_instanceBufferSize)
+		m_instanceBufferSize = size * 2;
+	glBufferData(GL_ARRAY_BUFFER, m_instanceBufferSize, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, m_instanceMatrices.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void RenderCommandBuffer::sendObject(ShaderProgram* program, const ObjectUniforms& object)
+{
+	program->sendMat4(Uniforms::modelMatrix, object.modelMatrix);
+	program->sendMat4(Uniforms::previousModelMatrix, object.previousModelMatrix);
+	program->sendInt(Uniforms::useTexture, object.useTexture);
+	program->sendInt(Uniforms::useNormalMap, object.useNormalMap);
+	program->sendInt(Uniforms::useHeightMap, object.useHeightMap);
+	program->sendInt(Uniforms::useHeightMapShadows, object.useHeightMapShadows);
+	if (object.useHeightMap)
+	{
+		program->sendFloat(Uniforms::parallaxScale, object.parallaxScale);
+		program->sendFloat(Uniforms::parallaxBias, object.parallaxBias);
+	}
+}
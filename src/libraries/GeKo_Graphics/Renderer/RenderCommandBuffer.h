@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <GeKo_Graphics/Shader/UniformBuffer.h>
+#include <GeKo_Graphics/Material/Texture.h>
+
+class Geometry;
+
+enum RenderCommandType
+{
+	RENDER_COMMAND_BIND_PROGRAM,
+	RENDER_COMMAND_SEND_INT,
+	RENDER_COMMAND_BIND_TEXTURE,
+	RENDER_COMMAND_BIND_SAMPLER,
+	RENDER_COMMAND_SET_OBJECT,
+	RENDER_COMMAND_BIND_VERTEX_ARRAY,
+	RENDER_COMMAND_DRAW,
+	RENDER_COMMAND_DRAW_INSTANCED,
+	RENDER_COMMAND_CALLBACK
+};
+
+///A recorded command, the fields used depend on the type
+struct RenderCommand
+{
+	RenderCommandType type;
+	ShaderProgram* program;
+	Geometry* geometry;
+	const UniformHandle* uniform;
+	GLuint handle;	//texture or vertex array
+	int value;	//int of a uniform, texture unit or instance count
+	int index;	//into the objects, instance matrices or callbacks, or the TextureSampler (-1 unbinds)
+};
+
+///Render commands recorded without the OpenGL context and replayed on the GL thread
+/*
+Description: Recording only appends to vectors, so it can run on any thread: Scene::record traverses the scenegraph,
+culls & sorts into a buffer on a worker while the GL thread does other work. execute replays the commands in order,
+it has to be called on the thread of the OpenGL context. Several buffers (e.g. one per thread) are replayed one after the other.
+
+The data of a command is copied (ObjectUniforms, instance matrices), only programs, geometries & uniform handles are pointers
+and have to be alive until the replay. Work that needs the context (particles, GUI) is recorded as a callback.
+Keep a buffer between the frames and clear it, then nothing is allocated once the vectors are big enough.
+*/
+class RenderCommandBuffer
+{
+public:
+	RenderCommandBuffer();
+	~RenderCommandBuffer();
+
+	///Removes all commands, the memory is kept
+	void clear();
+
+	void bindProgram(ShaderProgram* program);
+	///The uniform handle has to be alive until the replay, use a static one
+	void sendInt(const UniformHandle& uniform, int value);
+	void bindTexture(int unit, GLuint texture);
+	///Binds the shared sampler object of the TextureManager to the unit
+	void bindSampler(int unit, TextureSampler sampler);
+	void unbindSampler(int unit);
+	///The ObjectBlock of the next draws, sent as uniforms if the bound program has no ObjectBlock
+	void setObject(const ObjectUniforms& object);
+	void bindVertexArray(GLuint vao);
+	///Draws the geometry with the bound vertex array (Geometry::drawGeometry)
+	void draw(Geometry* geometry);
+	///Draws count instances with the model matrices as instance attribute (INSTANCE_MATRIX_LOCATION)
+	void drawInstanced(Geometry* geometry, const glm::mat4* modelMatrices, int count);
+	///Calls the function during the replay, the bound program is unknown afterwards
+	void addCallback(const std::function<void()>& callback);
+
+	///Replays the commands in order, needs the OpenGL context
+	void execute();
+
+	int getCommandCount();
+
+private:
+	RenderCommandBuffer(const RenderCommandBuffer&);
+	RenderCommandBuffer& operator=(const RenderCommandBuffer&);
+
+	///Uploads the instance matrices of all instanced draws with one call
+	void uploadInstances();
+	void sendObject(ShaderProgram* program, const ObjectUniforms& object);
+
+	std::vector<RenderCommand> m_commands;
+	std::vector<ObjectUniforms> m_objects;
+	std::vector<glm::mat4> m_instanceMatrices;
+	std::vector<std::function<void()> > m_callbacks;
+
+	GLuint m_instanceBuffer;
+	GLsizeiptr m_instanceBufferSize;
+};
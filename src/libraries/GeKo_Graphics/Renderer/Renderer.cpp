@@ -1,5 +1,48 @@
 #include "Renderer.h"
 #include "GeKo_Graphics/GUI/GUI.h"
+#include "GeKo_Graphics/Shader/UniformBuffer.h"
+#include "GeKo_Graphics/Shader/Uniforms.h"
+#include "GeKo_Graphics/Material/TextureLoader.h"
+#include <thread>
+
+//the scene shaders of the renderer read camera, light, material & model matrix from the uniform blocks
+static const std::string UNIFORM_BLOCKS_DEFINE = "#define UNIFORM_BLOCKS\n";
+
+//uniforms of the passes, looked up once per shader program
+static const UniformHandle s_depthTexture("depthTexture");
+static const UniformHandle s_cubeMap("cubeMap");
+static const UniformHandle s_renderSkybox("renderSkybox");
+static const UniformHandle s_texture("texture");
+static const UniformHandle s_positionTexture("positionTexture");
+static const UniformHandle s_normalTexture("normalTexture");
+static const UniformHandle s_colorTexture("colorTexture");
+static const UniformHandle s_depthBuffer("depthBuffer");
+static const UniformHandle s_screenWidth("screenWidth");
+static const UniformHandle s_screenHeight("screenHeight");
+static const UniformHandle s_zNear("zNear");
+static const UniformHandle s_zFar("zFar");
+static const UniformHandle s_reflectivity("reflectivity");
+static const UniformHandle s_fboWidth("fboWidth");
+static const UniformHandle s_fboHeight("fboHeight");
+static const UniformHandle s_positionMap("positionMap");
+static const UniformHandle s_windowWidth("windowWidth");
+static const UniformHandle s_windowHeight("windowHeight");
+static const UniformHandle s_lightColor("lightColor");
+static const UniformHandle s_colorMap("colorMap");
+static const UniformHandle s_lightMap("lightMap");
+static const UniformHandle s_bgl_RenderedTexture("bgl_RenderedTexture");
+static const UniformHandle s_bloomStrength("bloomStrength");
+static const UniformHandle s_image("image");
+static const UniformHandle s_blurstrength("blurstrength");
+static const UniformHandle s_tex("tex");
+static const UniformHandle s_depth("depth");
+static const UniformHandle s_focus_depth("focus_depth");
+static const UniformHandle s_sceneProjectionMatrix("sceneProjectionMatrix");
+static const UniformHandle s_radius("radius");
+static const UniformHandle s_quality("quality");
+static const UniformHandle s_colortexture("colortexture");
+static const UniformHandle s_secondPass("secondPass");
+static const UniformHandle s_ssaoMap("ssaoMap");
 
 void OpenGL3Context::bindContext() const{
   glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -26,6 +69,8 @@ m_useRadialBlur(false),		  m_shaderRadialBlur(NULL),
 m_useDoF(false),			  m_shaderDoF(NULL), m_shaderDepth(NULL),
 m_useSSAO(false),             m_shaderSSAOcalc(NULL), m_shaderSSAOblur(NULL), m_shaderSSAOfinal(NULL),
 m_useShadowMapping(false),    m_shaderShadowMapping(NULL), m_smCam(NULL),
+m_useGPUDrivenRendering(false), m_shaderGBufferGPUDriven(NULL),
+m_useParallelRecording(false),
 
 m_currentViewMatrix(glm::mat4()), m_currentProjectionMatrix(glm::mat4()),
 m_windowWidth(0), m_windowHeight(0)
@@ -57,7 +102,10 @@ Renderer::~Renderer()
   if(m_useSSAO)              delete m_shaderSSAOblur;
   if(m_useSSAO)              delete m_shaderSSAOfinal;
   if(m_useShadowMapping)     delete m_shaderShadowMapping;
+  delete m_shaderGBufferGPUDriven;
 
+  //the context still exists, the singleton is destroyed after it
+  UniformBlocks::getInstance()->clear();
 }
 
 void Renderer::printInfo(){
@@ -86,14 +134,14 @@ void Renderer::init(int windowWidth, int windowHeight)
 
   if (!m_shaderGBuffer)
   {
-    VertexShader vsGBuffer(loadShaderSource(SHADERS_PATH + std::string("/GBuffer/GBuffer.vert")));
-    FragmentShader fsGBuffer(loadShaderSource(SHADERS_PATH + std::string("/GBuffer/GBuffer.frag")));
+    VertexShader vsGBuffer(loadShaderSource(SHADERS_PATH + std::string("/GBuffer/GBuffer.vert"), UNIFORM_BLOCKS_DEFINE));
+    FragmentShader fsGBuffer(loadShaderSource(SHADERS_PATH + std::string("/GBuffer/GBuffer.frag"), UNIFORM_BLOCKS_DEFINE));
     m_shaderGBuffer = new ShaderProgram(vsGBuffer, fsGBuffer);
   }
 
   if (m_useDeferredShading && !m_shaderDSLighting && !m_shaderDSCompositing)
   {
-    VertexShader vsDsLighting(loadShaderSource(SHADERS_PATH + std::string("/DeferredShading/dsLighting.vert")));
+    VertexShader vsDsLighting(loadShaderSource(SHADERS_PATH + std::string("/DeferredShading/dsLighting.vert"), UNIFORM_BLOCKS_DEFINE));
     FragmentShader fsDsLighting(loadShaderSource(SHADERS_PATH + std::string("/DeferredShading/dsLighting.frag")));
     m_shaderDSLighting = new ShaderProgram(vsDsLighting, fsDsLighting);
 
@@ -105,7 +153,7 @@ void Renderer::init(int windowWidth, int windowHeight)
   if (m_useReflections && !m_shaderRLR)
   {
     VertexShader vsRLR(loadShaderSource(SHADERS_PATH + std::string("/RealtimeLocalReflections/RealtimeLocalReflections.vert")));
-    FragmentShader fsRLR(loadShaderSource(SHADERS_PATH + std::string("/RealtimeLocalReflections/RealtimeLocalReflections.frag")));
+    FragmentShader fsRLR(loadShaderSource(SHADERS_PATH + std::string("/RealtimeLocalReflections/RealtimeLocalReflections.frag"), UNIFORM_BLOCKS_DEFINE));
     m_shaderRLR = new ShaderProgram(vsRLR, fsRLR);
   }
 
@@ -186,12 +234,28 @@ void Renderer::renderScene(Scene& scene, Window& window)
 {
   if (!m_ping || !m_pong)
     init(window.getWidth(), window.getHeight());
+
+  //streams decoded images into their textures, within the upload budget
+  TextureLoader::getInstance()->update();
   
   glClearColor(0.0, 0.0, 0.0, 1);
   
   if (m_useShadowMapping)
     renderShadowMapping(scene);
 
+  //the G-buffer pass is traversed, culled & recorded by a worker while this thread sets up the frame
+  std::thread recorder;
+  if (m_useParallelRecording && !m_useGPUDrivenRendering)
+  {
+    m_sceneCommands.clear();
+    //gravity moves the player & its camera, done here so the worker only reads the camera like this thread
+    scene.applyGravity();
+    recorder = std::thread([this, &scene]() {
+      scene.record(m_sceneCommands, *m_shaderGBuffer, scene.getScenegraph()->getActiveCamera());
+      scene.recordParticleSystems(m_sceneCommands);
+    });
+  }
+
   m_firstRender = true;
   
   m_currentFBOIndex = 0;
@@ -205,28 +269,28 @@ void Renderer::renderScene(Scene& scene, Window& window)
   m_currentViewMatrix = scene.getScenegraph()->getActiveCamera()->getViewMatrix();
   m_currentProjectionMatrix = scene.getScenegraph()->getActiveCamera()->getProjectionMatrix();
 
-  m_shaderGBuffer->sendMat4("viewMatrix", m_currentViewMatrix);
-  m_shaderGBuffer->sendMat4("projectionMatrix", m_currentProjectionMatrix);
-
-
-  //==================
-
-
-  m_shaderGBuffer->sendInt("useShadowMap", m_useShadowMapping);
+  //the FrameBlock is bound for all passes of this frame
+  FrameUniforms frame = FrameUniforms();
+  frame.viewMatrix = m_currentViewMatrix;
+  frame.projectionMatrix = m_currentProjectionMatrix;
+  frame.viewProjectionMatrix = m_currentProjectionMatrix * m_currentViewMatrix;
+  frame.cameraPosition = scene.getScenegraph()->getActiveCamera()->getPosition();
+  frame.time = (float)glfwGetTime();
+  frame.useShadowMap = m_useShadowMapping;
 
   if (m_useShadowMapping)
   {
 
-	m_shaderGBuffer->sendInt("shadowMode", *m_pcf);
+	frame.shadowMode = *m_pcf;
 
-    m_shaderGBuffer->sendVec4("light.pos", m_smConeLight->m_position);
-    m_shaderGBuffer->sendVec3("light.col", glm::vec3(m_smConeLight->m_color));
+    frame.light.position = m_smConeLight->m_position;
+    frame.light.color = glm::vec3(m_smConeLight->m_color);
 
-    m_shaderGBuffer->sendVec3("light.spot_direction", m_smConeLight->m_direction);
-    m_shaderGBuffer->sendFloat("light.spot_exponent", m_smConeLight->m_exponent);
-    m_shaderGBuffer->sendFloat("light.spot_cutoff", m_smConeLight->m_radius);
+    frame.light.spotDirection = glm::vec3(m_smConeLight->m_direction);
+    frame.light.spotExponent = m_smConeLight->m_exponent;
+    frame.light.spotCutoff = m_smConeLight->m_radius;
 
-    m_shaderGBuffer->sendVec3("lightAmbient", glm::fvec3(0.3f,0.3f,0.3f));
+    frame.lightAmbient = glm::fvec3(0.3f,0.3f,0.3f);
 
     //Shadow mapping
     glm::mat4 lightPerspective, lightView, lightMVPBias;
@@ -242,35 +306,59 @@ void Renderer::renderScene(Scene& scene, Window& window)
 
     //Build "shadow matrix"
     lightMVPBias = sm_lightViewport * lightPerspective * lightView;
-    m_shaderGBuffer->sendMat4("lightVPBias", lightMVPBias);
-
-    m_shaderGBuffer->sendVec3("mat.diffuse", darkgrey);
-    m_shaderGBuffer->sendVec3("mat.specular", grey);
-    m_shaderGBuffer->sendFloat("mat.shininess", 100.0f);
-    m_shaderGBuffer->sendFloat("mat.alpha", 1.0f);
+    frame.lightVPBias = lightMVPBias;
 
     //Bind and Pass shadow map. Only use SHADOW_TEXTURE_UNIT when Normal Mapping is applied.
-    m_shaderGBuffer->sendSampler2D("depthTexture", m_smFBO->getDepthTexture(), 3);
+    m_shaderGBuffer->sendSampler2D(s_depthTexture, m_smFBO->getDepthTexture(), 3);
   }
+
+  UniformBlocks::getInstance()->setFrame(frame);
+
+  //the default material, uploaded once
+  MaterialUniforms material;
+  material.diffuse = darkgrey;
+  material.specular = grey;
+  material.shininess = 100.0f;
+  material.alpha = 1.0f;
+  UniformBlocks::getInstance()->setMaterial(material);
   
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   
   if (scene.hasSkybox())
   {
 	  glDisable(GL_DEPTH_TEST);
-	  m_shaderGBuffer->sendSkyboxTexture("cubeMap", reinterpret_cast<Skybox*>(scene.getSkyboxNode()->getGeometry())->getSkyboxTexture(),4);
-	  m_shaderGBuffer->sendInt("renderSkybox", 1);
+	  m_shaderGBuffer->sendSkyboxTexture(s_cubeMap, reinterpret_cast<Skybox*>(scene.getSkyboxNode()->getGeometry())->getSkyboxTexture(),4);
+	  m_shaderGBuffer->sendInt(s_renderSkybox, 1);
 	  scene.getSkyboxNode()->render(*m_shaderGBuffer);
 	  glEnable(GL_DEPTH_TEST);
   }
 
-  m_shaderGBuffer->sendInt("renderSkybox", 0);
+  m_shaderGBuffer->sendInt(s_renderSkybox, 0);
   
-  scene.render(*m_shaderGBuffer);
-  m_shaderGBuffer->unbind();
-  
-  //renderParticleSystems
-  scene.renderParticleSystems();
+  if (recorder.joinable())
+  {
+    //scene & particle systems were recorded by the worker
+    recorder.join();
+    m_sceneCommands.execute();
+    m_shaderGBuffer->unbind();
+  }
+  else
+  {
+    if (m_useGPUDrivenRendering)
+    {
+      m_shaderGBufferGPUDriven->bind();
+      m_shaderGBufferGPUDriven->sendInt(s_renderSkybox, 0);
+      if (m_useShadowMapping)
+        m_shaderGBufferGPUDriven->sendSampler2D(s_depthTexture, m_smFBO->getDepthTexture(), 3);
+      scene.renderGPUDriven(*m_shaderGBuffer, *m_shaderGBufferGPUDriven, *scene.getScenegraph()->getActiveCamera());
+    }
+    else
+      scene.render(*m_shaderGBuffer, scene.getScenegraph()->getActiveCamera());
+    m_shaderGBuffer->unbind();
+
+    //renderParticleSystems
+    scene.renderParticleSystems();
+  }
   m_gBuffer->unbind();
 
 
@@ -302,7 +390,7 @@ void Renderer::renderScene(Scene& scene, Window& window)
   //Render SFQ
   m_shaderSFQ->bind();
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  m_shaderSFQ->sendSampler2D("texture", getLastFBO()->getColorTexture(2));
+  m_shaderSFQ->sendSampler2D(s_texture, getLastFBO()->getColorTexture(2), 0);
   m_sfq.renderGeometry();
   m_shaderSFQ->unbind();
 
@@ -421,6 +509,28 @@ void Renderer::useShadowMapping(bool useShadowMapping, int *pcf, ConeLight *cone
 }
 
 
+void Renderer::useGPUDrivenRendering(bool useGPUDrivenRendering)
+{
+  if (useGPUDrivenRendering && !GPUScene::isSupported())
+  {
+    std::cout << "WARNING: GPU driven rendering needs OpenGL 4.3, the scenes are rendered as before" << std::endl;
+    useGPUDrivenRendering = false;
+  }
+  m_useGPUDrivenRendering = useGPUDrivenRendering;
+
+  if (m_useGPUDrivenRendering && !m_shaderGBufferGPUDriven)
+  {
+    VertexShader vsGBufferGPUDriven(loadShaderSource(SHADERS_PATH + std::string("/GBuffer/GBufferGPUDriven.vert")));
+    FragmentShader fsGBufferGPUDriven(loadShaderSource(SHADERS_PATH + std::string("/GBuffer/GBuffer.frag"), UNIFORM_BLOCKS_DEFINE));
+    m_shaderGBufferGPUDriven = new ShaderProgram(vsGBufferGPUDriven, fsGBufferGPUDriven);
+  }
+}
+
+void Renderer::useParallelRecording(bool useParallelRecording)
+{
+  m_useParallelRecording = useParallelRecording;
+}
+
 void Renderer::bindFBO()
 {
   if (!m_currentFBOIndex)
@@ -479,20 +589,18 @@ void Renderer::renderReflections(float camNear, float camFar)
   m_shaderRLR->bind();
 
 
-  m_shaderRLR->sendSampler2D("positionTexture", m_gBuffer->getColorTexture(0), 0);
-  m_shaderRLR->sendSampler2D("normalTexture", m_gBuffer->getColorTexture(1), 1);
-  m_shaderRLR->sendSampler2D("colorTexture", getLastFBO()->getColorTexture(2), 2);
-  m_shaderRLR->sendSampler2D("depthBuffer", m_gBuffer->getDepthTexture(), 3);
+  m_shaderRLR->sendSampler2D(s_positionTexture, m_gBuffer->getColorTexture(0), 0);
+  m_shaderRLR->sendSampler2D(s_normalTexture, m_gBuffer->getColorTexture(1), 1);
+  m_shaderRLR->sendSampler2D(s_colorTexture, getLastFBO()->getColorTexture(2), 2);
+  m_shaderRLR->sendSampler2D(s_depthBuffer, m_gBuffer->getDepthTexture(), 3);
 
-  m_shaderRLR->sendMat4("projectionMatrix", m_currentProjectionMatrix);
+  m_shaderRLR->sendInt(s_screenWidth, m_windowWidth);
+  m_shaderRLR->sendInt(s_screenHeight, m_windowHeight);
 
-  m_shaderRLR->sendInt("screenWidth", m_windowWidth);
-  m_shaderRLR->sendInt("screenHeight", m_windowHeight);
+  m_shaderRLR->sendFloat(s_zNear, camNear);
+  m_shaderRLR->sendFloat(s_zFar, camFar);
 
-  m_shaderRLR->sendFloat("zNear", camNear);
-  m_shaderRLR->sendFloat("zFar", camFar);
-
-  m_shaderRLR->sendFloat("reflectivity", *m_screenSpaceReflectionsStrength);
+  m_shaderRLR->sendFloat(s_reflectivity, *m_screenSpaceReflectionsStrength);
 
   m_sfq.renderGeometry();
 
@@ -510,9 +618,9 @@ void Renderer::renderAntiAliasing()
 
   m_shaderFXAA->bind();
 
-  m_shaderFXAA->sendSampler2D("colorTexture", getLastFBO()->getColorTexture(2), 2);
-  m_shaderFXAA->sendInt("fboWidth", m_windowWidth);
-  m_shaderFXAA->sendInt("fboHeight", m_windowHeight);
+  m_shaderFXAA->sendSampler2D(s_colorTexture, getLastFBO()->getColorTexture(2), 2);
+  m_shaderFXAA->sendInt(s_fboWidth, m_windowWidth);
+  m_shaderFXAA->sendInt(s_fboHeight, m_windowHeight);
 
   m_sfq.renderGeometry();
 
@@ -542,16 +650,13 @@ void Renderer::renderDeferredShading()
 
   m_shaderDSLighting->bind();
 
-  m_shaderDSLighting->sendMat4("viewMatrix", m_currentViewMatrix);
-  m_shaderDSLighting->sendMat4("projectionMatrix", m_currentProjectionMatrix);
-
-  m_shaderDSLighting->sendSampler2D("positionMap", m_gBuffer->getColorTexture(0), 0);
-  m_shaderDSLighting->sendSampler2D("normalMap", m_gBuffer->getColorTexture(1), 1);
+  m_shaderDSLighting->sendSampler2D(s_positionMap, m_gBuffer->getColorTexture(0), 0);
+  m_shaderDSLighting->sendSampler2D(Uniforms::normalMap, m_gBuffer->getColorTexture(1), 1);
 
-  m_shaderDSLighting->sendInt("windowWidth", m_windowWidth);
-  m_shaderDSLighting->sendInt("windowHeight", m_windowHeight);
+  m_shaderDSLighting->sendInt(s_windowWidth, m_windowWidth);
+  m_shaderDSLighting->sendInt(s_windowHeight, m_windowHeight);
 
-  m_shaderDSLighting->sendVec3("lightColor", *m_dsLightColor);
+  m_shaderDSLighting->sendVec3(s_lightColor, *m_dsLightColor);
 
   m_dsLightRootNode->render(*m_shaderDSLighting);
 
@@ -567,8 +672,8 @@ void Renderer::renderDeferredShading()
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   m_shaderDSCompositing->bind();
 
-  m_shaderDSCompositing->sendSampler2D("colorMap", getLastFBO()->getColorTexture(2), 0);
-  m_shaderDSCompositing->sendSampler2D("lightMap", a->getColorTexture(2), 1);
+  m_shaderDSCompositing->sendSampler2D(s_colorMap, getLastFBO()->getColorTexture(2), 0);
+  m_shaderDSCompositing->sendSampler2D(s_lightMap, a->getColorTexture(2), 1);
 
   m_sfq.renderGeometry();
 
@@ -589,8 +694,8 @@ void Renderer::renderBloom()
 
   m_shaderBloom->bind();
 
-  m_shaderBloom->sendSampler2D("bgl_RenderedTexture", getLastFBO()->getColorTexture(2),2);
-  m_shaderBloom->sendFloat("bloomStrength", *m_bloomStrength);
+  m_shaderBloom->sendSampler2D(s_bgl_RenderedTexture, getLastFBO()->getColorTexture(2),2);
+  m_shaderBloom->sendFloat(s_bloomStrength, *m_bloomStrength);
   m_sfq.renderGeometry();
 
   m_shaderBloom->unbind();
@@ -608,8 +713,8 @@ void Renderer::renderBlur()
 
 	m_shaderBlur->bind();
 	
-	m_shaderBlur->sendSampler2D("image", getLastFBO()->getColorTexture(2), 2);
-	m_shaderBlur->sendFloat("blurstrength", *m_blurStrength);
+	m_shaderBlur->sendSampler2D(s_image, getLastFBO()->getColorTexture(2), 2);
+	m_shaderBlur->sendFloat(s_blurstrength, *m_blurStrength);
 	m_sfq.renderGeometry();
 
 	m_shaderBlur->unbind();
@@ -626,8 +731,8 @@ void Renderer::renderRadialBlur()
 
 	m_shaderRadialBlur->bind();
 
-	m_shaderRadialBlur->sendSampler2D("tex", getLastFBO()->getColorTexture(2), 2);
-	m_shaderRadialBlur->sendFloat("blurstrength", *m_radialBlurStrength);
+	m_shaderRadialBlur->sendSampler2D(s_tex, getLastFBO()->getColorTexture(2), 2);
+	m_shaderRadialBlur->sendFloat(s_blurstrength, *m_radialBlurStrength);
 	m_sfq.renderGeometry();
 
 	m_shaderRadialBlur->unbind();
@@ -647,8 +752,8 @@ void Renderer::renderDoF(Scene& scene)
 
 	//Set the shader for the light pass. This shader is highly optimized because the scene depth is the only thing that matters here!
 	m_shaderDepth->bind();
-	m_shaderDepth->sendMat4("viewMatrix", m_currentViewMatrix);
-	m_shaderDepth->sendMat4("projectionMatrix", m_currentProjectionMatrix);
+	m_shaderDepth->sendMat4(Uniforms::viewMatrix, m_currentViewMatrix);
+	m_shaderDepth->sendMat4(Uniforms::projectionMatrix, m_currentProjectionMatrix);
 
 	//Render the scene
 	scene.render(*m_shaderDepth);
@@ -662,10 +767,10 @@ void Renderer::renderDoF(Scene& scene)
 
 	m_shaderDoF->bind();
 
-	m_shaderDoF->sendSampler2D("tex", getLastFBO()->getColorTexture(2), 2);
-	m_shaderDoF->sendSampler2D("depth", m_smFBO->getDepthTexture(), 1);
+	m_shaderDoF->sendSampler2D(s_tex, getLastFBO()->getColorTexture(2), 2);
+	m_shaderDoF->sendSampler2D(s_depth, m_smFBO->getDepthTexture(), 1);
 
-	m_shaderDoF->sendFloat("focus_depth", *m_focusDepth);
+	m_shaderDoF->sendFloat(s_focus_depth, *m_focusDepth);
 
 	m_sfq.renderGeometry();
 
@@ -689,11 +794,11 @@ void Renderer::renderSSAO()
 
   m_shaderSSAOcalc->bind();
 
-  m_shaderSSAOcalc->sendSampler2D("positionMap", m_gBuffer->getColorTexture(0), 0);
-  m_shaderSSAOcalc->sendSampler2D("normalMap", m_gBuffer->getColorTexture(1), 1);
-  m_shaderSSAOcalc->sendMat4("sceneProjectionMatrix", m_currentProjectionMatrix);
-  m_shaderSSAOcalc->sendFloat("radius", *m_ssaoRadius);
-  m_shaderSSAOcalc->sendFloat("quality", *m_ssaoQuality);
+  m_shaderSSAOcalc->sendSampler2D(s_positionMap, m_gBuffer->getColorTexture(0), 0);
+  m_shaderSSAOcalc->sendSampler2D(Uniforms::normalMap, m_gBuffer->getColorTexture(1), 1);
+  m_shaderSSAOcalc->sendMat4(s_sceneProjectionMatrix, m_currentProjectionMatrix);
+  m_shaderSSAOcalc->sendFloat(s_radius, *m_ssaoRadius);
+  m_shaderSSAOcalc->sendFloat(s_quality, *m_ssaoQuality);
 
   m_sfq.renderGeometry();
 
@@ -707,8 +812,8 @@ void Renderer::renderSSAO()
 
   //glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   m_shaderSSAOblur->bind();
-  m_shaderSSAOblur->sendSampler2D("colortexture", a->getColorTexture(2), 0);
-  m_shaderSSAOblur->sendInt("secondPass", 0);
+  m_shaderSSAOblur->sendSampler2D(s_colortexture, a->getColorTexture(2), 0);
+  m_shaderSSAOblur->sendInt(s_secondPass, 0);
   m_sfq.renderGeometry();
 
   m_shaderSSAOblur->unbind();
@@ -721,8 +826,8 @@ void Renderer::renderSSAO()
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
   m_shaderSSAOblur->bind();
-  m_shaderSSAOblur->sendSampler2D("colortexture", b->getColorTexture(2), 0);
-  m_shaderSSAOblur->sendFloat("secondPass", 1);
+  m_shaderSSAOblur->sendSampler2D(s_colortexture, b->getColorTexture(2), 0);
+  m_shaderSSAOblur->sendFloat(s_secondPass, 1);
   m_sfq.renderGeometry();
 
   m_shaderSSAOblur->unbind();
@@ -735,8 +840,8 @@ void Renderer::renderSSAO()
   bindFBO();
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   m_shaderSSAOfinal->bind();
-  m_shaderSSAOfinal->sendSampler2D("colorMap", getLastFBO()->getColorTexture(2), 0);
-  m_shaderSSAOfinal->sendSampler2D("ssaoMap", a->getColorTexture(2), 1);
+  m_shaderSSAOfinal->sendSampler2D(s_colorMap, getLastFBO()->getColorTexture(2), 0);
+  m_shaderSSAOfinal->sendSampler2D(s_ssaoMap, a->getColorTexture(2), 1);
   m_sfq.renderGeometry();
   m_shaderSSAOfinal->unbind();
   unbindFBO();
@@ -770,8 +875,8 @@ void Renderer::renderShadowMapping(Scene& scene)
 
   //Set the shader for the light pass. This shader is highly optimized because the scene depth is the only thing that matters here!
   m_shaderShadowMapping->bind();
-  m_shaderShadowMapping->sendMat4("viewMatrix", m_smCam->getViewMatrix());
-  m_shaderShadowMapping->sendMat4("projectionMatrix", m_smCam->getProjectionMatrix());
+  m_shaderShadowMapping->sendMat4(Uniforms::viewMatrix, m_smCam->getViewMatrix());
+  m_shaderShadowMapping->sendMat4(Uniforms::projectionMatrix, m_smCam->getProjectionMatrix());
 
   //Render the scene
   scene.render(*m_shaderShadowMapping);
@@ -69,6 +69,11 @@ public:
   void useDoF(bool useDoF, float *focusDepth = new float(0.04f));
   void useSSAO(bool useSSAO, float *quality = new float(30.0f), float *radius = new float(0.1f));
   void useShadowMapping(bool useShadowMapping, int *usePCF, ConeLight *coneLight = nullptr);
+  ///Culls & draws the opaque objects on the GPU (GPUScene), needs OpenGL 4.3
+  void useGPUDrivenRendering(bool useGPUDrivenRendering);
+  ///Records the G-buffer pass on a worker thread (Scene::record) while the GL thread sets up the frame
+  /**The scenegraph must not be changed by other threads during renderScene*/
+  void useParallelRecording(bool useParallelRecording);
 
   void addGui(GUI *guiToAdd);
 
@@ -98,6 +103,8 @@ private:
   bool m_useDeferredShading;
   bool m_useSSAO;
   bool m_useShadowMapping;
+  bool m_useGPUDrivenRendering;
+  bool m_useParallelRecording;
   
   Node *m_dsLightRootNode;
   glm::fvec3 *m_dsLightColor;
@@ -145,6 +152,8 @@ private:
   ShaderProgram *m_shaderSSAOblur;
   ShaderProgram *m_shaderSSAOfinal;
   ShaderProgram *m_shaderShadowMapping;
+  ShaderProgram *m_shaderGBufferGPUDriven;
   
   Rect m_sfq;
+  RenderCommandBuffer m_sceneCommands;	//of the parallel recording
 };
\ No newline at end of file
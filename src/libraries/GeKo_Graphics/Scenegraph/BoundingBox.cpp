@@ -2,99 +2,36 @@
 
 BoundingBox::BoundingBox()
 {
-
+	m_collisionDetected = false;
 }
 
 BoundingBox::BoundingBox(Node* object){
-	m_vertices = object->getGeometry()->getVertices();
+	m_collisionDetected = false;
+	boundingBox(object);
 }
 
 BoundingBox::~BoundingBox(){
-    m_vertices.clear();
+	m_box.clear();
 }
 
 void BoundingBox::boundingBox(Node* object){
-	float maxX = m_vertices.at(0).x;
-	float minX = m_vertices.at(0).x;
-	
-	float maxY = m_vertices.at(0).y;
-	float minY = m_vertices.at(0).y;
-
-	float maxZ = m_vertices.at(0).z;
-	float minZ = m_vertices.at(0).z;
-	
-	for (int i = 1; i < m_vertices.size(); i++){
-		if (m_vertices.at(i).x > maxX){
-			maxX = m_vertices.at(i).x;
-		}
-		if (m_vertices.at(i).y > maxY){
-			maxY = m_vertices.at(i).y;
-		}
-		if (m_vertices.at(i).z > maxZ){
-			maxZ = m_vertices.at(i).z;
-		}
-		
-		if (m_vertices.at(i).x < minX){
-			minX = m_vertices.at(i).x;
-		}
-		if (m_vertices.at(i).y < minY){
-			minY = m_vertices.at(i).y;
-		}
-		if (m_vertices.at(i).z < minZ){
-			minZ = m_vertices.at(i).z;
-		}
-	}
-	
-	
-	m_box.push_back(glm::vec4(minX, minY, maxZ, 1.0));
-	m_box.push_back(glm::vec4(maxX, minY, maxZ, 1.0));
-
-	m_box.push_back(glm::vec4(minX, minY, minZ, 1.0));
-	m_box.push_back(glm::vec4(maxX, minY, minZ, 1.0));
-
-	m_box.push_back(glm::vec4(minX, maxY, maxZ, 1.0));
-	m_box.push_back(glm::vec4(maxX, maxY, maxZ, 1.0));
-
-	m_box.push_back(glm::vec4(minX, maxY, minZ, 1.0));
-	m_box.push_back(glm::vec4(maxX, maxY, minZ, 1.0));
-	
+	boundingBox(object->getGeometry());
 }
 
 void BoundingBox::boundingBox(Geometry* geometry)
 {
-	m_vertices = geometry->getVertices();
-
-	float maxX = m_vertices.at(0).x;
-	float minX = m_vertices.at(0).x;
-
-	float maxY = m_vertices.at(0).y;
-	float minY = m_vertices.at(0).y;
-
-	float maxZ = m_vertices.at(0).z;
-	float minZ = m_vertices.at(0).z;
-
-	for (int i = 1; i < m_vertices.size(); i++){
-		if (m_vertices.at(i).x > maxX){
-			maxX = m_vertices.at(i).x;
-		}
-		if (m_vertices.at(i).y > maxY){
-			maxY = m_vertices.at(i).y;
-		}
-		if (m_vertices.at(i).z > maxZ){
-			maxZ = m_vertices.at(i).z;
-		}
-
-		if (m_vertices.at(i).x < minX){
-			minX = m_vertices.at(i).x;
-		}
-		if (m_vertices.at(i).y < minY){
-			minY = m_vertices.at(i).y;
-		}
-		if (m_vertices.at(i).z < minZ){
-			minZ = m_vertices.at(i).z;
-		}
-	}
+	//The box is cached on the geometry, so no vertices are copied or iterated here
+	const GeometryBounds& bounds = geometry->getBounds();
+
+	float minX = bounds.boxMin.x;
+	float minY = bounds.boxMin.y;
+	float minZ = bounds.boxMin.z;
+
+	float maxX = bounds.boxMax.x;
+	float maxY = bounds.boxMax.y;
+	float maxZ = bounds.boxMax.z;
 
+	m_box.clear();
 
 	m_box.push_back(glm::vec4(minX, minY, maxZ, 1.0));
 	m_box.push_back(glm::vec4(maxX, minY, maxZ, 1.0));
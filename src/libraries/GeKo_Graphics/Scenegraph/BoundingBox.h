@@ -14,8 +14,8 @@ public:
 	BoundingBox(Geometry* object, glm::mat4 modelMatrix);
 	~BoundingBox();
 
-	///Returns all points of the Box
-	/**/
+	///Computes all points of the Box
+	/**The corners are taken from the cached bounds of the geometry of the node*/
 	void boundingBox(Node* object);
 
 	void boundingBox(Geometry* geometry);
@@ -32,7 +32,6 @@ public:
 	bool getCollisionDetected();
 
 private:
-    std::vector<glm::vec4> m_vertices;
 	std::vector<glm::vec4> m_box;
 
 	bool m_collisionDetected;
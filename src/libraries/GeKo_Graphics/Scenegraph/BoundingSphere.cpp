@@ -7,6 +7,7 @@ BoundingSphere::BoundingSphere(Geometry* object, glm::mat4 modelMatrix){
 
 BoundingSphere::BoundingSphere(double rad, glm::vec3 cent)
 {
+	m_collisionDetected = false;
 	radius = rad;
 	center = cent;
 	originalCenter = cent;
@@ -34,46 +35,13 @@ bool BoundingSphere::getCollisionDetected()
 
 void BoundingSphere::createSphere(Geometry* object, glm::mat4 modelMatrix)
 {
-	std::vector<glm::vec4> vs = object->getVertices();
-
-	int i, n;
-	float dx, dy, dz, le;
-	glm::vec4 lev(1.0);
-
-	n = vs.size();
-
-	center = glm::vec3(0.0);
-
-	for (int i = 0; i < n - 1; i++)
-	{
-		center.x = center.x + vs.at(i).x;
-		center.y = center.y + vs.at(i).y;
-		center.z = center.z + vs.at(i).z;
+	//The sphere is computed once per geometry, here it is only transformed into world space
+	const GeometryBounds& bounds = object->getBounds();
 
-		center.x = center.x / n;
-		center.y = center.y / n;
-		center.z = center.z / n;
-	}
+	//A scaled model matrix scales the radius with its largest axis
+	float scale = glm::max(glm::length(glm::vec3(modelMatrix[0])), glm::max(glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2]))));
 
-	radius = 0;
-
-	for (int i = 0; i < n - 1; i++)
-	{
-		dx = vs.at(i).x - center.x;
-		dy = vs.at(i).y - center.y;
-		dz = vs.at(i).z - center.z;
-
-		lev.x = dx;
-		lev.y = dy;
-		lev.z = dz;
-		lev = modelMatrix * lev;
-
-		if (radius < glm::length(lev))
-		{
-			radius = glm::length(lev);
-		}
-	}
-
-	originalCenter = center;
-	center = glm::vec3(modelMatrix * glm::vec4(center, 1.0));
+	radius = bounds.sphereRadius * scale;
+	originalCenter = bounds.sphereCenter;
+	center = glm::vec3(modelMatrix * glm::vec4(originalCenter, 1.0));
 }
\ No newline at end of file
@@ -0,0 +1,380 @@
+#include "GPUScene.h"
+#include <GeKo_Graphics/Geometry/Geometry.h>
+#include <GeKo_Graphics/Camera/Frustum.h>
+#include <GeKo_Graphics/Shader/ShaderManager.h>
+#include <GeKo_Graphics/Material/TextureManager.h>
+#include <GeKo_Graphics/Shader/Uniforms.h>
+#include <GeKo_Graphics/RadixSort.h>
+
+//SSBO bindings of the shaders, 0 & 1 are used by the particles
+static const GLuint OBJECT_BINDING = 3;
+static const GLuint COMMAND_BINDING = 4;
+static const GLuint VISIBLE_BINDING = 5;
+//the instanced attribute with the index of the object, after the instance matrix (4 .. 7)
+static const GLuint OBJECT_INDEX_LOCATION = 8;
+static const GLuint CULL_GROUP_SIZE = 64;
+
+//sort key: material 63..48, mesh 47..24, item 23..0
+static const int ITEM_BITS = 24;
+static const int MESH_BITS = 24;
+static const uint64_t ITEM_MASK = (1ull << ITEM_BITS) - 1;
+static const uint64_t MESH_MASK = (1ull << MESH_BITS) - 1;
+static const int MAX_MATERIALS = 1 << 16;
+
+static const UniformHandle s_frustumPlanes("frustumPlanes");
+static const UniformHandle s_objectCount("objectCount");
+
+GPUScene::GPUScene()
+{
+	m_meshesDirty = false;
+	m_vao = 0;
+	m_vertexBuffer = 0;
+	m_normalBuffer = 0;
+	m_uvBuffer = 0;
+	m_indexBuffer = 0;
+	m_objectBuffer = 0;
+	m_commandBuffer = 0;
+	m_visibleBuffer = 0;
+	m_objectBufferSize = 0;
+	m_commandBufferSize = 0;
+	m_cullProgram = nullptr;
+	m_errorReported = false;
+}
+
+GPUScene::~GPUScene()
+{
+	if (!m_vao)
+		return;
+	glDeleteVertexArrays(1, &m_vao);
+	GLuint buffers[] = { m_vertexBuffer, m_normalBuffer, m_uvBuffer, m_indexBuffer, m_objectBuffer, m_commandBuffer, m_visibleBuffer };
+	glDeleteBuffers(7, buffers);
+}
+
+bool GPUScene::isSupported()
+{
+	return GLEW_VERSION_4_3 != 0;
+}
+
+void GPUScene::render(ShaderProgram& program, RenderQueue& queue, Camera& cullingCamera)
+{
+	if (!isSupported())
+	{
+		if (!m_errorReported)
+			std::cout << "ERROR: GPUScene needs OpenGL 4.3, nothing is drawn" << std::endl;
+		m_errorReported = true;
+		return;
+	}
+	if (!m_vao)
+		createBuffers();
+	if (!m_cullProgram)
+		m_cullProgram = ShaderManager::getInstance()->getComputeProgram("/GPUDriven/CullObjects.comp");
+
+	buildObjects(queue.getItems());
+	if (m_objects.empty())
+		return;
+	uploadMeshes();
+
+	//objects & commands of this frame, the old storage is orphaned
+	GLsizeiptr objectSize = m_objects.size() * sizeof(GPUObject);
+	if (objectSize > m_objectBufferSize)
+		m_objectBufferSize = objectSize * 2;
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_objectBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, m_objectBufferSize, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, objectSize, m_objects.data());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_visibleBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, m_objectBufferSize / sizeof(GPUObject) * sizeof(GLuint), NULL, GL_STREAM_DRAW);
+
+	GLsizeiptr commandSize = m_commands.size() * sizeof(DrawElementsIndirectCommand);
+	if (commandSize > m_commandBufferSize)
+		m_commandBufferSize = commandSize * 2;
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_commandBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, m_commandBufferSize, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, commandSize, m_commands.data());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	cull(cullingCamera);
+	draw(program);
+}
+
+void GPUScene::buildObjects(const std::vector<DrawItem>& items)
+{
+	m_materials.clear();
+	m_objects.clear();
+	m_commands.clear();
+	m_keys.clear();
+
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		const DrawItem& item = items[i];
+		if (item.transparent)
+			continue;
+		int mesh = getMesh(item.geometry);
+		int material = getMaterial(item);
+		if (i > ITEM_MASK || (uint64_t)mesh > MESH_MASK || material >= MAX_MATERIALS)
+		{
+			if (!m_errorReported)
+				std::cout << "WARNING: GPUScene is full, objects are dropped" << std::endl;
+			m_errorReported = true;
+			continue;
+		}
+		m_keys.push_back(((uint64_t)material << (ITEM_BITS + MESH_BITS)) | ((uint64_t)mesh << ITEM_BITS) | i);
+	}
+	RadixSort::sort(m_keys, m_sortTemp);
+
+	//a command per (material, mesh), its objects are next to each other from baseInstance on
+	uint64_t lastPair = ~0ull;
+	for (auto key : m_keys)
+	{
+		const DrawItem& item = items[key & ITEM_MASK];
+		int mesh = (int)((key >> ITEM_BITS) & MESH_MASK);
+		int material = (int)(key >> (ITEM_BITS + MESH_BITS));
+
+		if ((key >> ITEM_BITS) != lastPair)
+		{
+			lastPair = key >> ITEM_BITS;
+			DrawElementsIndirectCommand command;
+			command.count = m_meshes[mesh].indexCount;
+			command.instanceCount = 0;
+			command.firstIndex = m_meshes[mesh].firstIndex;
+			command.baseVertex = m_meshes[mesh].baseVertex;
+			command.baseInstance = (GLuint)m_objects.size();
+
+			GPUMaterial& entry = m_materials[material];
+			if (entry.commandCount == 0)
+				entry.firstCommand = (int)m_commands.size();
+			entry.commandCount++;
+			m_commands.push_back(command);
+		}
+
+		const glm::mat4& model = item.object.modelMatrix;
+		const GeometryBounds& bounds = item.geometry->getBounds();
+		float scale = glm::max(glm::length(glm::vec3(model[0])), glm::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+
+		GPUObject object;
+		object.modelMatrix = model;
+		object.previousModelMatrix = item.object.previousModelMatrix;
+		object.boundingSphere = glm::vec4(glm::vec3(model * glm::vec4(bounds.sphereCenter, 1.0f)), bounds.sphereRadius * scale);
+		object.slot = (GLuint)(m_commands.size() - 1);
+		object.material = (GLuint)material;
+		object.padding[0] = 0;
+		object.padding[1] = 0;
+		m_objects.push_back(object);
+	}
+}
+
+void GPUScene::cull(Camera& cullingCamera)
+{
+	Frustum frustum(cullingCamera);
+
+	m_cullProgram->bind();
+	glUniform4fv(m_cullProgram->getLocation(s_frustumPlanes), 6, &frustum.getPlanes()[0][0]);
+	m_cullProgram->sendInt(s_objectCount, (int)m_objects.size());
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, OBJECT_BINDING, m_objectBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COMMAND_BINDING, m_commandBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VISIBLE_BINDING, m_visibleBuffer);
+
+	GLuint groups = ((GLuint)m_objects.size() + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE;
+	glDispatchCompute(groups, 1, 1);
+
+	//the commands & visible objects are read as indirect commands & vertex attribute by the draw
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COMMAND_BINDING, 0);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VISIBLE_BINDING, 0);
+	m_cullProgram->unbind();
+}
+
+void GPUScene::draw(ShaderProgram& program)
+{
+	program.bind();
+	program.sendInt(Uniforms::testTexture, 0);
+	program.sendInt(Uniforms::normalMap, 1);
+	program.sendInt(Uniforms::heightMap, 2);
+
+	//the vertex shader reads the objects, the binding of the culling is still there
+	glBindVertexArray(m_vao);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+
+	for (auto& material : m_materials)
+	{
+		if (material.commandCount == 0)
+			continue;
+		for (int unit = 0; unit < 3; unit++)
+		{
+			if (material.textures[unit] != 0)
+			{
+				glActiveTexture(GL_TEXTURE0 + unit);
+				glBindTexture(GL_TEXTURE_2D, material.textures[unit]);
+				TextureManager::getInstance()->bindSampler(unit, material.samplers[unit]);
+			}
+		}
+		UniformBlocks::getInstance()->pushObject(material.object);
+
+		const void* offset = (const void*)(material.firstCommand * sizeof(DrawElementsIndirectCommand));
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, offset, material.commandCount, 0);
+	}
+
+	for (GLuint unit = 0; unit < 3; unit++)
+		glBindSampler(unit, 0);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	glBindVertexArray(0);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, OBJECT_BINDING, 0);
+}
+
+void GPUScene::clearMeshes()
+{
+	m_meshIds.clear();
+	m_meshes.clear();
+	m_vertices.clear();
+	m_normals.clear();
+	m_uvs.clear();
+	m_indices.clear();
+	m_meshesDirty = true;
+}
+
+int GPUScene::getMeshCount()
+{
+	return (int)m_meshes.size();
+}
+
+int GPUScene::getObjectCount()
+{
+	return (int)m_objects.size();
+}
+
+int GPUScene::getDrawCalls()
+{
+	int drawCalls = 0;
+	for (auto& material : m_materials)
+	{
+		if (material.commandCount > 0)
+			drawCalls++;
+	}
+	return drawCalls;
+}
+
+int GPUScene::getMesh(Geometry* geometry)
+{
+	auto entry = m_meshIds.find(geometry);
+	if (entry != m_meshIds.end())
+		return entry->second;
+
+	const std::vector<glm::vec4>& vertices = geometry->getVertices();
+	std::vector<glm::vec3> normals = geometry->getNormals();
+	std::vector<glm::vec2> uvs = geometry->getUV();
+
+	GPUMesh mesh;
+	mesh.firstIndex = (GLuint)m_indices.size();
+	mesh.baseVertex = (GLint)m_vertices.size();
+
+	//missing streams are filled, so the vertices of all meshes stay aligned
+	m_vertices.insert(m_vertices.end(), vertices.begin(), vertices.end());
+	if (normals.size() == vertices.size())
+		m_normals.insert(m_normals.end(), normals.begin(), normals.end());
+	else
+		m_normals.resize(m_vertices.size(), glm::vec3(0.0f, 1.0f, 0.0f));
+	if (uvs.size() == vertices.size())
+		m_uvs.insert(m_uvs.end(), uvs.begin(), uvs.end());
+	else
+		m_uvs.resize(m_vertices.size(), glm::vec2(0.0f));
+
+	if (geometry->hasIndex())
+	{
+		std::vector<GLuint> indices = geometry->getIndexList();
+		m_indices.insert(m_indices.end(), indices.begin(), indices.end());
+	}
+	else
+	{
+		for (GLuint i = 0; i < vertices.size(); i++)
+			m_indices.push_back(i);
+	}
+	mesh.indexCount = (GLuint)m_indices.size() - mesh.firstIndex;
+
+	int id = (int)m_meshes.size();
+	m_meshes.push_back(mesh);
+	m_meshIds[geometry] = id;
+	m_meshesDirty = true;
+	return id;
+}
+
+int GPUScene::getMaterial(const DrawItem& item)
+{
+	const ObjectUniforms& object = item.object;
+	//few materials per scene, the items of a node subtree mostly share the last one
+	for (int i = (int)m_materials.size() - 1; i >= 0; i--)
+	{
+		const GPUMaterial& material = m_materials[i];
+		const ObjectUniforms& other = material.object;
+		if (material.textures[0] == item.textures[0] && material.textures[1] == item.textures[1] && material.textures[2] == item.textures[2]
+			&& material.samplers[0] == item.samplers[0] && material.samplers[1] == item.samplers[1] && material.samplers[2] == item.samplers[2]
+			&& other.useTexture == object.useTexture && other.useNormalMap == object.useNormalMap && other.useHeightMap == object.useHeightMap
+			&& other.useHeightMapShadows == object.useHeightMapShadows && other.parallaxScale == object.parallaxScale && other.parallaxBias == object.parallaxBias)
+			return i;
+	}
+
+	GPUMaterial material;
+	for (int unit = 0; unit < 3; unit++)
+	{
+		material.textures[unit] = item.textures[unit];
+		material.samplers[unit] = item.samplers[unit];
+	}
+	material.object = object;
+	material.object.modelMatrix = glm::mat4(1.0f);
+	material.object.previousModelMatrix = glm::mat4(1.0f);
+	material.object.useInstancing = 0;
+	material.firstCommand = 0;
+	material.commandCount = 0;
+	m_materials.push_back(material);
+	return (int)m_materials.size() - 1;
+}
+
+void GPUScene::createBuffers()
+{
+	glGenVertexArrays(1, &m_vao);
+	glGenBuffers(1, &m_vertexBuffer);
+	glGenBuffers(1, &m_normalBuffer);
+	glGenBuffers(1, &m_uvBuffer);
+	glGenBuffers(1, &m_indexBuffer);
+	glGenBuffers(1, &m_objectBuffer);
+	glGenBuffers(1, &m_commandBuffer);
+	glGenBuffers(1, &m_visibleBuffer);
+
+	//the layout of Geometry (0 position, 1 normal, 2 uv) and the index of the object
+	glBindVertexArray(m_vao);
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, 0);
+	glBindBuffer(GL_ARRAY_BUFFER, m_normalBuffer);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, 0);
+	glBindBuffer(GL_ARRAY_BUFFER, m_uvBuffer);
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, 0);
+	glBindBuffer(GL_ARRAY_BUFFER, m_visibleBuffer);
+	glEnableVertexAttribArray(OBJECT_INDEX_LOCATION);
+	glVertexAttribIPointer(OBJECT_INDEX_LOCATION, 1, GL_UNSIGNED_INT, 0, 0);
+	glVertexAttribDivisor(OBJECT_INDEX_LOCATION, 1);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void GPUScene::uploadMeshes()
+{
+	if (!m_meshesDirty)
+		return;
+	m_meshesDirty = false;
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(glm::vec4), m_vertices.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, m_normalBuffer);
+	glBufferData(GL_ARRAY_BUFFER, m_normals.size() * sizeof(glm::vec3), m_normals.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, m_uvBuffer);
+	glBufferData(GL_ARRAY_BUFFER, m_uvs.size() * sizeof(glm::vec2), m_uvs.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	//the index buffer is bound to the VAO
+	glBindVertexArray(m_vao);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(GLuint), m_indices.data(), GL_STATIC_DRAW);
+	glBindVertexArray(0);
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <GeKo_Graphics/Scenegraph/RenderQueue.h>
+#include <GeKo_Graphics/Camera/Camera.h>
+
+///An object of the GPU driven path, the std430 layout of GPUObject in shaders/GPUDriven/GPUObjects.glsl
+struct GPUObject
+{
+	glm::mat4 modelMatrix;
+	glm::mat4 previousModelMatrix;
+	glm::vec4 boundingSphere;	//world space, xyz center, w radius
+	GLuint slot;	//index of the draw command
+	GLuint material;
+	GLuint padding[2];
+};
+static_assert(sizeof(GPUObject) == 160, "GPUObject has to match the std430 layout of the shader");
+
+///A command of glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand
+{
+	GLuint count;
+	GLuint instanceCount;
+	GLuint firstIndex;
+	GLint baseVertex;
+	GLuint baseInstance;
+};
+
+///The part of the shared buffers holding the mesh of a Geometry
+struct GPUMesh
+{
+	GLuint firstIndex;
+	GLuint indexCount;
+	GLint baseVertex;
+};
+
+///Textures & flags of the objects drawn by one multi draw
+struct GPUMaterial
+{
+	GLuint textures[3];
+	TextureSampler samplers[3];
+	ObjectUniforms object;	//flags & parallax values, the matrices are not used
+	int firstCommand;
+	int commandCount;
+};
+
+///Draws the opaque items of a RenderQueue with GPU culling & multi draw indirect
+/*
+Description: The meshes of all geometries are copied once into shared vertex & index buffers (one VAO),
+so a draw only needs a range of them. Per frame the opaque items become GPUObjects in one SSBO:
+world matrix, previous world matrix, world bounding sphere, draw command & material.
+The objects are sorted by material & mesh, every (material, mesh) pair is one DrawElementsIndirectCommand
+whose instances are its objects.
+
+A compute pass (shaders/GPUDriven/CullObjects.comp) tests the spheres against the view frustum and appends
+the visible objects to their command, the index of the object is an instanced attribute (location 8) that the
+vertex shader (shaders/GBuffer/GBufferGPUDriven.vert) uses to read its GPUObject. The CPU only uploads the objects
+and issues one glMultiDrawElementsIndirect per material, whatever the number of objects.
+
+Needs OpenGL 4.3 (isSupported). A Geometry is copied with its first draw, call clearMeshes if geometries were
+changed or deleted, Scene does it when its static batches are rebaked.
+*/
+class GPUScene
+{
+public:
+	GPUScene();
+	~GPUScene();
+
+	///True if the context has compute shaders & multi draw indirect
+	static bool isSupported();
+
+	///Culls & draws the opaque items of the queue with program, the queue has to be filled but not submitted
+	void render(ShaderProgram& program, RenderQueue& queue, Camera& cullingCamera);
+
+	///Empties the shared buffers, the meshes are copied again with their next draw
+	void clearMeshes();
+
+	int getMeshCount();
+	///Objects of the last render, before culling
+	int getObjectCount();
+	///Multi draws of the last render, one per material
+	int getDrawCalls();
+
+private:
+	///Returns the mesh of the geometry, adds it to the shared buffers with the first call
+	int getMesh(Geometry* geometry);
+	int getMaterial(const DrawItem& item);
+	void createBuffers();
+	void uploadMeshes();
+	void buildObjects(const std::vector<DrawItem>& items);
+	void cull(Camera& cullingCamera);
+	void draw(ShaderProgram& program);
+
+	std::unordered_map<Geometry*, int> m_meshIds;
+	std::vector<GPUMesh> m_meshes;
+	std::vector<glm::vec4> m_vertices;
+	std::vector<glm::vec3> m_normals;
+	std::vector<glm::vec2> m_uvs;
+	std::vector<GLuint> m_indices;
+	bool m_meshesDirty;
+
+	std::vector<GPUMaterial> m_materials;
+	std::vector<GPUObject> m_objects;
+	std::vector<DrawElementsIndirectCommand> m_commands;
+	std::vector<uint64_t> m_keys;
+	std::vector<uint64_t> m_sortTemp;
+
+	GLuint m_vao;
+	GLuint m_vertexBuffer;
+	GLuint m_normalBuffer;
+	GLuint m_uvBuffer;
+	GLuint m_indexBuffer;
+	GLuint m_objectBuffer;
+	GLuint m_commandBuffer;
+	GLuint m_visibleBuffer;	//indices of the visible objects, per command from its baseInstance on
+	GLsizeiptr m_objectBufferSize;
+	GLsizeiptr m_commandBufferSize;
+
+	ShaderProgram* m_cullProgram;
+	bool m_errorReported;
+};
@@ -130,4 +130,10 @@ void Level::setGUI(PlayerGUI* playerGUI)
 PlayerGUI* Level::getPlayerGUI()
 {
 	return m_playerGui;
-}
\ No newline at end of file
+}
+
+void Level::bakeStaticBatches(float cellSize)
+{
+	for (auto scene : m_sceneSet)
+		scene->bakeStaticBatches(cellSize);
+}
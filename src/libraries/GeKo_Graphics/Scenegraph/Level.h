@@ -67,6 +67,9 @@ public:
 
 	void setGUI(PlayerGUI* playerGUI);
 	PlayerGUI* getPlayerGUI();
+	///Merges the static nodes of all scenes into static batches, see Scene::bakeStaticBatches
+	/**Call it when the level is built*/
+	void bakeStaticBatches(float cellSize = 64.0f);
 
 
 
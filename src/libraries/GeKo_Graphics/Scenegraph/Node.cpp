@@ -1,5 +1,7 @@
 #include "Node.h"
-
+#include <GeKo_Graphics/Shader/UniformBuffer.h>
+#include <GeKo_Graphics/Scenegraph/RenderQueue.h>
+#include <GeKo_Graphics/Shader/Uniforms.h>
 
 Node::Node(std::string nodeName)
 {
@@ -19,6 +21,9 @@ Node::Node(std::string nodeName)
 	m_hasObject = false; 
 	m_hasParticleSystem = false;
 	m_particleActive = false;
+	m_transparent = false;
+	m_static = false;
+	m_baked = false;
 
 	m_type = ClassType::OBJECT;
 }
@@ -242,6 +247,16 @@ bool Node::hasNormalMap()
 	return m_hasNormalMap;
 }
 
+bool Node::hasHeightMap()
+{
+	return m_hasHeightMap;
+}
+
+bool Node::hasHeightMapShadows()
+{
+	return m_useHeightMapShadows;
+}
+
 bool Node::hasCamera()
 {
 	return m_hasCamera;
@@ -365,6 +380,46 @@ void Node::addHeightMap(Texture* heightmap, float heightScale, float heightBias,
 	m_hasHeightMap = true;
 }
 
+float Node::getHeightScale()
+{
+	return m_heightScale;
+}
+
+float Node::getHeightBias()
+{
+	return m_heightBias;
+}
+
+void Node::setTransparent(bool transparent)
+{
+	m_transparent = transparent;
+}
+
+bool Node::isTransparent()
+{
+	return m_transparent;
+}
+
+void Node::setStatic(bool isStatic)
+{
+	m_static = isStatic;
+}
+
+bool Node::isStatic()
+{
+	return (m_static || m_type == ClassType::STATIC) && !m_hasGravity && !m_hasParticleSystem;
+}
+
+void Node::setBaked(bool baked)
+{
+	m_baked = baked;
+}
+
+bool Node::isBaked()
+{
+	return m_baked;
+}
+
 Camera* Node::getCamera()
 {
 	if (m_hasCamera)
@@ -404,7 +459,7 @@ void Node::setCameraToPlayer(){
 
 BoundingSphere* Node::getBoundingSphere()
 {
-	if (m_hasGeometry)
+	if (m_hasBoundingSphere)
 	{
 		return m_sphere;
 	}
@@ -437,6 +492,7 @@ void Node::setBoundingSphere()
 
 void Node::setBoundingSphere(double radius, glm::vec3 center)
 {
+	m_hasBoundingSphere = true;
 	m_sphere = new BoundingSphere(radius, center);
 	m_boundingList.push_back(m_sphere);
 	//std::cout << "SUCCESS: A Bounding Sphere was created!" << std::endl;
@@ -569,6 +625,44 @@ void Node::setGravity(bool grav)
 	m_hasGravity = grav;
 }
 
+void Node::applyGravity()
+{
+	if (m_hasGravity){
+		if ((m_type == ClassType::PLAYER | m_type == ClassType::PLAYER) & m_type != ClassType::OBJECT)
+		{
+			m_player->setPosition(glm::vec4(glm::vec3(m_player->getPosition()) + m_Gravity->getGravity(), 1.0));
+			addTranslation(glm::vec3(m_player->getPosition()));
+			if (m_hasCamera)
+			{
+				setCameraToPlayer();
+			}
+		}
+		else if ((m_type == ClassType::AI))
+		{
+			m_ai->setPosition(glm::vec4(glm::vec3(m_ai->getPosition()) + m_Gravity->getGravity(), 1.0));
+			addTranslation(glm::vec3(m_ai->getPosition()));
+		}
+		else if (m_type == ClassType::OBJECT)
+		{
+			m_modelMatrix = m_Gravity->addGravity(m_modelMatrix);
+		}
+	}
+}
+
+void Node::updateGravity()
+{
+	if (m_hasParticleSystem)
+		return;
+
+	if (!(m_nodeName == "Root"))
+		applyGravity();
+
+	for (int i = 0; i < m_childrenSet.size(); i++)
+	{
+		m_childrenSet.at(i)->updateGravity();
+	}
+}
+
 void Node::render()
 {
   if (hasGeometry())
@@ -582,96 +676,93 @@ void Node::render()
   }
 }
 
-void Node::render(ShaderProgram &shader)
+void Node::updateObjectUniforms(ObjectUniforms &object)
 {
+	object = ObjectUniforms();
+	object.modelMatrix = glm::mat4(1.0);
+	object.previousModelMatrix = glm::mat4(1.0);
 
-	if (!m_hasParticleSystem)
+	if (!(m_nodeName == "Root"))
 	{
-		if (!(m_nodeName == "Root"))
-		{
-			glm::mat4 modelMatrix(1.0);
-
-			if (m_hasGravity){
-				if ((m_type == ClassType::PLAYER | m_type == ClassType::PLAYER) & m_type != ClassType::OBJECT)
-				{
-					m_player->setPosition(glm::vec4(glm::vec3(m_player->getPosition()) + m_Gravity->getGravity(), 1.0));
-					addTranslation(glm::vec3(m_player->getPosition()));
-					if (m_hasCamera)
-					{
-						setCameraToPlayer();
-					}
-				}
-				else if ((m_type == ClassType::AI))
-				{
-					m_ai->setPosition(glm::vec4(glm::vec3(m_ai->getPosition()) + m_Gravity->getGravity(), 1.0));
-					addTranslation(glm::vec3(m_ai->getPosition()));
-				}
-				else if (m_type == ClassType::OBJECT)
-				{
-					m_modelMatrix = m_Gravity->addGravity(m_modelMatrix);
-				}
-			}
+		glm::mat4 modelMatrix(1.0);
 
-			if ((m_type == ClassType::PLAYER) & m_type != ClassType::OBJECT)
+		if ((m_type == ClassType::PLAYER) & m_type != ClassType::OBJECT)
+		{
+			if (m_hasCamera)
 			{
-				if (m_hasCamera)
-				{
-					//addRotation(-(m_camera->getRotationAngle()), glm::vec3(0.0, 1.0, 0.0));
-					//m_player->rotateView((m_camera->getRotationAngle()), 0.0f);
-
-					/*glm::vec3 camPosition;
-					camPosition = glm::vec3(m_player->getPosition() + (m_player->getViewDirection()*glm::vec4(-5.0)));
-					camPosition.y += 3.0;
-					m_camera->setPosition(glm::vec4(camPosition, 1.0));
-					m_camera->setLookAt(glm::vec3(m_player->getPosition() + m_player->getViewDirection()));*/
-				}
+				//addRotation(-(m_camera->getRotationAngle()), glm::vec3(0.0, 1.0, 0.0));
+				//m_player->rotateView((m_camera->getRotationAngle()), 0.0f);
+
+				/*glm::vec3 camPosition;
+				camPosition = glm::vec3(m_player->getPosition() + (m_player->getViewDirection()*glm::vec4(-5.0)));
+				camPosition.y += 3.0;
+				m_camera->setPosition(glm::vec4(camPosition, 1.0));
+				m_camera->setLookAt(glm::vec3(m_player->getPosition() + m_player->getViewDirection()));*/
 			}
-			if(m_parentNode)
-				modelMatrix = getParentNode()->getModelMatrix() * m_modelMatrix;
-			else
-				modelMatrix = m_modelMatrix;
-			shader.sendMat4("modelMatrix", modelMatrix);
-			shader.sendMat4("previousModelMatrix", m_PrevModelMatrix);
-			m_PrevModelMatrix = modelMatrix;
-		}
-
-		if (m_hasTexture)
-		{
-			shader.sendSampler2D("testTexture", getTexture()->getTexture(), 0);
-			shader.sendInt("useTexture", 1);
 		}
+		if(m_parentNode)
+			modelMatrix = getParentNode()->getModelMatrix() * m_modelMatrix;
 		else
-			shader.sendInt("useTexture", 0);
+			modelMatrix = m_modelMatrix;
+		object.modelMatrix = modelMatrix;
+		object.previousModelMatrix = m_PrevModelMatrix;
+		m_PrevModelMatrix = modelMatrix;
+	}
 
-		if (m_hasNormalMap)
-		{
-			shader.sendSampler2D("normalMap", getNormalMap()->getTexture(), 1);
-			shader.sendInt("useNormalMap", 1);
-		}
-		else
-			shader.sendInt("useNormalMap", 0);
+	object.useTexture = m_hasTexture ? 1 : 0;
+	object.useNormalMap = m_hasNormalMap ? 1 : 0;
+	if (m_hasHeightMap)
+	{
+		object.useHeightMap = 1;
+		object.useHeightMapShadows = m_useHeightMapShadows ? 1 : 0;
+		object.parallaxScale = m_heightScale;
+		object.parallaxBias = m_heightBias;
+	}
+}
 
+void Node::render(ShaderProgram &shader)
+{
+
+	if (!m_hasParticleSystem)
+	{
+		//shaders with the ObjectBlock get all values of the node in one range of the ring buffer
+		bool useObjectBlock = shader.hasUniformBlock(UNIFORM_BLOCK_OBJECT);
+		if (!(m_nodeName == "Root"))
+			applyGravity();
+		ObjectUniforms object;
+		updateObjectUniforms(object);
+
+		if (m_hasTexture)
+			shader.sendSampler2D(Uniforms::testTexture, getTexture()->getTexture(), 0);
+		if (m_hasNormalMap)
+			shader.sendSampler2D(Uniforms::normalMap, getNormalMap()->getTexture(), 1);
 		if (m_hasHeightMap)
+			shader.sendSampler2D(Uniforms::heightMap, getHeightMap()->getTexture(), 2);
+
+		if (useObjectBlock)
 		{
-			shader.sendSampler2D("heightMap", getHeightMap()->getTexture(), 2);
-			shader.sendInt("useHeightMap", 1);
-			shader.sendFloat("parallaxScale", m_heightScale);
-			shader.sendFloat("parallaxBias", m_heightBias);
-
-			if (m_useHeightMapShadows)
-				shader.sendInt("useHeightMapShadows", 1);
-			else
-				shader.sendInt("useHeightMapShadows", 0);
+			if (m_hasGeometry)
+				UniformBlocks::getInstance()->pushObject(object);
 		}
-
 		else
 		{
-			shader.sendInt("useHeightMap", 0);
-			shader.sendInt("useHeightMapShadows", 0);
+			if (!(m_nodeName == "Root"))
+			{
+				shader.sendMat4(Uniforms::modelMatrix, object.modelMatrix);
+				shader.sendMat4(Uniforms::previousModelMatrix, object.previousModelMatrix);
+			}
+			shader.sendInt(Uniforms::useTexture, object.useTexture);
+			shader.sendInt(Uniforms::useNormalMap, object.useNormalMap);
+			shader.sendInt(Uniforms::useHeightMap, object.useHeightMap);
+			shader.sendInt(Uniforms::useHeightMapShadows, object.useHeightMapShadows);
+			if (m_hasHeightMap)
+			{
+				shader.sendFloat(Uniforms::parallaxScale, m_heightScale);
+				shader.sendFloat(Uniforms::parallaxBias, m_heightBias);
+			}
 		}
 
-
-		if (m_hasGeometry)
+		if (m_hasGeometry && !m_baked)
 		{
 			m_geometry->renderGeometry();
 		}
@@ -690,6 +781,37 @@ void Node::render(ShaderProgram &shader)
 	}
 }
 
+void Node::enqueue(RenderQueue &queue, ShaderProgram &shader)
+{
+	if (!m_hasParticleSystem)
+	{
+		ObjectUniforms object;
+		updateObjectUniforms(object);
+
+		if (m_hasGeometry && !m_baked)
+		{
+			GLuint textures[3];
+			textures[0] = m_hasTexture ? getTexture()->getTexture() : 0;
+			textures[1] = m_hasNormalMap ? getNormalMap()->getTexture() : 0;
+			textures[2] = m_hasHeightMap ? getHeightMap()->getTexture() : 0;
+			TextureSampler samplers[3];
+			samplers[0] = m_hasTexture ? getTexture()->getSampler() : SAMPLER_LINEAR_REPEAT;
+			samplers[1] = m_hasNormalMap ? getNormalMap()->getSampler() : SAMPLER_LINEAR_REPEAT;
+			samplers[2] = m_hasHeightMap ? getHeightMap()->getSampler() : SAMPLER_LINEAR_REPEAT;
+			queue.add(shader, m_geometry, textures, samplers, object, m_transparent);
+		}
+
+		for (int i = 0; i < m_childrenSet.size(); i++)
+		{
+			m_childrenSet.at(i)->enqueue(queue, shader);
+		}
+	}
+	else if (m_particleActive)
+	{
+		queue.addParticles(this);
+	}
+}
+
 void Node::renderParticles()
 
 {
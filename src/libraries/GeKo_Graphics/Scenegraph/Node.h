@@ -18,6 +18,9 @@
 
 #include <GeKo_Sound/SoundFileHandler.h>
 
+class RenderQueue;
+struct ObjectUniforms;
+
 ///A Node contains information, which can be rendered in the world
 /**A "Node" should be a container for Geometry, Material, Lights, Cameras, KI and Player etc. and provides all the information a shader could need
   like a Modelmatrix for example. It has one parent and can have a lot of children or none. Every Node exists as long as the scenegraph */
@@ -126,6 +129,10 @@ public:
 	bool hasTexture();
 	///Returns true, if a normal-map unit has been attached
 	bool hasNormalMap();
+	///Returns true, if a height-map unit has been attached
+	bool hasHeightMap();
+	///Returns true, if the height-map is used for shadows
+	bool hasHeightMapShadows();
 	///Returns true, if a camera has been attached
 	bool hasCamera();
 	///Returns true, if a geometry has been attached
@@ -168,6 +175,20 @@ public:
 	/**/
 	Texture* getHeightMap();
 	void addHeightMap(Texture* heightmap, float heightScale = 0.07f, float heightBias = 0.1f, bool useHeightmapShadows = false);
+	float getHeightScale();
+	float getHeightBias();
+
+	///Transparent nodes are drawn after the opaque ones, back to front (RenderQueue only)
+	void setTransparent(bool transparent);
+	bool isTransparent();
+
+	///Static nodes never move after the setup, Scene::bakeStaticBatches merges their geometry
+	/**Nodes with a StaticObject are static, other nodes can be marked. Nodes with gravity or a particle system are never static*/
+	void setStatic(bool isStatic);
+	bool isStatic();
+	///The geometry of a baked node is drawn by a StaticBatch, the node is kept for collision & gameplay
+	void setBaked(bool baked);
+	bool isBaked();
 
 	///Returns m_Camera as a Camera Object
 	/**If the node does not have a camera an error will be thrown!*/
@@ -191,7 +212,7 @@ public:
 	void setBoundingSphere();
 	///A new Bounding-Sphere object will be created
 	/**The user can choose which parameters the bounding sphere should have (radius and center)! 
-	No Geometry is needed!*/
+	No Geometry and no GL context is needed!*/
 	void setBoundingSphere(double radius, glm::vec3 center);
 
 	///Returns the m_ai object 
@@ -240,6 +261,14 @@ public:
 	/**Even with a gravity module it is possible to switch the gravity on and off as pleased!*/
 	void setGravity(bool grav);
 
+	///Moves the node one step along its gravity
+	/**Is called by render(ShaderProgram&) & updateGravity every frame. Does not need a geometry or a GL context, so physics can be 
+	simulated without rendering!*/
+	void applyGravity();
+	///Calls applyGravity for this node and all of its children, a player node moves its camera along
+	/**enqueue does not move the nodes, so the traversal does not write the camera. Call it on the GL thread before the queue is filled*/
+	void updateGravity();
+
 	
 //==================Render functions===========================//
 	///A method to tell the Node to draw itself
@@ -250,6 +279,10 @@ public:
 	/**The Node will take this call and forward it to the geometry, so the geometry will be drawn*/
 	void render(ShaderProgram &shader);
 
+	///Adds a DrawItem per geometry of this node and its children to the queue instead of drawing them
+	/**Updates the model matrices as render(ShaderProgram&) does, but no gravity (see updateGravity). The queue draws the items sorted by state*/
+	void enqueue(RenderQueue &queue, ShaderProgram &shader);
+
 	///A method to tell the Node to render its Particle-System
 	/**This Method will be used by the Node if a Particle system was attached to it, only!*/
 	void renderParticles();
@@ -270,6 +303,9 @@ protected:
 	bool m_hasNormalMap;
 	bool m_hasHeightMap;
 	bool m_useHeightMapShadows;
+	bool m_transparent;
+	bool m_static;
+	bool m_baked;
 	bool m_hasCamera;
 	bool m_hasGeometry;
 	bool m_hasBoundingSphere;
@@ -306,4 +342,6 @@ private:
 	This update will be done by this method, all the single matrices (scale, rotation, translation) will be computed.
 	The order of the update will be: translation * rotation * scale!*/
 	void updateModelMatrix();
+	///Updates the model matrices & fills the values of the ObjectBlock, for render and enqueue
+	void updateObjectUniforms(ObjectUniforms &object);
 };
@@ -0,0 +1,284 @@
+#include "RenderQueue.h"
+#include <GeKo_Graphics/Scenegraph/Node.h>
+#include <GeKo_Graphics/Shader/Uniforms.h>
+#include <GeKo_Graphics/RadixSort.h>
+
+static const int INDEX_BITS = 20;
+static const uint64_t INDEX_MASK = (1ull << INDEX_BITS) - 1;
+static const int PROGRAM_BITS = 6;
+static const int TEXTURE_SET_BITS = 13;
+static const int GEOMETRY_BITS = 12;
+static const int OPAQUE_DEPTH_BITS = 12;
+static const int TRANSPARENT_DEPTH_BITS = 24;
+
+//opaque items of a program with instancing are drawn with one instanced draw per group of at least this many
+static const int MIN_INSTANCES = 2;
+
+//ids above the bits of their field share the last id, the items are still drawn right, only less grouped
+static uint64_t clampId(int id, int bits)
+{
+	uint64_t max = (1ull << bits) - 1;
+	return ((uint64_t)id < max) ? (uint64_t)id : max;
+}
+
+RenderQueue::RenderQueue()
+{
+	m_cameraPosition = glm::vec3(0.0f);
+	m_stateChanges = 0;
+	m_drawCalls = 0;
+	m_overflowReported = false;
+}
+
+RenderQueue::~RenderQueue()
+{
+}
+
+void RenderQueue::begin(glm::vec3 cameraPosition)
+{
+	m_cameraPosition = cameraPosition;
+	m_items.clear();
+	m_keys.clear();
+	m_particleNodes.clear();
+	m_programIds.clear();
+	m_textureSetIds.clear();
+	m_geometryIds.clear();
+	m_overflowReported = false;
+}
+
+void RenderQueue::add(ShaderProgram& program, Geometry* geometry, const GLuint textures[3], const TextureSampler samplers[3], const ObjectUniforms& object, bool transparent)
+{
+	if (m_items.size() > INDEX_MASK)
+	{
+		if (!m_overflowReported)
+			std::cout << "WARNING: RenderQueue is full, items are dropped" << std::endl;
+		m_overflowReported = true;
+		return;
+	}
+
+	uint64_t index = m_items.size();
+	DrawItem item;
+	item.program = &program;
+	item.geometry = geometry;
+	for (int unit = 0; unit < 3; unit++)
+	{
+		item.textures[unit] = textures[unit];
+		item.samplers[unit] = samplers[unit];
+	}
+	item.object = object;
+	item.transparent = transparent;
+	m_items.push_back(item);
+
+	glm::vec3 distance = glm::vec3(object.modelMatrix[3]) - m_cameraPosition;
+	uint32_t depth = RadixSort::floatKey(glm::dot(distance, distance));
+
+	uint64_t programId = clampId(getProgramId(&program), PROGRAM_BITS);
+	uint64_t textureSetId = clampId(getTextureSetId(textures), TEXTURE_SET_BITS);
+
+	uint64_t key;
+	if (!transparent)
+	{
+		uint64_t geometryId = clampId(getGeometryId(geometry), GEOMETRY_BITS);
+		key = (programId << 57) | (textureSetId << 44) | (geometryId << 32)
+			| ((uint64_t)(depth >> (32 - OPAQUE_DEPTH_BITS)) << INDEX_BITS);
+	}
+	else
+	{
+		uint64_t farFirst = (~depth) >> (32 - TRANSPARENT_DEPTH_BITS);
+		key = (1ull << 63) | (farFirst << 39) | (programId << 33) | (textureSetId << INDEX_BITS);
+	}
+	m_keys.push_back(key | index);
+}
+
+void RenderQueue::addParticles(Node* node)
+{
+	m_particleNodes.push_back(node);
+}
+
+void RenderQueue::sort()
+{
+	RadixSort::sort(m_keys, m_sortTemp);
+}
+
+bool RenderQueue::canInstance(const DrawItem& first, const DrawItem& item)
+{
+	const ObjectUniforms& a = first.object;
+	const ObjectUniforms& b = item.object;
+	return first.program == item.program && first.geometry == item.geometry
+		&& first.textures[0] == item.textures[0] && first.textures[1] == item.textures[1] && first.textures[2] == item.textures[2]
+		&& first.samplers[0] == item.samplers[0] && first.samplers[1] == item.samplers[1] && first.samplers[2] == item.samplers[2]
+		&& a.useTexture == b.useTexture && a.useNormalMap == b.useNormalMap && a.useHeightMap == b.useHeightMap
+		&& a.useHeightMapShadows == b.useHeightMapShadows && a.parallaxScale == b.parallaxScale && a.parallaxBias == b.parallaxBias;
+}
+
+void RenderQueue::buildGroups(size_t begin)
+{
+	m_groups.clear();
+	m_instanceMatrices.clear();
+
+	size_t count = m_keys.size();
+	for (size_t first = begin; first < count;)
+	{
+		const DrawItem& item = m_items[m_keys[first] & INDEX_MASK];
+		size_t last = first + 1;
+		bool opaque = (m_keys[first] >> 63) == 0;
+		if (opaque && item.program->hasInstancing())
+		{
+			while (last < count && (m_keys[last] >> 63) == 0 && canInstance(item, m_items[m_keys[last] & INDEX_MASK]))
+				last++;
+		}
+
+		DrawGroup group;
+		group.first = (int)first;
+		group.count = (int)(last - first);
+		group.instanceOffset = -1;
+		if (group.count >= MIN_INSTANCES)
+		{
+			group.instanceOffset = (int)m_instanceMatrices.size();
+			for (size_t i = first; i < last; i++)
+				m_instanceMatrices.push_back(m_items[m_keys[i] & INDEX_MASK].object.modelMatrix);
+		}
+		else
+			group.count = 1;
+		m_groups.push_back(group);
+		first += group.count;
+	}
+}
+
+void RenderQueue::record(RenderCommandBuffer& commands, bool opaque)
+{
+	m_stateChanges = 0;
+	m_drawCalls = 0;
+
+	//the transparent keys are sorted after the opaque ones
+	size_t first = 0;
+	if (!opaque)
+	{
+		while (first < m_keys.size() && (m_keys[first] >> 63) == 0)
+			first++;
+	}
+	buildGroups(first);
+
+	ShaderProgram* program = nullptr;
+	GLuint boundTextures[3] = { 0, 0, 0 };
+	//filtering & wrapping of the textures, instead of a glTexParameter per bind. SAMPLER_COUNT: nothing bound yet
+	TextureSampler boundSamplers[3] = { SAMPLER_COUNT, SAMPLER_COUNT, SAMPLER_COUNT };
+	GLuint boundVAO = 0;
+
+	for (auto& group : m_groups)
+	{
+		const DrawItem& item = m_items[m_keys[group.first] & INDEX_MASK];
+
+		if (item.program != program)
+		{
+			program = item.program;
+			commands.bindProgram(program);
+			//the units of the samplers are the same for all items
+			commands.sendInt(Uniforms::testTexture, 0);
+			commands.sendInt(Uniforms::normalMap, 1);
+			commands.sendInt(Uniforms::heightMap, 2);
+			for (int unit = 0; unit < 3; unit++)
+				boundTextures[unit] = 0;
+			m_stateChanges++;
+		}
+
+		for (int unit = 0; unit < 3; unit++)
+		{
+			if (item.textures[unit] != 0 && item.textures[unit] != boundTextures[unit])
+			{
+				commands.bindTexture(unit, item.textures[unit]);
+				boundTextures[unit] = item.textures[unit];
+				m_stateChanges++;
+			}
+			if (item.textures[unit] != 0 && item.samplers[unit] != boundSamplers[unit])
+			{
+				commands.bindSampler(unit, item.samplers[unit]);
+				boundSamplers[unit] = item.samplers[unit];
+				m_stateChanges++;
+			}
+		}
+
+		ObjectUniforms object = item.object;
+		object.useInstancing = (group.instanceOffset >= 0) ? 1 : 0;
+		commands.setObject(object);
+
+		if (item.geometry->getVAO() != boundVAO)
+		{
+			boundVAO = item.geometry->getVAO();
+			commands.bindVertexArray(boundVAO);
+			m_stateChanges++;
+		}
+
+		if (group.instanceOffset >= 0)
+			commands.drawInstanced(item.geometry, &m_instanceMatrices[group.instanceOffset], group.count);
+		else
+			commands.draw(item.geometry);
+		m_drawCalls++;
+	}
+	commands.bindVertexArray(0);
+	for (int unit = 0; unit < 3; unit++)
+	{
+		if (boundSamplers[unit] != SAMPLER_COUNT)
+			commands.unbindSampler(unit);
+	}
+
+	for (auto node : m_particleNodes)
+		commands.addCallback([node]() { node->renderParticles(); });
+}
+
+void RenderQueue::submit(bool opaque)
+{
+	m_commands.clear();
+	record(m_commands, opaque);
+	m_commands.execute();
+}
+
+const std::vector<DrawItem>& RenderQueue::getItems()
+{
+	return m_items;
+}
+
+int RenderQueue::getItemCount()
+{
+	return (int)m_items.size();
+}
+
+int RenderQueue::getStateChanges()
+{
+	return m_stateChanges;
+}
+
+int RenderQueue::getDrawCalls()
+{
+	return m_drawCalls;
+}
+
+int RenderQueue::getProgramId(ShaderProgram* program)
+{
+	auto entry = m_programIds.find(program);
+	if (entry != m_programIds.end())
+		return entry->second;
+	int id = (int)m_programIds.size();
+	m_programIds[program] = id;
+	return id;
+}
+
+int RenderQueue::getTextureSetId(const GLuint textures[3])
+{
+	uint64_t set = ((uint64_t)textures[0] << 42) ^ ((uint64_t)textures[1] << 21) ^ (uint64_t)textures[2];
+	auto entry = m_textureSetIds.find(set);
+	if (entry != m_textureSetIds.end())
+		return entry->second;
+	int id = (int)m_textureSetIds.size();
+	m_textureSetIds[set] = id;
+	return id;
+}
+
+int RenderQueue::getGeometryId(Geometry* geometry)
+{
+	auto entry = m_geometryIds.find(geometry);
+	if (entry != m_geometryIds.end())
+		return entry->second;
+	int id = (int)m_geometryIds.size();
+	m_geometryIds[geometry] = id;
+	return id;
+}
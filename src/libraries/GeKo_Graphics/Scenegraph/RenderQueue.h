@@ -0,0 +1,104 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <GeKo_Graphics/Renderer/RenderCommandBuffer.h>
+
+class Geometry;
+class Node;
+
+///A draw of the RenderQueue: the state it needs & the values of its ObjectBlock
+struct DrawItem
+{
+	ShaderProgram* program;
+	Geometry* geometry;
+	GLuint textures[3];	//texture, normal map, height map (units 0 .. 2), 0 if unused
+	TextureSampler samplers[3];	//of the textures (Texture::getSampler)
+	ObjectUniforms object;
+	bool transparent;
+};
+
+///Consecutive sorted items drawn with one call, instanceOffset is -1 if it is a single item
+struct DrawGroup
+{
+	int first;
+	int count;
+	int instanceOffset;
+};
+
+///Collects the draws of a frame and submits them sorted by state
+/*
+Description: Node::enqueue walks the scenegraph and adds a DrawItem per geometry instead of drawing it.
+The items get a 64 bit key and are radix sorted, then recorded into a RenderCommandBuffer with only the binds that change
+(program, textures & their samplers, vertex array). Filling, sorting & recording make no OpenGL call, only the replay of the buffer does.
+
+Key of an opaque item (front to back inside the same state):
+-63: 0
+-62..57 program, 56..44 texture set, 43..32 geometry, 31..20 depth
+Key of a transparent item (back to front, after all opaque items):
+-63: 1
+-62..39 inverted depth, 38..33 program, 32..20 texture set
+The low 20 bits are the index of the item. Program, texture set & geometry are small ids given in the order they are first added.
+
+Opaque items next to each other with the same program, geometry, textures & flags are drawn instanced if the program
+has instancing (ShaderProgram::hasInstancing): their model matrices go into one instance buffer per frame and
+a group is one glDrawElementsInstanced. So nodes sharing a mesh (colonies, forests) cost a draw per group.
+
+Nodes with a particle system are rendered after the items (as callbacks), as Node::render did it.
+*/
+class RenderQueue
+{
+public:
+	RenderQueue();
+	~RenderQueue();
+
+	///Clears the queue, the depth of the items is the distance to cameraPosition
+	void begin(glm::vec3 cameraPosition);
+	///samplers are bound with the textures, the entries of unused units are ignored
+	void add(ShaderProgram& program, Geometry* geometry, const GLuint textures[3], const TextureSampler samplers[3], const ObjectUniforms& object, bool transparent);
+	void addParticles(Node* node);
+
+	///Sorts the keys, see Description
+	void sort();
+	///Records the sorted items and the particle systems, no OpenGL call is made (see RenderCommandBuffer)
+	/**Without opaque only the transparent items are recorded, the opaque ones were drawn by a GPUScene*/
+	void record(RenderCommandBuffer& commands, bool opaque = true);
+	///Records into a buffer of the queue & replays it right away
+	void submit(bool opaque = true);
+
+	///The items in the order they were added
+	const std::vector<DrawItem>& getItems();
+
+	int getItemCount();
+	///Binds of programs, textures & vertex arrays of the last record or submit
+	int getStateChanges();
+	///Draw calls of the last record or submit, an instanced group is one
+	int getDrawCalls();
+
+private:
+	int getProgramId(ShaderProgram* program);
+	int getTextureSetId(const GLuint textures[3]);
+	int getGeometryId(Geometry* geometry);
+	bool canInstance(const DrawItem& first, const DrawItem& item);
+	///Groups the sorted items from begin on & collects the instance matrices
+	void buildGroups(size_t begin);
+
+	glm::vec3 m_cameraPosition;
+	std::vector<DrawItem> m_items;
+	std::vector<uint64_t> m_keys;
+	std::vector<uint64_t> m_sortTemp;
+	std::vector<Node*> m_particleNodes;
+
+	std::unordered_map<ShaderProgram*, int> m_programIds;
+	std::unordered_map<uint64_t, int> m_textureSetIds;
+	std::unordered_map<Geometry*, int> m_geometryIds;
+
+	std::vector<DrawGroup> m_groups;
+	std::vector<glm::mat4> m_instanceMatrices;
+	RenderCommandBuffer m_commands;	//of submit
+
+	int m_stateChanges;
+	int m_drawCalls;
+	bool m_overflowReported;	//of the current frame
+};
@@ -1,4 +1,7 @@
 #include "Scene.h"
+#include <GeKo_Graphics/Camera/Frustum.h>
+#include <map>
+#include <tuple>
 
 
 Scene::Scene(std::string sceneName)
@@ -15,7 +18,7 @@ bool Scene::hasSkybox()
 
 Scene::~Scene()
 {
-
+	clearStaticBatches();
 }
 
 
@@ -50,20 +53,213 @@ void Scene::setSkyboxNode(Node* skyboxNode)
 	m_skyboxNode = skyboxNode;
 }
 
-void Scene::render(ShaderProgram &shader)
+void Scene::applyGravity()
+{
+	m_sceneGraph->getRootNode()->updateGravity();
+}
+
+void Scene::render(ShaderProgram &shader, Camera* cullingCamera)
+{
+	applyGravity();
+	fillRenderQueue(shader, cullingCamera);
+	m_renderQueue.submit();
+}
+
+void Scene::record(RenderCommandBuffer &commands, ShaderProgram &shader, Camera* cullingCamera)
+{
+	fillRenderQueue(shader, cullingCamera);
+	m_renderQueue.record(commands);
+}
+
+void Scene::fillRenderQueue(ShaderProgram &shader, Camera* cullingCamera)
+{
+	glm::vec3 cameraPosition(0.0f);
+	if (m_sceneGraph->getActiveCamera())
+		cameraPosition = glm::vec3(m_sceneGraph->getActiveCamera()->getPosition());
+
+	m_renderQueue.begin(cameraPosition);
+	m_sceneGraph->getRootNode()->enqueue(m_renderQueue, shader);
+
+	Frustum frustum;
+	if (cullingCamera)
+		frustum = Frustum(*cullingCamera);
+	for (auto batch : m_staticBatches)
+	{
+		const GeometryBounds& bounds = batch->getBounds();
+		if (cullingCamera && !frustum.containsSphere(bounds.sphereCenter, bounds.sphereRadius))
+			continue;
+		m_renderQueue.add(shader, batch, batch->getTextures(), batch->getSamplers(), batch->getMaterial(), false);
+	}
+
+	m_renderQueue.sort();
+}
+
+void Scene::renderGPUDriven(ShaderProgram &shader, ShaderProgram &gpuDrivenShader, Camera &cullingCamera)
 {
-	m_sceneGraph->getRootNode()->render(shader);
+	glm::vec3 cameraPosition(0.0f);
+	if (m_sceneGraph->getActiveCamera())
+		cameraPosition = glm::vec3(m_sceneGraph->getActiveCamera()->getPosition());
+
+	//the traversal still updates the nodes (gravity, matrices), culling & draws are done by the GPU
+	applyGravity();
+	m_renderQueue.begin(cameraPosition);
+	m_sceneGraph->getRootNode()->enqueue(m_renderQueue, shader);
+	for (auto batch : m_staticBatches)
+		m_renderQueue.add(shader, batch, batch->getTextures(), batch->getSamplers(), batch->getMaterial(), false);
+
+	m_gpuScene.render(gpuDrivenShader, m_renderQueue, cullingCamera);
+
+	m_renderQueue.sort();
+	m_renderQueue.submit(false);
 }
 
 void Scene::renderParticleSystems()
 {
-	std::vector<int> vec;
-	m_sceneGraph->sortParticleSet(vec);
-	std::vector<ParticleSystem*> psVec = *m_sceneGraph->getParticleSet();
+	updateAndRenderParticleSystems();
+}
+
+void Scene::recordParticleSystems(RenderCommandBuffer &commands)
+{
+	commands.addCallback([this]() { updateAndRenderParticleSystems(); });
+}
 
-	auto cam = *m_sceneGraph->getActiveCamera();
-	for (auto entry : vec) {
-		psVec.at(entry)->update(cam);
-		psVec.at(entry)->render(cam);
+void Scene::updateAndRenderParticleSystems()
+{
+	Camera& cam = *m_sceneGraph->getActiveCamera();
+	ParticleSystemPool* pool = m_sceneGraph->getParticlePool();
+	ParticleBatch* batch = pool->getBatch();
+
+	//the systems of the scene are simulated & drawn by the batch of the pool: one dispatch per physic, the draws sorted back to front
+	for (auto ps : *m_sceneGraph->getParticleSet())
+	{
+		ps->updateLOD(cam);
+		if (!batch->containsEffect(ps->getEffect()))
+			batch->addEffect(ps->getEffect());
 	}
-}
\ No newline at end of file
+
+	pool->update(cam);
+	pool->render(cam);
+}
+namespace
+{
+	//the nodes of a batch share the material & the grid cell of their center
+	struct StaticBatchKey
+	{
+		GLuint textures[3];
+		int samplers[3];
+		int flags[4];
+		float parallax[2];
+		int cell[3];
+
+		bool operator<(const StaticBatchKey& other) const
+		{
+			return std::tie(textures[0], textures[1], textures[2], samplers[0], samplers[1], samplers[2], flags[0], flags[1], flags[2], flags[3], parallax[0], parallax[1], cell[0], cell[1], cell[2])
+				< std::tie(other.textures[0], other.textures[1], other.textures[2], other.samplers[0], other.samplers[1], other.samplers[2], other.flags[0], other.flags[1], other.flags[2], other.flags[3],
+				other.parallax[0], other.parallax[1], other.cell[0], other.cell[1], other.cell[2]);
+		}
+	};
+}
+
+void Scene::collectStaticNodes(Node* node, std::vector<Node*>& nodes)
+{
+	//children of a particle system node are not rendered
+	if (node->hasParticleSystem())
+		return;
+	if (node->hasGeometry() && node->isStatic() && !node->isTransparent())
+		nodes.push_back(node);
+
+	std::vector<Node*>& children = *node->getChildrenSet();
+	for (auto child : children)
+		collectStaticNodes(child, nodes);
+}
+
+void Scene::bakeStaticBatches(float cellSize)
+{
+	clearStaticBatches();
+
+	std::vector<Node*> nodes;
+	collectStaticNodes(m_sceneGraph->getRootNode(), nodes);
+
+	std::map<StaticBatchKey, StaticBatch*> batches;
+	for (auto node : nodes)
+	{
+		//the same world matrix as Node::render
+		glm::mat4 worldMatrix = node->getModelMatrix();
+		if (node->getParentNode())
+			worldMatrix = node->getParentNode()->getModelMatrix() * worldMatrix;
+
+		GLuint textures[3];
+		textures[0] = node->hasTexture() ? node->getTexture()->getTexture() : 0;
+		textures[1] = node->hasNormalMap() ? node->getNormalMap()->getTexture() : 0;
+		textures[2] = node->hasHeightMap() ? node->getHeightMap()->getTexture() : 0;
+		TextureSampler samplers[3];
+		samplers[0] = node->hasTexture() ? node->getTexture()->getSampler() : SAMPLER_LINEAR_REPEAT;
+		samplers[1] = node->hasNormalMap() ? node->getNormalMap()->getSampler() : SAMPLER_LINEAR_REPEAT;
+		samplers[2] = node->hasHeightMap() ? node->getHeightMap()->getSampler() : SAMPLER_LINEAR_REPEAT;
+
+		ObjectUniforms material = ObjectUniforms();
+		material.useTexture = textures[0] ? 1 : 0;
+		material.useNormalMap = textures[1] ? 1 : 0;
+		material.useHeightMap = textures[2] ? 1 : 0;
+		if (node->hasHeightMap())
+		{
+			material.useHeightMapShadows = node->hasHeightMapShadows() ? 1 : 0;
+			material.parallaxScale = node->getHeightScale();
+			material.parallaxBias = node->getHeightBias();
+		}
+
+		glm::vec3 center = glm::vec3(worldMatrix * glm::vec4(node->getGeometry()->getBounds().sphereCenter, 1.0f));
+
+		StaticBatchKey key;
+		for (int i = 0; i < 3; i++)
+		{
+			key.textures[i] = textures[i];
+			key.samplers[i] = samplers[i];
+			key.cell[i] = (int)glm::floor(center[i] / cellSize);
+		}
+		key.flags[0] = material.useTexture;
+		key.flags[1] = material.useNormalMap;
+		key.flags[2] = material.useHeightMap;
+		key.flags[3] = material.useHeightMapShadows;
+		key.parallax[0] = material.parallaxScale;
+		key.parallax[1] = material.parallaxBias;
+
+		StaticBatch*& batch = batches[key];
+		if (!batch)
+			batch = new StaticBatch(textures, samplers, material);
+		if (batch->addNode(node, worldMatrix))
+			node->setBaked(true);
+	}
+
+	for (auto& entry : batches)
+	{
+		StaticBatch* batch = entry.second;
+		if (batch->getNodes().empty())
+		{
+			delete batch;
+			continue;
+		}
+		batch->build();
+		m_staticBatches.push_back(batch);
+	}
+	std::cout << "SUCCESS: " << nodes.size() << " static nodes baked into " << m_staticBatches.size() << " batches" << std::endl;
+}
+
+void Scene::clearStaticBatches()
+{
+	for (auto batch : m_staticBatches)
+	{
+		for (auto node : batch->getNodes())
+			node->setBaked(false);
+		delete batch;
+	}
+	//the GPUScene has copies of the deleted batches
+	if (!m_staticBatches.empty())
+		m_gpuScene.clearMeshes();
+	m_staticBatches.clear();
+}
+
+std::vector<StaticBatch*>& Scene::getStaticBatches()
+{
+	return m_staticBatches;
+}
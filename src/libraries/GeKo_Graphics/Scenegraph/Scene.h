@@ -3,6 +3,9 @@
 #include <glm/ext.hpp>
 #include <GeKo_Graphics/Scenegraph/Scenegraph.h>
 #include <GeKo_Graphics/Shader/Shader.h>
+#include <GeKo_Graphics/Scenegraph/RenderQueue.h>
+#include <GeKo_Graphics/Scenegraph/StaticBatch.h>
+#include <GeKo_Graphics/Scenegraph/GPUScene.h>
 
 /// A Scene is needed for a Scenegraph
 /*The Scene class contains a scenegraph and represents a piece of a level or a whole level. 
@@ -32,12 +35,42 @@ public:
 	bool hasSkybox();
 
 	///The render call which will be forwarded to the scenegraph object of the scene
-	/**Each Render call needs a shader-Unit, with which the rendering progress will be startet*/
-	void render(ShaderProgram &shader);
+	/**Each Render call needs a shader-Unit, with which the rendering progress will be startet.
+	The nodes are collected in a RenderQueue and drawn sorted by state, opaque front to back & transparent back to front.
+	The static batches are drawn too, with a cullingCamera only those in its view frustum*/
+	void render(ShaderProgram &shader, Camera* cullingCamera = NULL);
+	///Like render, but the draws are recorded into commands & drawn when the GL thread replays them
+	/**No OpenGL call is made, so it can run on a worker thread. Nothing else may change or traverse the scenegraph meanwhile.
+	The nodes are not moved by their gravity, call applyGravity before on the GL thread, so the worker does not write the camera*/
+	void record(RenderCommandBuffer &commands, ShaderProgram &shader, Camera* cullingCamera = NULL);
+	///Moves all nodes along their gravity (Node::updateGravity), render & renderGPUDriven call it themselves
+	void applyGravity();
+	///The GPU driven render call, the opaque nodes & batches are culled on the GPU and drawn with gpuDrivenShader (see GPUScene)
+	/**The transparent nodes & particles are drawn with shader as in render*/
+	void renderGPUDriven(ShaderProgram &shader, ShaderProgram &gpuDrivenShader, Camera &cullingCamera);
+	///Updates & renders the particle systems of the scenegraph together with its ParticleSystemPool, in one ParticleBatch
 	void renderParticleSystems();
+	///Records the update & render of renderParticleSystems, replay before the next record
+	void recordParticleSystems(RenderCommandBuffer &commands);
+
+	///Merges the geometry of the static nodes (Node::isStatic) into StaticBatches, by material & a grid of cellSize
+	/**Call it once the level is set up, the baked nodes are kept for collision & gameplay. Baking again replaces the old batches*/
+	void bakeStaticBatches(float cellSize = 64.0f);
+	///Deletes the batches, the nodes draw their own geometry again
+	void clearStaticBatches();
+	std::vector<StaticBatch*>& getStaticBatches();
 
 protected:
 	std::string m_sceneName;
 	Node* m_skyboxNode;
 	Scenegraph* m_sceneGraph;
+	RenderQueue m_renderQueue;	//reused by render
+	GPUScene m_gpuScene;	//meshes & buffers of renderGPUDriven
+	std::vector<StaticBatch*> m_staticBatches;
+
+private:
+	void collectStaticNodes(Node* node, std::vector<Node*>& nodes);
+	///Traverses the scenegraph & the static batches into the sorted m_renderQueue
+	void fillRenderQueue(ShaderProgram &shader, Camera* cullingCamera);
+	void updateAndRenderParticleSystems();
 };
\ No newline at end of file
@@ -135,37 +135,28 @@ std::vector<ParticleSystem*>* Scenegraph::getParticleSet()
 	return &m_particleSet;
 }
 
-//the comparison function to compare the distance, saved in a vector.
-bool comparisonFunction(std::vector<double> vec1, std::vector<double> vec2) { return (vec1.at(1) > vec2.at(1)); }
+ParticleSystemPool* Scenegraph::getParticlePool()
+{
+	return &m_particlePool;
+}
 
 void Scenegraph::sortParticleSet(std::vector<int> &rvec)
 {
 	rvec.clear();
-	//new vec that will be sorted
-	std::vector<std::vector<double>> arr;
+	m_particleSortKeys.clear();
 
 	glm::vec3 camPos = glm::vec3(m_activeCamera->getPosition().x, m_activeCamera->getPosition().y, m_activeCamera->getPosition().z);
 
-	//fill arr
-	int i = 0;
-	for (auto ps : m_particleSet) {
-		//compute distance from camera to ParticleSystem
-		glm::vec3 psPos = ps->getPosition();
-		double distance = sqrt(pow((camPos.x - psPos.x), 2) + pow((camPos.y - psPos.y), 2) + pow((camPos.z - psPos.z), 2));
-
-		std::vector<double> temp;
-		temp.push_back((double)i); //push back entry index
-		temp.push_back(distance);
-
-		arr.push_back(temp);
-		i++;
+	//the squared distance keeps the order. Inverted, so the farthest ParticleSystem comes first
+	for (int i = 0; i < (int)m_particleSet.size(); i++) {
+		glm::vec3 distance = m_particleSet[i]->getPosition() - camPos;
+		uint32_t distanceKey = ~RadixSort::floatKey(glm::dot(distance, distance));
+		m_particleSortKeys.push_back(((uint64_t)distanceKey << 32) | (uint32_t)i);
 	}
 
-	//sort arr by distance(arr.at(1))
-	std::sort(arr.begin(), arr.end(), comparisonFunction);
+	RadixSort::sort(m_particleSortKeys, m_particleSortTemp);
 
-	//fill rvec
-	for (auto entry : arr) {
-		rvec.push_back((int)entry.at(0));
+	for (auto key : m_particleSortKeys) {
+		rvec.push_back((int)(key & 0xffffffff));
 	}
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 #include <GeKo_Graphics/Scenegraph/Node.h>
+#include <GeKo_Graphics/ParticleSystem/ParticleSystemPool.h>
+#include <GeKo_Graphics/RadixSort.h>
 #include <algorithm>
 
 ///Scenegraph contains Node
@@ -47,8 +49,14 @@ public:
 
 	void addParticleSystem(ParticleSystem* ps);
 	std::vector<ParticleSystem*>* getParticleSet();
+	///Fills rvec with the indices of the particle set, sorted back to front
+	/**Sorts packed (squared distance, index) keys (RadixSort) in buffers of the scenegraph, nothing is allocated per frame*/
 	void sortParticleSet(std::vector<int> &rvec);
 
+	///Returns the pool for gameplay effects
+	/**The playing ParticleSystems of the pool are updated & rendered with the particle set, see ParticleSystemPool*/
+	ParticleSystemPool* getParticlePool();
+
 protected:
 
 	std::string m_scenegraphName;
@@ -58,4 +66,7 @@ protected:
 	std::vector<Camera*> m_cameraSet;
 
 	std::vector<ParticleSystem*> m_particleSet;
+	std::vector<uint64_t> m_particleSortKeys;
+	std::vector<uint64_t> m_particleSortTemp;
+	ParticleSystemPool m_particlePool;
 };
\ No newline at end of file
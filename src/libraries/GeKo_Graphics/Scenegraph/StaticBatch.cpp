@@ -0,0 +1,98 @@
+#include "StaticBatch.h"
+#include <GeKo_Graphics/Scenegraph/Node.h>
+
+StaticBatch::StaticBatch(const GLuint textures[3], const TextureSampler samplers[3], const ObjectUniforms& material)
+{
+	for (int unit = 0; unit < 3; unit++)
+	{
+		m_textures[unit] = textures[unit];
+		m_samplers[unit] = samplers[unit];
+	}
+	m_material = material;
+	m_material.modelMatrix = glm::mat4(1.0);
+	m_material.previousModelMatrix = glm::mat4(1.0);
+	m_material.useInstancing = 0;
+	m_vaoBuffer = 0;
+}
+
+StaticBatch::~StaticBatch()
+{
+	if (!isLoaded())
+		return;
+	glDeleteVertexArrays(1, &m_vaoBuffer);
+	delete m_vertexBuffer;
+	delete m_normalBuffer;
+	delete m_uvBuffer;
+	delete m_indexBuffer;
+}
+
+bool StaticBatch::addNode(Node* node, const glm::mat4& worldMatrix)
+{
+	Geometry* geometry = node->getGeometry();
+	const std::vector<glm::vec4>& vertices = geometry->getVertices();
+	std::vector<GLuint> indices = geometry->getIndexList();
+
+	//only triangle lists, as Geometry::renderGeometry draws them
+	if (vertices.empty() || (geometry->hasIndex() ? indices.size() % 3 != 0 : vertices.size() % 3 != 0))
+		return false;
+
+	std::vector<glm::vec3> normals = geometry->getNormals();
+	std::vector<glm::vec2> uvs = geometry->getUV();
+	glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(worldMatrix)));
+
+	GLuint base = (GLuint)m_vertices.size();
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		m_vertices.push_back(worldMatrix * vertices[i]);
+		if (i < normals.size())
+			m_normals.push_back(glm::normalize(normalMatrix * normals[i]));
+		else
+			m_normals.push_back(glm::vec3(0.0f, 1.0f, 0.0f));
+		m_uvs.push_back(i < uvs.size() ? uvs[i] : glm::vec2(0.0f));
+	}
+
+	if (geometry->hasIndex())
+	{
+		for (auto index : indices)
+			m_index.push_back(base + index);
+	}
+	else
+	{
+		for (GLuint i = 0; i < (GLuint)vertices.size(); i++)
+			m_index.push_back(base + i);
+	}
+
+	m_nodes.push_back(node);
+	return true;
+}
+
+void StaticBatch::build()
+{
+	setIndexTrue();
+	setNormalsTrue();
+	setUVTrue();
+	m_indices = (int)m_index.size();
+	computeBounds();
+	loadBufferData();
+	setLoaded();
+}
+
+const GLuint* StaticBatch::getTextures()
+{
+	return m_textures;
+}
+
+const TextureSampler* StaticBatch::getSamplers()
+{
+	return m_samplers;
+}
+
+const ObjectUniforms& StaticBatch::getMaterial()
+{
+	return m_material;
+}
+
+std::vector<Node*>& StaticBatch::getNodes()
+{
+	return m_nodes;
+}
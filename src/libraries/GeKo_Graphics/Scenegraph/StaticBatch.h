@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include <GeKo_Graphics/Geometry/Geometry.h>
+#include <GeKo_Graphics/Shader/UniformBuffer.h>
+#include <GeKo_Graphics/Material/Texture.h>
+
+class Node;
+
+///The merged geometry of static nodes with the same material in one region of the level
+/*
+Description: Scene::bakeStaticBatches merges the geometry of the nodes that never move (Node::isStatic) into batches.
+The vertices are transformed into world space once, so a batch is one draw with an identity model matrix.
+The nodes stay in the scenegraph for collision & gameplay, only their geometry is not drawn anymore (Node::isBaked).
+
+A batch is a Geometry: it has the usual VAO layout (0 position, 1 normal, 2 uv) and its bounds (getBounds) are in world space.
+*/
+class StaticBatch : public Geometry
+{
+public:
+	StaticBatch(const GLuint textures[3], const TextureSampler samplers[3], const ObjectUniforms& material);
+	~StaticBatch();
+
+	///Appends the geometry of the node, transformed by its world matrix. Returns false if the geometry can not be merged
+	bool addNode(Node* node, const glm::mat4& worldMatrix);
+	///Creates the buffers, call it once after the last addNode
+	void build();
+
+	const GLuint* getTextures();
+	const TextureSampler* getSamplers();
+	///Flags & parallax values of the nodes, the model matrices are identity
+	const ObjectUniforms& getMaterial();
+	std::vector<Node*>& getNodes();
+
+private:
+	GLuint m_textures[3];
+	TextureSampler m_samplers[3];
+	ObjectUniforms m_material;
+	std::vector<Node*> m_nodes;
+};
@@ -11,13 +11,78 @@ void attachShaders(GLuint handle, GLuint shaderHandle)
   glAttachShader(handle, shaderHandle);
 }
 
-std::string loadShaderSource(std::string path)
+//includes deeper than this are a cycle
+static const int MAX_INCLUDE_DEPTH = 8;
+
+static std::string loadShaderSource(std::string path, int depth)
 {
 	std::ifstream input(path);
-    std::string source((std::istreambuf_iterator<char>(input)),
-    std::istreambuf_iterator<char>());
-    //std::cout << path << " "<< source << std::endl;
-  return source;
+	if (!input.is_open())
+	{
+		std::cout << "ERROR: Unable to open shader source " << path << std::endl;
+		return "";
+	}
+
+	//#include "file" is replaced by the file, relative to the directory of this file
+	std::string directory = path.substr(0, path.find_last_of("/\\") + 1);
+	std::string source;
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(input, line))
+	{
+		lineNumber++;
+		size_t begin = line.find_first_not_of(" \t");
+		if (begin != std::string::npos && line.compare(begin, 8, "#include") == 0)
+		{
+			size_t first = line.find('"', begin);
+			size_t last = line.find('"', first + 1);
+			if (first == std::string::npos || last == std::string::npos)
+			{
+				std::cout << "ERROR: Invalid include in " << path << " line " << lineNumber << std::endl;
+				continue;
+			}
+			if (depth >= MAX_INCLUDE_DEPTH)
+			{
+				std::cout << "ERROR: Too many nested includes in " << path << std::endl;
+				continue;
+			}
+			source += "#line 1\n";
+			source += loadShaderSource(directory + line.substr(first + 1, last - first - 1), depth + 1);
+			source += "#line " + std::to_string(lineNumber + 1) + "\n";
+			continue;
+		}
+		source += line;
+		source += '\n';
+	}
+	return source;
+}
+
+std::string loadShaderSource(std::string path)
+{
+	return loadShaderSource(path, 0);
+}
+
+std::string loadShaderSource(std::string path, const std::string &defines)
+{
+	std::string source = loadShaderSource(path, 0);
+
+	//#version has to stay the first line
+	size_t version = source.find("#version");
+	size_t insert = 0;
+	int lineNumber = 1;
+	if (version != std::string::npos)
+	{
+		insert = source.find('\n', version);
+		insert = (insert == std::string::npos) ? source.size() : insert + 1;
+		for (size_t i = 0; i < version; i++)
+		{
+			if (source[i] == '\n')
+				lineNumber++;
+		}
+		lineNumber++;
+	}
+	source.insert(insert, defines + "#line " + std::to_string(lineNumber) + "\n");
+	return source;
 }
 
 void checkShader(GLuint shader) {
@@ -48,25 +113,194 @@ BaseShader::BaseShader(const std::string &shaderSource, ShaderType shaderType)
   checkShader(handle);
 }
 
+uint32_t hashUniformName(const char* name)
+{
+	uint32_t hash = 2166136261u;
+	for (const char* c = name; *c != '\0'; c++)
+	{
+		hash ^= (unsigned char)*c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+UniformHandle::UniformHandle(const char* name)
+{
+	m_name = name;
+	m_hash = hashUniformName(name);
+	m_programSerial = 0;
+	m_location = -1;
+}
+
+const char* UniformHandle::getName() const
+{
+	return m_name.c_str();
+}
+
+uint32_t UniformHandle::getHash() const
+{
+	return m_hash;
+}
+
 ShaderProgram::ShaderProgram(const VertexShader &vs, const FragmentShader &fs)
 {
   handle = glCreateProgram();
   attachShaders(handle, vs.handle, fs.handle);
-  glLinkProgram(handle);
+  linkProgram();
 }
 
 ShaderProgram::ShaderProgram(const ComputeShader &cs)
 {
   handle = glCreateProgram();
   attachShaders(handle, cs.handle);
-  glLinkProgram(handle);
+  linkProgram();
 }
 
 ShaderProgram::ShaderProgram(const VertexShader &vs, const GeometryShader &gs, const FragmentShader &fs)
 {
 	handle = glCreateProgram();
 	attachShaders(handle, vs.handle, gs.handle, fs.handle);
+	linkProgram();
+}
+
+void ShaderProgram::linkProgram()
+{
+	static unsigned int serialCounter = 0;
+	m_serial = ++serialCounter;
+	m_uniformCount = 0;
+	m_uniformBlocks = 0;
+	m_instancing = false;
+
 	glLinkProgram(handle);
+	introspectUniforms();
+	bindUniformBlocks();
+
+	GLint linked = GL_FALSE;
+	glGetProgramiv(handle, GL_LINK_STATUS, &linked);
+	if (linked != GL_FALSE)
+		m_instancing = hasUniformBlock(UNIFORM_BLOCK_OBJECT) && glGetAttribLocation(handle, "instanceMatrix") == (GLint)INSTANCE_MATRIX_LOCATION;
+}
+
+void ShaderProgram::bindUniformBlocks()
+{
+	static const char* blockNames[] = { "FrameBlock", "MaterialBlock", "ObjectBlock" };
+	for (int binding = 0; binding < 3; binding++)
+	{
+		GLuint index = glGetUniformBlockIndex(handle, blockNames[binding]);
+		if (index == GL_INVALID_INDEX)
+			continue;
+		glUniformBlockBinding(handle, index, binding);
+		m_uniformBlocks |= 1 << binding;
+	}
+}
+
+bool ShaderProgram::hasUniformBlock(UniformBlockBinding binding) const
+{
+	return (m_uniformBlocks & (1 << binding)) != 0;
+}
+
+bool ShaderProgram::hasInstancing() const
+{
+	return m_instancing;
+}
+
+void ShaderProgram::introspectUniforms()
+{
+	GLint linked = GL_FALSE;
+	glGetProgramiv(handle, GL_LINK_STATUS, &linked);
+	if (linked == GL_FALSE)
+		return;
+
+	GLint count = 0;
+	GLint maxLength = 0;
+	glGetProgramiv(handle, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(handle, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+	std::vector<GLchar> name(maxLength + 1);
+	for (GLint i = 0; i < count; i++)
+	{
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(handle, (GLuint)i, (GLsizei)name.size(), &length, &size, &type, name.data());
+		name[length] = '\0';
+
+		// members of uniform blocks have no location
+		GLint location = glGetUniformLocation(handle, name.data());
+		if (location < 0)
+			continue;
+		insertLocation(name.data(), hashUniformName(name.data()), location);
+
+		// arrays are listed as "name[0]", the location of "name" is the same
+		if (length > 3 && std::string(name.data() + length - 3) == "[0]")
+		{
+			name[length - 3] = '\0';
+			insertLocation(name.data(), hashUniformName(name.data()), location);
+		}
+	}
+}
+
+GLint ShaderProgram::findLocation(const char* name, uint32_t hash)
+{
+	if (!m_uniforms.empty())
+	{
+		size_t mask = m_uniforms.size() - 1;
+		for (size_t i = hash & mask;; i = (i + 1) & mask)
+		{
+			const UniformEntry& entry = m_uniforms[i];
+			if (!entry.used)
+				break;
+			if (entry.hash == hash && entry.name == name)
+				return entry.location;
+		}
+	}
+
+	// not active (e.g. optimized away) or an element like "name[2]": asked only once
+	GLint location = glGetUniformLocation(handle, name);
+	insertLocation(name, hash, location);
+	return location;
+}
+
+void ShaderProgram::insertLocation(const char* name, uint32_t hash, GLint location)
+{
+	if ((m_uniformCount + 1) * 2 > (int)m_uniforms.size())
+	{
+		std::vector<UniformEntry> old;
+		old.swap(m_uniforms);
+		UniformEntry empty = { 0, "", -1, false };
+		m_uniforms.assign(old.empty() ? 32 : old.size() * 2, empty);
+		m_uniformCount = 0;
+		for (auto& entry : old)
+		{
+			if (entry.used)
+				insertLocation(entry.name.c_str(), entry.hash, entry.location);
+		}
+	}
+
+	size_t mask = m_uniforms.size() - 1;
+	for (size_t i = hash & mask;; i = (i + 1) & mask)
+	{
+		UniformEntry& entry = m_uniforms[i];
+		if (!entry.used)
+		{
+			entry.hash = hash;
+			entry.name = name;
+			entry.location = location;
+			entry.used = true;
+			m_uniformCount++;
+			return;
+		}
+		if (entry.hash == hash && entry.name == name)
+		{
+			entry.location = location;
+			return;
+		}
+	}
+}
+
+int ShaderProgram::getUniformCount()
+{
+	return m_uniformCount;
 }
 
 void ShaderProgram::bind() const
@@ -80,7 +314,60 @@ void ShaderProgram::unbind() const
 }
 
 GLuint ShaderProgram::getLocation(std::string uniform) {
-    return  glGetUniformLocation(handle,uniform.c_str());
+    return (GLuint)findLocation(uniform.c_str(), hashUniformName(uniform.c_str()));
+}
+
+GLint ShaderProgram::getLocation(const char* uniform) {
+	return findLocation(uniform, hashUniformName(uniform));
+}
+
+GLint ShaderProgram::getLocation(const UniformHandle &uniform) {
+	if (uniform.m_programSerial != m_serial)
+	{
+		uniform.m_location = findLocation(uniform.m_name.c_str(), uniform.m_hash);
+		uniform.m_programSerial = m_serial;
+	}
+	return uniform.m_location;
+}
+
+void ShaderProgram::sendInt(const UniformHandle &uniform, int i) {
+	glUniform1i(getLocation(uniform), i);
+}
+
+void ShaderProgram::sendFloat(const UniformHandle &uniform, float f) {
+	glUniform1f(getLocation(uniform), f);
+}
+
+void ShaderProgram::sendVec2(const UniformHandle &uniform, glm::vec2 v) {
+	glUniform2f(getLocation(uniform), v.x, v.y);
+}
+
+void ShaderProgram::sendVec3(const UniformHandle &uniform, glm::vec3 v) {
+	glUniform3f(getLocation(uniform), v.x, v.y, v.z);
+}
+
+void ShaderProgram::sendVec4(const UniformHandle &uniform, glm::vec4 v) {
+	glUniform4f(getLocation(uniform), v.x, v.y, v.z, v.w);
+}
+
+void ShaderProgram::sendFloatArray(const UniformHandle &uniform, int size, GLfloat array[]) {
+	glUniform1fv(getLocation(uniform), size, array);
+}
+
+void ShaderProgram::sendMat4(const UniformHandle &uniform, const glm::mat4 &m) {
+	glUniformMatrix4fv(getLocation(uniform), 1, false, glm::value_ptr(m));
+}
+
+void ShaderProgram::sendSampler2D(const UniformHandle &uniform, GLuint sampler2Dhandler, int textureIndex) {
+	if (textureIndex > 32)
+	{
+		std::cerr << "Error in ShaderProgram::sendSampler2D - textureIndex too high" << std::endl;
+		return;
+	}
+
+	glUniform1i(getLocation(uniform), textureIndex);
+	glActiveTexture(GL_TEXTURE0 + textureIndex);
+	glBindTexture(GL_TEXTURE_2D, sampler2Dhandler);
 }
 
 void ShaderProgram::sendInt(std::string uniform, int i) {
@@ -135,6 +422,19 @@ void ShaderProgram::sendSampler2D(std::string uniform, GLuint sampler2Dhandler,
 	glBindTexture(GL_TEXTURE_2D, sampler2Dhandler);
 }
 
+void ShaderProgram::sendSkyboxTexture(const UniformHandle &uniform, GLuint sampler2Dhandler, int textureIndex)
+{
+	if (textureIndex > 32)
+	{
+		std::cerr << "Error in ShaderProgram::sendSkyboxTexture - textureIndex too high" << std::endl;
+		return;
+	}
+
+	glUniform1i(getLocation(uniform), textureIndex);
+	glActiveTexture(GL_TEXTURE0 + textureIndex);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, sampler2Dhandler);
+}
+
 void ShaderProgram::sendSkyboxTexture(std::string uniform, GLuint sampler2Dhandler, int textureIndex)
 {
 	if (textureIndex > 32)
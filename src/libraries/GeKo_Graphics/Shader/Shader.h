@@ -10,6 +10,8 @@
 #include <fstream>
 #include <iostream>
 #include <glm/gtc/type_ptr.hpp>
+#include <vector>
+#include <cstdint>
 
 class PointLight;
 class DirectionLight;
@@ -25,7 +27,20 @@ enum ShaderType{
 	COMPUTE_SHADER = GL_COMPUTE_SHADER,
 };
 /// Loads the shader source from a location
+/** #include "file" lines are replaced by the file (relative to the including file), with #line directives for the error messages*/
 std::string loadShaderSource(std::string path);
+/// Loads the shader source with some #define lines behind #version, e.g. "#define UNIFORM_BLOCKS\n"
+std::string loadShaderSource(std::string path, const std::string &defines);
+
+/// The binding points of the uniform blocks of UniformBlocks.glsl, see UniformBuffer.h
+enum UniformBlockBinding{
+	UNIFORM_BLOCK_FRAME = 0,
+	UNIFORM_BLOCK_MATERIAL = 1,
+	UNIFORM_BLOCK_OBJECT = 2,
+};
+
+/// The vertex attribute "mat4 instanceMatrix" of instanced draws, it uses the locations 4 .. 7
+static const GLuint INSTANCE_MATRIX_LOCATION = 4;
 
 /// FIXME: Doesn't check properly - Validates the shader 
 void checkShader(GLuint shader);
@@ -57,6 +72,27 @@ template<typename ... Args>
 void attachShaders(GLuint handle, GLuint shaderHandle, Args ...args);
 void attachShaders(GLuint handle, GLuint shaderHandle);
 
+/// The name of a uniform with its precomputed hash, for the hot paths
+/** Create it once (e.g. static) and send with it: no string is built or hashed per call.
+The handle remembers the location of the last program it was used with, the same handle works with every program*/
+class UniformHandle{
+
+public:
+	explicit UniformHandle(const char* name);
+	const char* getName() const;
+	uint32_t getHash() const;
+
+private:
+	friend class ShaderProgram;
+	std::string m_name;
+	uint32_t m_hash;
+	mutable unsigned int m_programSerial;	//0 is no program
+	mutable GLint m_location;
+};
+
+/// FNV-1a hash of a uniform name, the key of the location table of ShaderProgram
+uint32_t hashUniformName(const char* name);
+
 class ShaderProgram{
 
 public:
@@ -66,7 +102,26 @@ public:
     ShaderProgram(const VertexShader &vs, const GeometryShader &gs, const FragmentShader &fs);
     void bind() const;
     void unbind() const;
+    /// The locations of the active uniforms are read after linking, other names are asked the driver once and cached (-1 if unused)
     GLuint getLocation(std::string uniform);
+    GLint getLocation(const char* uniform);
+    GLint getLocation(const UniformHandle &uniform);
+    /// Number of names in the location table
+    int getUniformCount();
+    /// True if the program uses the block (FrameBlock, MaterialBlock or ObjectBlock), it is bound to its binding point after linking
+    bool hasUniformBlock(UniformBlockBinding binding) const;
+    /// True if the program reads the model matrix of instanced draws from instanceMatrix (see INSTANCE_MATRIX_LOCATION) and the ObjectBlock
+    bool hasInstancing() const;
+
+	void sendInt(const UniformHandle &uniform, int i);
+	void sendFloat(const UniformHandle &uniform, float f);
+	void sendVec2(const UniformHandle &uniform, glm::vec2 v);
+	void sendVec3(const UniformHandle &uniform, glm::vec3 v);
+	void sendVec4(const UniformHandle &uniform, glm::vec4 v);
+	void sendFloatArray(const UniformHandle &uniform, int size, GLfloat array[]);
+	void sendMat4(const UniformHandle &uniform, const glm::mat4 &m);
+	void sendSampler2D(const UniformHandle &uniform, GLuint sampler2Dhandler, int textureIndex);
+	void sendSkyboxTexture(const UniformHandle &uniform, GLuint sampler2Dhandler, int textureIndex = 0);
 	void sendInt(std::string uniform, int i);
 	void sendDouble(std::string uniform, double d);
 	void sendFloat(std::string uniform, float f);
@@ -83,4 +138,24 @@ public:
 	void sendLightData(std::string uniformPosition, std::string uniformColor, std::string uniformDirection, std::string uniformExponent, std::string uniformAngle, std::string uniformRadius, ConeLight light);
 	//add sendLight general
 
+private:
+	struct UniformEntry{
+		uint32_t hash;
+		std::string name;
+		GLint location;
+		bool used;
+	};
+
+	void linkProgram();
+	void introspectUniforms();
+	void bindUniformBlocks();
+	GLint findLocation(const char* name, uint32_t hash);
+	void insertLocation(const char* name, uint32_t hash, GLint location);
+
+	// open addressing, the size is a power of two and at most half used
+	std::vector<UniformEntry> m_uniforms;
+	int m_uniformCount;
+	unsigned int m_serial;	//unique per program, for the UniformHandle cache
+	int m_uniformBlocks;	//bit per UniformBlockBinding
+	bool m_instancing;
 };
\ No newline at end of file
@@ -7,4 +7,108 @@ ShaderManager::ShaderManager()
 
 ShaderManager::~ShaderManager()
 {
-}
\ No newline at end of file
+}
+
+ShaderManager* ShaderManager::getInstance()
+{
+	static ShaderManager instance;
+	return &instance;
+}
+
+static std::string loadSource(const std::string& defines, const std::string& path)
+{
+	if (defines.empty())
+		return loadShaderSource(SHADERS_PATH + path);
+	return loadShaderSource(SHADERS_PATH + path, defines);
+}
+
+static std::string getKey(const std::string& defines, const std::string& paths)
+{
+	return defines.empty() ? paths : paths + "|" + defines;
+}
+
+ShaderProgram* ShaderManager::getProgram(const std::string& vertexPath, const std::string& fragmentPath)
+{
+	return getDefinedProgram("", vertexPath, fragmentPath);
+}
+
+ShaderProgram* ShaderManager::getProgram(const std::string& vertexPath, const std::string& geometryPath, const std::string& fragmentPath)
+{
+	return getDefinedProgram("", vertexPath, geometryPath, fragmentPath);
+}
+
+ShaderProgram* ShaderManager::getComputeProgram(const std::string& computePath)
+{
+	return getDefinedComputeProgram("", computePath);
+}
+
+ShaderProgram* ShaderManager::getDefinedProgram(const std::string& defines, const std::string& vertexPath, const std::string& fragmentPath)
+{
+	std::string key = getKey(defines, vertexPath + "|" + fragmentPath);
+	auto it = m_programs.find(key);
+	if (it != m_programs.end())
+		return it->second;
+
+	VertexShader vs(loadSource(defines, vertexPath));
+	FragmentShader fs(loadSource(defines, fragmentPath));
+	ShaderProgram* program = new ShaderProgram(vs, fs);
+
+	//the shaders stay attached to the program until it gets deleted
+	glDeleteShader(vs.handle);
+	glDeleteShader(fs.handle);
+
+	m_programs[key] = program;
+	return program;
+}
+
+ShaderProgram* ShaderManager::getDefinedProgram(const std::string& defines, const std::string& vertexPath, const std::string& geometryPath,
+	const std::string& fragmentPath)
+{
+	std::string key = getKey(defines, vertexPath + "|" + geometryPath + "|" + fragmentPath);
+	auto it = m_programs.find(key);
+	if (it != m_programs.end())
+		return it->second;
+
+	VertexShader vs(loadSource(defines, vertexPath));
+	GeometryShader gs(loadSource(defines, geometryPath));
+	FragmentShader fs(loadSource(defines, fragmentPath));
+	ShaderProgram* program = new ShaderProgram(vs, gs, fs);
+
+	glDeleteShader(vs.handle);
+	glDeleteShader(gs.handle);
+	glDeleteShader(fs.handle);
+
+	m_programs[key] = program;
+	return program;
+}
+
+ShaderProgram* ShaderManager::getDefinedComputeProgram(const std::string& defines, const std::string& computePath)
+{
+	std::string key = getKey(defines, computePath);
+	auto it = m_programs.find(key);
+	if (it != m_programs.end())
+		return it->second;
+
+	ComputeShader cs(loadSource(defines, computePath));
+	ShaderProgram* program = new ShaderProgram(cs);
+
+	glDeleteShader(cs.handle);
+
+	m_programs[key] = program;
+	return program;
+}
+
+void ShaderManager::clear()
+{
+	for (auto& program : m_programs)
+	{
+		glDeleteProgram(program.second->handle);
+		delete program.second;
+	}
+	m_programs.clear();
+}
+
+int ShaderManager::getProgramCount()
+{
+	return (int)m_programs.size();
+}
@@ -1,11 +1,46 @@
 #pragma once
 
-#include <GeKo_Graphics/include.h>
+#include <map>
+#include <GeKo_Graphics/Shader/Shader.h>
+
+///Cache of the shader programs, shared by the whole process
+
+/*
+The programs are keyed by their source files (relative to SHADERS_PATH) and compiled & linked only with the first request.
+getDefinedProgram compiles the sources with #define lines behind #version (see loadShaderSource), e.g. ParticleBatch uses the
+particle shaders with "#define PARTICLE_BATCH\n". The defines are part of the key.
+Use ShaderManager::getInstance() to share the programs, e.g. all particle Effects use the same three programs.
+The ShaderManager owns the programs, don't delete them. They live until clear(), the destructor of the instance runs after
+the GL context is gone and leaves them alone.
+*/
 
 class ShaderManager
 {
 public:
 	ShaderManager();
 	~ShaderManager();
+
+	///The cache of the whole process
+	static ShaderManager* getInstance();
+
+	///Returns the program of a vertex & fragment shader
+	ShaderProgram* getProgram(const std::string& vertexPath, const std::string& fragmentPath);
+	///Returns the program of a vertex, geometry & fragment shader
+	ShaderProgram* getProgram(const std::string& vertexPath, const std::string& geometryPath, const std::string& fragmentPath);
+	///Returns the program of a compute shader
+	ShaderProgram* getComputeProgram(const std::string& computePath);
+
+	///The same programs with the defines behind #version
+	ShaderProgram* getDefinedProgram(const std::string& defines, const std::string& vertexPath, const std::string& fragmentPath);
+	ShaderProgram* getDefinedProgram(const std::string& defines, const std::string& vertexPath, const std::string& geometryPath,
+		const std::string& fragmentPath);
+	ShaderProgram* getDefinedComputeProgram(const std::string& defines, const std::string& computePath);
+
+	///Deletes all programs, needs the GL context. Pointers of getProgram are invalid afterwards
+	void clear();
+
+	int getProgramCount();
+
 private:
-};
\ No newline at end of file
+	std::map<std::string, ShaderProgram*> m_programs;
+};
@@ -0,0 +1,144 @@
+#include "UniformBuffer.h"
+#include <cstring>
+
+//1024 objects of 256 byte alignment before the ring is orphaned
+static const GLsizeiptr OBJECT_RING_SIZE = 256 * 1024;
+
+UniformBuffer::UniformBuffer(GLsizeiptr size)
+{
+	m_size = size;
+	glGenBuffers(1, &m_handle);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_handle);
+	glBufferData(GL_UNIFORM_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+UniformBuffer::~UniformBuffer()
+{
+	glDeleteBuffers(1, &m_handle);
+}
+
+void UniformBuffer::update(const void* data, GLsizeiptr size)
+{
+	if (size > m_size)
+	{
+		std::cout << "ERROR: UniformBuffer::update - " << size << " bytes do not fit into " << m_size << std::endl;
+		return;
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, m_handle);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UniformBuffer::bind(UniformBlockBinding binding) const
+{
+	glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_handle);
+}
+
+GLuint UniformBuffer::getHandle() const
+{
+	return m_handle;
+}
+
+UniformRing::UniformRing(GLsizeiptr size)
+{
+	m_size = size;
+	m_offset = 0;
+	m_alignment = 256;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &m_alignment);
+	if (m_alignment <= 0)
+		m_alignment = 256;
+
+	glGenBuffers(1, &m_handle);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_handle);
+	glBufferData(GL_UNIFORM_BUFFER, size, NULL, GL_STREAM_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+UniformRing::~UniformRing()
+{
+	glDeleteBuffers(1, &m_handle);
+}
+
+void UniformRing::push(const void* data, GLsizeiptr size, UniformBlockBinding binding)
+{
+	glBindBuffer(GL_UNIFORM_BUFFER, m_handle);
+	if (m_offset + size > m_size)
+	{
+		glBufferData(GL_UNIFORM_BUFFER, m_size, NULL, GL_STREAM_DRAW);
+		m_offset = 0;
+	}
+
+	void* range = glMapBufferRange(GL_UNIFORM_BUFFER, m_offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	if (range)
+	{
+		std::memcpy(range, data, size);
+		glUnmapBuffer(GL_UNIFORM_BUFFER);
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferRange(GL_UNIFORM_BUFFER, binding, m_handle, m_offset, size);
+
+	m_offset += (size + m_alignment - 1) / m_alignment * m_alignment;
+}
+
+UniformBlocks* UniformBlocks::getInstance()
+{
+	static UniformBlocks instance;
+	return &instance;
+}
+
+UniformBlocks::UniformBlocks() :
+m_frame(NULL), m_material(NULL), m_objects(NULL), m_hasMaterial(false)
+{
+}
+
+UniformBlocks::~UniformBlocks()
+{
+}
+
+void UniformBlocks::create()
+{
+	m_frame = new UniformBuffer(sizeof(FrameUniforms));
+	m_material = new UniformBuffer(sizeof(MaterialUniforms));
+	m_objects = new UniformRing(OBJECT_RING_SIZE);
+	m_hasMaterial = false;
+}
+
+void UniformBlocks::clear()
+{
+	delete m_frame;
+	delete m_material;
+	delete m_objects;
+	m_frame = NULL;
+	m_material = NULL;
+	m_objects = NULL;
+	m_hasMaterial = false;
+}
+
+void UniformBlocks::setFrame(const FrameUniforms& frame)
+{
+	if (!m_frame)
+		create();
+	m_frame->update(&frame, sizeof(FrameUniforms));
+	m_frame->bind(UNIFORM_BLOCK_FRAME);
+}
+
+void UniformBlocks::setMaterial(const MaterialUniforms& material)
+{
+	if (!m_material)
+		create();
+	if (!m_hasMaterial || std::memcmp(&m_currentMaterial, &material, sizeof(MaterialUniforms)) != 0)
+	{
+		m_material->update(&material, sizeof(MaterialUniforms));
+		m_currentMaterial = material;
+		m_hasMaterial = true;
+	}
+	m_material->bind(UNIFORM_BLOCK_MATERIAL);
+}
+
+void UniformBlocks::pushObject(const ObjectUniforms& object)
+{
+	if (!m_objects)
+		create();
+	m_objects->push(&object, sizeof(ObjectUniforms), UNIFORM_BLOCK_OBJECT);
+}
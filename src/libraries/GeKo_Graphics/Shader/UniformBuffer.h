@@ -0,0 +1,136 @@
+#pragma once
+#include <GeKo_Graphics/Shader/Shader.h>
+
+/*
+Description:
+std140 uniform buffers for the blocks of src/shaders/UniformBlocks.glsl. The structs below have the same layout
+as the blocks, a struct is uploaded with one call and bound with glBindBufferBase/glBindBufferRange instead of
+a glUniform* call per value.
+
+-FrameUniforms: camera, time & shadow light, uploaded once per frame (binding 0)
+-MaterialUniforms: a UniformBuffer per material, bound when the material changes (binding 1)
+-ObjectUniforms: model matrix & flags, written to the next range of a ring buffer per object (binding 2)
+
+UniformBlocks holds the buffers of a frame, Node::render pushes its ObjectUniforms there if the shader uses the ObjectBlock.
+*/
+
+struct LightUniforms
+{
+	glm::vec4 position;
+	glm::vec3 color;
+	float spotExponent;
+	glm::vec3 spotDirection;
+	float spotCutoff;
+};
+
+struct FrameUniforms
+{
+	glm::mat4 viewMatrix;
+	glm::mat4 projectionMatrix;
+	glm::mat4 viewProjectionMatrix;
+	glm::mat4 lightVPBias;
+	glm::vec4 cameraPosition;
+	LightUniforms light;
+	glm::vec3 lightAmbient;
+	float time;
+	int useShadowMap;
+	int shadowMode;
+	int padding[2];
+};
+
+struct MaterialUniforms
+{
+	glm::vec3 diffuse;
+	float shininess;
+	glm::vec3 specular;
+	float alpha;
+};
+
+struct ObjectUniforms
+{
+	glm::mat4 modelMatrix;
+	glm::mat4 previousModelMatrix;
+	int useTexture;
+	int useNormalMap;
+	int useHeightMap;
+	int useHeightMapShadows;
+	float parallaxScale;
+	float parallaxBias;
+	int useInstancing;
+	int padding;
+};
+
+static_assert(sizeof(LightUniforms) == 48, "LightUniforms has to match the std140 layout of LightData");
+static_assert(sizeof(FrameUniforms) == 352, "FrameUniforms has to match the std140 layout of FrameBlock");
+static_assert(sizeof(MaterialUniforms) == 32, "MaterialUniforms has to match the std140 layout of MaterialBlock");
+static_assert(sizeof(ObjectUniforms) == 160, "ObjectUniforms has to match the std140 layout of ObjectBlock");
+
+/// A uniform buffer of a fixed size, e.g. the block of a material
+class UniformBuffer
+{
+public:
+	UniformBuffer(GLsizeiptr size);
+	~UniformBuffer();
+
+	void update(const void* data, GLsizeiptr size);
+	/// Binds the whole buffer to the binding point
+	void bind(UniformBlockBinding binding) const;
+	GLuint getHandle() const;
+
+private:
+	UniformBuffer(const UniformBuffer&);
+	UniformBuffer& operator=(const UniformBuffer&);
+
+	GLuint m_handle;
+	GLsizeiptr m_size;
+};
+
+/// A ring buffer of small blocks that change per draw, each push writes the next aligned range and binds it
+/** The ranges are written unsynchronized, when the ring is full the storage is orphaned and the driver keeps the old one for the draws in flight*/
+class UniformRing
+{
+public:
+	UniformRing(GLsizeiptr size);
+	~UniformRing();
+
+	void push(const void* data, GLsizeiptr size, UniformBlockBinding binding);
+
+private:
+	UniformRing(const UniformRing&);
+	UniformRing& operator=(const UniformRing&);
+
+	GLuint m_handle;
+	GLsizeiptr m_size;
+	GLintptr m_offset;
+	GLint m_alignment;	//GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+};
+
+/// The uniform buffers of the Renderer, created with the first use (needs the OpenGL context)
+/** The Renderer deletes the buffers with clear() while its context exists*/
+class UniformBlocks
+{
+public:
+	static UniformBlocks* getInstance();
+
+	/// Deletes the buffers, needs the GL context. The next use creates them again
+	void clear();
+
+	/// Uploads & binds the FrameBlock, once per frame
+	void setFrame(const FrameUniforms& frame);
+	/// Binds the MaterialBlock of the default material, uploaded only if it changes
+	void setMaterial(const MaterialUniforms& material);
+	/// Writes the ObjectBlock of the next draw
+	void pushObject(const ObjectUniforms& object);
+
+private:
+	UniformBlocks();
+	~UniformBlocks();
+
+	void create();
+
+	UniformBuffer* m_frame;
+	UniformBuffer* m_material;
+	UniformRing* m_objects;
+	MaterialUniforms m_currentMaterial;
+	bool m_hasMaterial;
+};
@@ -0,0 +1,23 @@
+#include "Uniforms.h"
+
+namespace Uniforms
+{
+	const UniformHandle viewMatrix("viewMatrix");
+	const UniformHandle projectionMatrix("projectionMatrix");
+	const UniformHandle camPos("camPos");
+
+	const UniformHandle modelMatrix("modelMatrix");
+	const UniformHandle previousModelMatrix("previousModelMatrix");
+	const UniformHandle useTexture("useTexture");
+	const UniformHandle useNormalMap("useNormalMap");
+	const UniformHandle useHeightMap("useHeightMap");
+	const UniformHandle useHeightMapShadows("useHeightMapShadows");
+	const UniformHandle parallaxScale("parallaxScale");
+	const UniformHandle parallaxBias("parallaxBias");
+
+	const UniformHandle testTexture("testTexture");
+	const UniformHandle normalMap("normalMap");
+	const UniformHandle heightMap("heightMap");
+
+	const UniformHandle particleTextures[4] = { UniformHandle("tex0"), UniformHandle("tex1"), UniformHandle("tex2"), UniformHandle("tex3") };
+}
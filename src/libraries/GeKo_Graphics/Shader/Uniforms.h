@@ -0,0 +1,33 @@
+#pragma once
+#include <GeKo_Graphics/Shader/Shader.h>
+
+/*
+Description:
+The UniformHandles of uniforms which are sent by more than one render path (Node, RenderQueue, GPUScene, RenderCommandBuffer,
+the particle systems & the Renderer). Uniforms of a single file stay a static UniformHandle in that file.
+*/
+namespace Uniforms
+{
+	//camera
+	extern const UniformHandle viewMatrix;
+	extern const UniformHandle projectionMatrix;
+	extern const UniformHandle camPos;
+
+	//object values for shaders without the ObjectBlock (see ObjectUniforms)
+	extern const UniformHandle modelMatrix;
+	extern const UniformHandle previousModelMatrix;
+	extern const UniformHandle useTexture;
+	extern const UniformHandle useNormalMap;
+	extern const UniformHandle useHeightMap;
+	extern const UniformHandle useHeightMapShadows;
+	extern const UniformHandle parallaxScale;
+	extern const UniformHandle parallaxBias;
+
+	//material textures on unit 0, 1 & 2
+	extern const UniformHandle testTexture;
+	extern const UniformHandle normalMap;
+	extern const UniformHandle heightMap;
+
+	//tex0 .. tex3 of ParticleColor.glsl, an emitter has at most 4 textures
+	extern const UniformHandle particleTextures[4];
+}
@@ -27,6 +27,7 @@
 #include <GeKo_Graphics/Camera/Trackball.h>
 
 #include <GeKo_Graphics/Material/Texture.h>
+#include <GeKo_Graphics/Material/TextureManager.h>
 
 #include <GeKo_Graphics/Light/ConeLight.h>
 #include <GeKo_Graphics/Light/DirectionLight.h>
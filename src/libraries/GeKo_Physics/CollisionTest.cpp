@@ -2,9 +2,12 @@
 
 CollisionTest::CollisionTest()
 {
-
+	m_testedPairs = 0;
+	m_collidingPairs = 0;
 }
 CollisionTest::CollisionTest(std::vector <Node*> TestObjects){
+	m_testedPairs = 0;
+	m_collidingPairs = 0;
     objects.clear();
 	for(int i = 0; i < TestObjects.size(); i++){
 	    objects.push_back(TestObjects.at(i));
@@ -13,6 +16,8 @@ CollisionTest::CollisionTest(std::vector <Node*> TestObjects){
 
 CollisionTest::CollisionTest(Node* rootNode)
 {
+	m_testedPairs = 0;
+	m_collidingPairs = 0;
 	collectNodes(rootNode);
 }
 
@@ -38,6 +43,9 @@ bool CollisionTest::collides(BoundingSphere* sphere1, BoundingSphere* sphere2)
 
 void CollisionTest::update()
 {
+	m_testedPairs = 0;
+	m_collidingPairs = 0;
+
 	if (objects.size() == 1)
 	{
 		objects.at(0)->getBoundingSphere()->setCollisionDetected(false);
@@ -62,6 +70,12 @@ void CollisionTest::update()
 						bool collisionBefore = objects.at(i)->getBoundingList()->at(k)->getCollisionDetected();
 						bool collisionAfter = collides(objects.at(i)->getBoundingList()->at(k), objects.at(j)->getBoundingSphere());
 
+						m_testedPairs++;
+						if (collisionAfter)
+						{
+							m_collidingPairs++;
+						}
+
 						//If the object did not collide untill now and is colliding now, we send a notify to the observers.
 						if ((!collisionBefore | collisionBefore) & collisionAfter)
 						{
@@ -128,6 +142,16 @@ void CollisionTest::update()
 	}
 }
 
+int CollisionTest::getTestedPairs()
+{
+	return m_testedPairs;
+}
+
+int CollisionTest::getCollidingPairs()
+{
+	return m_collidingPairs;
+}
+
 void CollisionTest::addNode(Node* nodeObject)
 {
 	objects.push_back(nodeObject);
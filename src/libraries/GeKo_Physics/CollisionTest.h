@@ -12,6 +12,9 @@ class CollisionTest : public Subject<Node, Collision_Event>
 private:
     std::vector <Node*> objects;
 
+	int m_testedPairs;
+	int m_collidingPairs;
+
 public:
 	CollisionTest();
     CollisionTest(std::vector <Node*> TestObjects);
@@ -31,6 +34,14 @@ public:
 	/**/
 	void addNode(Node* nodeObject);
 
+	///Returns how many sphere pairs were tested in the last update()
+	/**/
+	int getTestedPairs();
+
+	///Returns how many of the tested sphere pairs were colliding in the last update()
+	/**/
+	int getCollidingPairs();
+
 	///Collects all Nodes of the scenegraph
 	/**Should be used before the render Loop but can be updated every frame too*/
 	void collectNodes(Node* root);
@@ -7,7 +7,7 @@ namespace Handle{
   template<class T>
     struct HandleManager;
   using HandleID = uint16_t;
-  using Counter = uint8_t;
+  using Counter = uint32_t;	//a slot is reused a lot (pooled particle systems), so no wrap after 256 removes
 
   template<class T>
     struct Handle{
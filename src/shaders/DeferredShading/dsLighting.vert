@@ -2,9 +2,13 @@
 
 layout (location = 0) in vec4 position;
 
+#ifdef UNIFORM_BLOCKS
+#include "../UniformBlocks.glsl"
+#else
 uniform mat4 modelMatrix;
 uniform mat4 viewMatrix;
 uniform mat4 projectionMatrix;
+#endif
 uniform vec3 lightColor;
 
 out vec4 passPosition;
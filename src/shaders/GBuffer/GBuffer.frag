@@ -2,6 +2,9 @@
 
 #define HW_PCF
 
+#ifdef UNIFORM_BLOCKS
+#include "../UniformBlocks.glsl"
+#else
 uniform int useTexture;
 uniform int useNormalMap;
 uniform int useHeightMap;
@@ -9,6 +12,7 @@ uniform int useHeightMapShadows;
 uniform int useShadowMap;
 
 uniform int shadowMode;
+#endif
 
 uniform sampler2D fboTexture;
 uniform sampler2D normalMap;
@@ -24,12 +28,14 @@ uniform float fWindowHeight;
 uniform float fWindowWidth;
 uniform float thresholdValue;
 
+uniform mat4 previousViewMatrix;
+uniform mat4 previousProjectionMatrix;
+
+#ifndef UNIFORM_BLOCKS
 uniform mat4 modelMatrix;
 uniform mat4 previousModelMatrix;
 uniform mat4 viewMatrix;
-uniform mat4 previousViewMatrix;
 uniform mat4 projectionMatrix;
-uniform mat4 previousProjectionMatrix;
 
 uniform float parallaxScale;
 uniform float parallaxBias;
@@ -52,6 +58,7 @@ uniform struct
 } light;
 
 uniform vec3 lightAmbient;
+#endif
 uniform float fDepthBias = 0.005f;
 
 in vec4 passPosition;
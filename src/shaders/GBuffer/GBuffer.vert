@@ -4,12 +4,18 @@ layout (location = 0) in vec4 position;
 layout (location = 1) in vec3 normal;
 layout (location = 2) in vec2 uv;
 
+//the Renderer loads the shader with UNIFORM_BLOCKS, the examples send uniforms
+#ifdef UNIFORM_BLOCKS
+#include "../UniformBlocks.glsl"
+layout (location = 4) in mat4 instanceMatrix;
+#else
 uniform mat4 modelMatrix;
 uniform mat4 viewMatrix;
 uniform mat4 projectionMatrix;  
 
 uniform int useShadowMap;
 uniform mat4 lightVPBias;
+#endif
 
 out vec4 passPosition;
 out vec3 passNormal;
@@ -24,7 +30,12 @@ out vec3 passSkyboxTexCoord;
  
 void main(){
 
-	mat4 MV = viewMatrix * modelMatrix;
+#ifdef UNIFORM_BLOCKS
+	mat4 model = (useInstancing != 0) ? instanceMatrix : modelMatrix;
+#else
+	mat4 model = modelMatrix;
+#endif
+	mat4 MV = viewMatrix * model;
 
     gl_Position = projectionMatrix * MV * position;
 
@@ -39,6 +50,6 @@ void main(){
 
 	if(useShadowMap != 0)
 	{
-		passShadowCoord = lightVPBias * modelMatrix * position;
+		passShadowCoord = lightVPBias * model * position;
 	}
 }
@@ -0,0 +1,45 @@
+#version 430 core
+
+//GBuffer.vert for the GPU driven path (see GPUScene): the model matrix comes from the object SSBO,
+//the index of the object is an instanced attribute fed by the visible objects of the culling pass
+
+layout (location = 0) in vec4 position;
+layout (location = 1) in vec3 normal;
+layout (location = 2) in vec2 uv;
+layout (location = 8) in uint objectIndex;
+
+#include "../UniformBlocks.glsl"
+#include "../GPUDriven/GPUObjects.glsl"
+
+out vec4 passPosition;
+out vec3 passNormal;
+out vec2 passUV;
+
+out vec3 passWorldNormal;
+out mat3 normalMatrix;
+
+out vec4 passShadowCoord;
+
+out vec3 passSkyboxTexCoord;
+ 
+void main(){
+
+	mat4 model = objects[objectIndex].modelMatrix;
+	mat4 MV = viewMatrix * model;
+
+    gl_Position = projectionMatrix * MV * position;
+
+	passPosition = MV * position;
+	normalMatrix = mat3(transpose(inverse(MV)));
+	passNormal = normalize(normalMatrix * normal);
+	passUV = uv;
+	
+	passWorldNormal = normal;
+
+	passSkyboxTexCoord = position.xyz;
+
+	if(useShadowMap != 0)
+	{
+		passShadowCoord = lightVPBias * model * position;
+	}
+}
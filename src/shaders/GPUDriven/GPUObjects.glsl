@@ -0,0 +1,17 @@
+//per object data of the GPU driven path, the same layout as GPUObject in GeKo_Graphics/Scenegraph/GPUScene.h
+
+struct GPUObject
+{
+	mat4 modelMatrix;
+	mat4 previousModelMatrix;
+	vec4 boundingSphere;	//world space, xyz center, w radius
+	uint slot;	//draw command of the object
+	uint material;
+	uint padding0;
+	uint padding1;
+};
+
+layout(std430, binding=3) buffer object_ssbo
+{
+	GPUObject objects[];
+};
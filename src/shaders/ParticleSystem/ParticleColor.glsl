@@ -0,0 +1,139 @@
+//The color of a particle, shared by the fragment shaders of the point sprites & the geometry shader. Needs ParticleLook.glsl
+
+uniform sampler2D tex0;
+uniform sampler2D tex1;
+uniform sampler2D tex2;
+uniform sampler2D tex3;
+
+//the textures blended over the lifetime (fullLifetime * time[i] is the moment of texture i), faded in after the birth & out before the death
+vec4 getParticleColor(EmitterLook look, float remainLifetime, vec2 uv){
+
+	float full = look.lifetime.x;
+	float blending = look.lifetime.w;
+	int texCount = look.flags.z;
+	vec4 color, color1, color2, color3, color4;
+	float passedLifetime = full - remainLifetime;
+
+	if(texCount == 0 || look.flags.y == 0){
+		color = vec4(1.0, 1.0, 1.0, 1.0);
+	}
+
+	else if(texCount == 1){
+		color = texture(tex0, uv);
+	}
+
+	else if (texCount == 2){
+		color1 = texture(tex0, uv);
+		color2 = texture(tex1, uv);
+
+		// time when the texture fades in
+		float lifetimeTexture2 = look.time[1] * full;
+
+		//computing the color
+		if(remainLifetime >= (lifetimeTexture2 + blending)){
+			color = color1;
+		}
+		else if(remainLifetime  < lifetimeTexture2 + blending && remainLifetime > lifetimeTexture2){
+			//interpolation
+			float interpolationTime = remainLifetime - lifetimeTexture2;
+			float cp = min(interpolationTime/blending, 1);
+			color = color1 * cp + color2 * (1.0 - cp);
+		}
+		else{
+			color = color2;
+		}
+	}
+
+	else if (texCount == 3){
+		color1 = texture(tex0, uv);
+		color2 = texture(tex1, uv);
+		color3 = texture(tex2, uv);
+
+		float lifetimeTexture2 = look.time[1] * full;
+		float lifetimeTexture3 = look.time[2] * full;
+
+		//compute our color
+		if(remainLifetime >= (lifetimeTexture2 + blending)){
+			color = color1;
+		}
+
+		else if(remainLifetime < lifetimeTexture2 + blending && remainLifetime > lifetimeTexture2){
+			float interpolationTime = remainLifetime - lifetimeTexture2;
+			float cp = min(interpolationTime/blending, 1);
+			color = color1 * cp + color2 * (1.0 -cp);
+		}
+
+		else if (remainLifetime <= lifetimeTexture2 && remainLifetime >= lifetimeTexture3 + blending){
+			color = color2;
+		}
+
+		else if(remainLifetime  < lifetimeTexture3 + blending && remainLifetime > lifetimeTexture3){
+			float interpolationTime = remainLifetime - lifetimeTexture3;
+			float cp = min(interpolationTime/blending, 1);
+			color = color2 * cp + color3 * (1.0 - cp);
+		}
+
+		else{
+			color = color3;
+		}
+	}
+
+	else if (texCount == 4){
+		color1 = texture(tex0, uv);
+		color2 = texture(tex1, uv);
+		color3 = texture(tex2, uv);
+		color4 = texture(tex3, uv);
+
+		float lifetimeTexture2 = look.time[1] * full;
+		float lifetimeTexture3 = look.time[2] * full;
+		float lifetimeTexture4 = look.time[3] * full;
+
+		//compute our color
+		if(remainLifetime >= lifetimeTexture2 + blending){
+			color = color1;
+		}
+
+		else if(remainLifetime  < lifetimeTexture2 + blending && remainLifetime > lifetimeTexture2){
+			float interpolationTime = remainLifetime - lifetimeTexture2;
+			float cp = min(interpolationTime/blending, 1);
+			color = color1 * cp + color2 * (1.0 - cp);
+		}
+
+		else if (remainLifetime <= lifetimeTexture2 && remainLifetime >= lifetimeTexture3 + blending){
+			color = color2;
+		}
+
+		else if(remainLifetime < lifetimeTexture3 + blending && remainLifetime > lifetimeTexture3){
+			float interpolationTime = remainLifetime - lifetimeTexture3;
+			float cp = min(interpolationTime/blending, 1);
+			color = color2 * cp + color3 * (1.0 - cp);
+		}
+
+		else if (remainLifetime <= lifetimeTexture3 && remainLifetime >= lifetimeTexture4 + blending){
+			color = color3;
+		}
+
+		else if(remainLifetime  < lifetimeTexture4 + blending && remainLifetime  > lifetimeTexture4){
+			float interpolationTime = remainLifetime - lifetimeTexture4;
+			float cp = min(interpolationTime/blending, 1);
+			color = color3 * cp + color4 * (1.0 - cp);
+		}
+
+		else{
+			color = color4;
+		}
+	}
+
+	//fade in
+	float birth = look.lifetime.y;
+	float death = look.lifetime.z;
+	if(passedLifetime <= birth && passedLifetime > 0){
+		color.w *= min(passedLifetime / birth, 1);
+	}
+	// fade out
+	else if (remainLifetime <= death && look.flags.x == 1){
+		color.w *= min(remainLifetime / death, 1);
+	}
+
+	return color;
+}
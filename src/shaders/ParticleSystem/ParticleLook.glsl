@@ -0,0 +1,88 @@
+//The look of an emitter (size, lifetime, scaling, textures), shared by the render shaders of Emitter & ParticleBatch.
+//Without PARTICLE_BATCH it comes from the uniforms of the Emitter, with PARTICLE_BATCH from the entry of the emitter in look_ssbo.
+//The shaders only read it through getLook, emitter is the index in look_ssbo (0 without PARTICLE_BATCH).
+
+//the same layout as BatchEmitterLook in ParticleBatch.h
+struct EmitterLook
+{
+	vec4 lifetime; //fullLifetime, birthTime, deathTime, blendingTime
+	vec4 time; //blending moments of the textures
+	vec4 size; //size, rotationSpeed
+	ivec4 flags; //particleMortal, useTexture, textureCount, useScaling
+	ivec4 flags2; //scalingCount, rotateLeft
+	vec4 scalingData[8]; //first moment, then size
+};
+
+#ifdef PARTICLE_BATCH
+
+layout(std430, binding=5) buffer look_ssbo
+{
+	EmitterLook looks[];
+};
+
+EmitterLook getLook(int emitter){
+	return looks[emitter];
+}
+
+#else
+
+uniform float fullLifetime;
+uniform int particleMortal;
+
+uniform float birthTime;
+uniform float deathTime;
+uniform float blendingTime;
+uniform float time[4];
+
+uniform int textureCount;
+uniform int useTexture;
+
+//our scaling Data
+uniform int useScaling;
+uniform int scalingCount;
+uniform float scalingData[32]; //first moment, then size
+uniform float size;
+
+//our rotation data
+uniform int rotateLeft;
+uniform float rotationSpeed;
+
+EmitterLook getLook(int emitter){
+	EmitterLook look;
+	look.lifetime = vec4(fullLifetime, birthTime, deathTime, blendingTime);
+	look.time = vec4(time[0], time[1], time[2], time[3]);
+	look.size = vec4(size, rotationSpeed, 0.0, 0.0);
+	look.flags = ivec4(particleMortal, useTexture, textureCount, useScaling);
+	look.flags2 = ivec4(scalingCount, rotateLeft, 0, 0);
+	for (int i = 0; i < 8; i++)
+		look.scalingData[i] = vec4(scalingData[i * 4], scalingData[i * 4 + 1], scalingData[i * 4 + 2], scalingData[i * 4 + 3]);
+	return look;
+}
+
+#endif
+
+//scalingData[i] of the look
+float getScalingData(EmitterLook look, int i){
+	i = min(i, 31);
+	return look.scalingData[i / 4][i % 4];
+}
+
+//the size of a particle with remainLifetime left, interpolated between the scaling moments
+float getScalingSize(EmitterLook look, float remainLifetime){
+	if(look.flags.w == 0)
+		return look.size.x;
+
+	//fullLifetime, particleMortal & scalingCount
+	float percentageLifetime = 1 - remainLifetime/look.lifetime.x;
+	bool mortal = look.flags.x == 1;
+	int count = look.flags2.x;
+
+	int upperBorder=0;
+	do{
+		upperBorder=upperBorder+2;
+	}
+	while( getScalingData(look, upperBorder) < percentageLifetime && ((upperBorder <= count && mortal) || (upperBorder < count && !mortal)));
+	int lowerBorder = upperBorder-2;
+	float pUpper = max(min((percentageLifetime - getScalingData(look, lowerBorder)) / (getScalingData(look, upperBorder) - getScalingData(look, lowerBorder)), 1.0),0.0);
+	return (1-pUpper) * getScalingData(look, lowerBorder+1) + pUpper * getScalingData(look, upperBorder+1);
+}
@@ -0,0 +1,51 @@
+//Counter based random numbers (Philox4x32-10), the same functions as ParticleRandom.h.
+//A number only depends on (emitter seed, particle index, frame, stream), every particle draws its own numbers.
+//Streams of a spawned particle: 0 xyz direction & x of the area emitting, 1 y & z of the area emitting
+
+uvec4 philox(uvec4 counter, uvec2 key){
+	for (int i = 0; i < 10; i++){
+		uint hi0, lo0, hi1, lo1;
+		umulExtended(0xD2511F53u, counter.x, hi0, lo0);
+		umulExtended(0xCD9E8D57u, counter.z, hi1, lo1);
+		counter = uvec4(hi1 ^ counter.y ^ key.x, lo1, hi0 ^ counter.w ^ key.y, lo0);
+		key += uvec2(0x9E3779B9u, 0xBB67AE85u);
+	}
+	return counter;
+}
+
+//4 numbers 0 .. 1 (24 bit) of a particle
+vec4 randomUniform(uint seed, uint index, uint frame, uint stream){
+	uvec4 bits = philox(uvec4(index, frame, stream, 0u), uvec2(seed, 0x8F1BBCDCu));
+	return vec4(bits >> 8u) * (1.0 / 16777216.0);
+}
+
+//-1 .. 1 with a certain comma accuracy, like the area emitting of the Emitter
+float randomArea(float u, int accuracy){
+	if (accuracy <= 0)
+		return 0.0;
+	float steps = float(2 * accuracy + 1);
+	float step = min(floor(u * steps), steps - 1.0);
+	return (step - float(accuracy)) / float(accuracy);
+}
+
+//the same vector spaces as Emitter::setVelocity
+vec3 randomDirection(vec3 u, int velocityType){
+	vec3 direction = vec3(0.0);
+
+	if(velocityType == 1)
+		direction = vec3(u.x - 1.0, u.y, 0.0); //LeftQuarterCircle
+	else if(velocityType == 2)
+		direction = vec3(u.x, u.y, 0.0); //RightQuarterCircle
+	else if(velocityType == 3)
+		direction = vec3(2.0 * u.x - 1.0, u.y, 0.0); //SemiCircle
+	else if(velocityType == 4)
+		direction = vec3(2.0 * u.x - 1.0, 2.0 * u.y - 1.0, 0.0); //Circle
+	else if(velocityType == 5)
+		direction = vec3(2.0 * u.x - 1.0, u.y, 2.0 * u.z - 1.0); //SemiSphere
+	else if(velocityType == 6)
+		direction = vec3(2.0 * u.x - 1.0, 2.0 * u.y - 1.0, 2.0 * u.z - 1.0); //Sphere
+
+	if(length(direction) != 0.0)
+		direction = normalize(direction);
+	return direction;
+}
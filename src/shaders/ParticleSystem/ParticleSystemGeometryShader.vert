@@ -1,6 +1,11 @@
 #version 430 core
 
-layout (location = 0) in vec4 position;	
+layout (location = 0) in vec4 position;
+#ifdef PARTICLE_BATCH
+//the emitter of the draw, see ParticleSystemPointSprites.vert
+layout (location = 1) in int emitter;
+flat out int emitterparticle;
+#endif
 
 uniform mat4 viewMatrix;
 uniform mat4 projectionMatrix;
@@ -9,5 +14,8 @@ out float lifetimeparticle;
 
 void main(){
 	lifetimeparticle = position.w;
-    gl_Position = position;
-}
\ No newline at end of file
+#ifdef PARTICLE_BATCH
+	emitterparticle = emitter;
+#endif
+	gl_Position = position;
+}
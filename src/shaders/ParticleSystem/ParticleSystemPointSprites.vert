@@ -1,50 +1,39 @@
 #version 430 core
 
-layout (location = 0) in vec4 position;	
+//with PARTICLE_BATCH for all emitters of a ParticleBatch, the look of the emitter comes from look_ssbo
+
+layout (location = 0) in vec4 position;
+#ifdef PARTICLE_BATCH
+//the emitter of the draw, an instanced attribute that starts at the baseInstance of the draw command
+layout (location = 1) in int emitter;
+flat out int emitterIndex;
+#else
+const int emitter = 0;
+#endif
 
 //our matrixes
 uniform mat4 viewMatrix;
 uniform mat4 projectionMatrix;
 
-//our scaling Data
-uniform int useScaling;
-uniform int scalingCount;
-uniform float scalingData[32]; //first moment, then size
-uniform float size;
-uniform float fullLifetime;
-uniform int particleMortal;
+#include "ParticleLook.glsl"
 
 out float lifetime;
 
 void main(){
-	//our needed var
-	int direction;
-	float scalingSize;
-
 	//world space particles
 	vec4 pos = projectionMatrix * viewMatrix * vec4(position.xyz, 1.0);
-	
+
 	//scaling
 	float remainLifetime = position.w;
-	if(useScaling == 1){
-		float percentageLifetime = 1 - remainLifetime/fullLifetime;
-		int upperBorder=0;
-		do{
-			upperBorder=upperBorder+2;
-		}
-		while( scalingData[upperBorder] < percentageLifetime && ((upperBorder <= scalingCount && particleMortal == 1) || (upperBorder < scalingCount && particleMortal == 0)));
-		int lowerBorder = upperBorder-2;
-		float pUpper = max(min((percentageLifetime - scalingData[lowerBorder]) / (scalingData[upperBorder] - scalingData[lowerBorder]), 1.0),0.0); 
-		scalingSize = (1-pUpper) * scalingData[lowerBorder+1] + pUpper * scalingData[upperBorder+1];
-	}
-	else{
-		scalingSize = size;
-	}
+	float scalingSize = getScalingSize(getLook(emitter), remainLifetime);
 
 	//Point Size
 	gl_PointSize = (1.0 - pos.z / pos.w) * (2500.0 * scalingSize);
 
 	//Output
 	lifetime = remainLifetime;
+#ifdef PARTICLE_BATCH
+	emitterIndex = emitter;
+#endif
 	gl_Position = pos;
-}
\ No newline at end of file
+}
@@ -7,7 +7,11 @@ uniform sampler2D normalTexture;
 uniform sampler2D colorTexture;
 uniform sampler2D depthBuffer;
 
+#ifdef UNIFORM_BLOCKS
+#include "../UniformBlocks.glsl"
+#else
 uniform mat4 projectionMatrix;
+#endif
 
 uniform int screenWidth;
 uniform int screenHeight;
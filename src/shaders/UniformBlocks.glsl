@@ -0,0 +1,49 @@
+//std140 uniform blocks shared by the shaders of the Renderer, the same layout as GeKo_Graphics/Shader/UniformBuffer.h.
+//ShaderProgram binds them by name after linking: FrameBlock 0, MaterialBlock 1, ObjectBlock 2
+
+struct LightData
+{
+	vec4 pos;    //pos.w = 0 dir. light, pos.w = 1 point light
+	vec3 col;
+	float spot_exponent;
+	vec3 spot_direction;
+	float spot_cutoff;
+};
+
+//once per frame: camera, time & shadow light
+layout(std140) uniform FrameBlock
+{
+	mat4 viewMatrix;
+	mat4 projectionMatrix;
+	mat4 viewProjectionMatrix;
+	mat4 lightVPBias;
+	vec4 cameraPosition;
+	LightData light;
+	vec3 lightAmbient;
+	float time;
+	int useShadowMap;
+	int shadowMode;
+};
+
+//once per material
+layout(std140) uniform MaterialBlock
+{
+	vec3 diffuse;
+	float shininess;
+	vec3 specular;
+	float alpha;
+} mat;
+
+//once per object, a range of the ring buffer
+layout(std140) uniform ObjectBlock
+{
+	mat4 modelMatrix;
+	mat4 previousModelMatrix;
+	int useTexture;
+	int useNormalMap;
+	int useHeightMap;
+	int useHeightMapShadows;
+	float parallaxScale;
+	float parallaxBias;
+	int useInstancing;	//the model matrix is the instanceMatrix attribute (location 4), see RenderQueue
+};
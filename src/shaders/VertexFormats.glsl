@@ -0,0 +1,13 @@
+//decoding of the packed vertex formats of GeKo_Graphics/Geometry/VertexLayout.h, the other formats are converted by OpenGL
+
+//VERTEX_NORMAL_OCTAHEDRAL_INT16: the normal (or tangent) input has to be a vec2
+//layout (location = 1) in vec2 octahedralNormal;
+//vec3 normal = decodeOctahedral(octahedralNormal);
+vec3 decodeOctahedral(vec2 packed)
+{
+	vec3 normal = vec3(packed, 1.0 - abs(packed.x) - abs(packed.y));
+	float t = max(-normal.z, 0.0);
+	normal.x += (normal.x >= 0.0) ? -t : t;
+	normal.y += (normal.y >= 0.0) ? -t : t;
+	return normalize(normal);
+}